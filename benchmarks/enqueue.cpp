@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/range.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/kernel_functor.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+/// Number of heap allocations made through `operator new`
+std::atomic<size_t> n_allocs = 0;
+
+/// Number of commands enqueued per iteration
+const int N_COMMANDS = 256;
+
+// clang-format off
+std::string src = R"(
+__kernel void
+scale(const float a, __global float *X)
+{
+    int i = get_global_id(0);
+    X[i] = a * X[i];
+}
+)";
+// clang-format on
+
+using FloatBuffer = ocl::Buffer<float>;
+
+/// Queue selected by the first benchmark argument: in-order (0) or out-of-order (1). Out-of-order
+/// queues merge the wait lists with tracked dependencies on every enqueue.
+ocl::Queue
+make_queue(const benchmark::State & state)
+{
+    if (state.range(0) == 0)
+        return ocl::Queue::get_default();
+    return ocl::Queue(ocl::Context::get_default(), ocl::OUT_OF_ORDER_EXEC_MODE_ENABLE);
+}
+
+/// Enqueue a chain of commands, each depending on the previous one, and report the number of
+/// heap allocations per enqueue. Allocations made by the OpenCL implementation through
+/// `operator new` are counted as well, so compare against `BM_enqueue_raw`.
+///
+/// @param state Benchmark state
+/// @param q Queue the commands go into
+/// @param enqueue Callable taking the event of the previous command and returning the event of
+///        the enqueued one
+template <typename F>
+void
+enqueue_chain(benchmark::State & state, const ocl::Queue & q, F && enqueue)
+{
+    size_t allocs = 0;
+    for (auto _ : state) {
+        ocl::Event prev;
+        auto start = n_allocs.load();
+        for (int i = 0; i < N_COMMANDS; i++)
+            prev = enqueue(prev);
+        allocs += n_allocs.load() - start;
+        q.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * N_COMMANDS);
+    state.counters["allocs_per_enqueue"] =
+        benchmark::Counter(allocs, benchmark::Counter::kAvgIterations) / N_COMMANDS;
+}
+
+} // namespace
+
+void *
+operator new(std::size_t size)
+{
+    n_allocs++;
+    if (auto * ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+/// Plain OpenCL calls, the baseline for allocations made by the OpenCL implementation
+static void
+BM_enqueue_raw(benchmark::State & state)
+{
+    ocl::Range<1> rng { 1024 };
+    FloatBuffer d_a { rng };
+    auto q = make_queue(state);
+    float pattern = 1.f;
+    enqueue_chain(state, q, [&](const ocl::Event & prev) {
+        cl_event p = prev;
+        cl_event evt;
+        clEnqueueFillBuffer(q,
+                            d_a,
+                            &pattern,
+                            sizeof(float),
+                            0,
+                            d_a.byte_size(),
+                            p == nullptr ? 0 : 1,
+                            p == nullptr ? nullptr : &p,
+                            &evt);
+        return ocl::Event(evt);
+    });
+}
+
+static void
+BM_enqueue_fill(benchmark::State & state)
+{
+    ocl::Range<1> rng { 1024 };
+    FloatBuffer d_a { rng };
+    auto q = make_queue(state);
+    enqueue_chain(state, q, [&](const ocl::Event & prev) { return q.fill(d_a, 1.f, rng, prev); });
+}
+
+static void
+BM_enqueue_copy(benchmark::State & state)
+{
+    ocl::Range<1> rng { 1024 };
+    FloatBuffer d_a { rng };
+    FloatBuffer d_b { rng };
+    auto q = make_queue(state);
+    enqueue_chain(state, q, [&](const ocl::Event & prev) { return q.copy(d_a, d_b, rng, prev); });
+}
+
+static void
+BM_enqueue_kernel(benchmark::State & state)
+{
+    ocl::Range<1> rng { 1024 };
+    FloatBuffer d_a { rng };
+    auto q = make_queue(state);
+    auto ctx = ocl::Context::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+    ocl::KernelFunctor<float, FloatBuffer> scale =
+        ocl::Kernel::create<float, FloatBuffer>(prg, "scale");
+    enqueue_chain(state, q, [&](const ocl::Event & prev) {
+        ocl::Event evt;
+        q.submit([&](ocl::Handler & h) { evt = h.kernel(scale(1.f, d_a), rng, prev); });
+        return evt;
+    });
+}
+
+BENCHMARK(BM_enqueue_raw)->ArgName("out_of_order")->Arg(0)->Arg(1);
+BENCHMARK(BM_enqueue_fill)->ArgName("out_of_order")->Arg(0)->Arg(1);
+BENCHMARK(BM_enqueue_copy)->ArgName("out_of_order")->Arg(0)->Arg(1);
+BENCHMARK(BM_enqueue_kernel)->ArgName("out_of_order")->Arg(0)->Arg(1);
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/kernel_functor.h"
+#include "openclcpp-lite/pipeline.h"
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+// clang-format off
+std::string src = R"(
+__kernel void
+saxpy(const float a, __global const float *X, __global float *Y)
+{
+    int i = get_global_id(0);
+    Y[i] = a * X[i] + 1.f;
+}
+)";
+// clang-format on
+
+using FloatBuffer = ocl::Buffer<float>;
+
+/// Total number of elements streamed per iteration
+const size_t N = 1 << 24;
+
+ocl::KernelFunctor<float, FloatBuffer, FloatBuffer>
+saxpy_kernel()
+{
+    auto ctx = ocl::Context::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+    return ocl::Kernel::create<float, FloatBuffer, FloatBuffer>(prg, "saxpy");
+}
+
+} // namespace
+
+/// Upload, compute and download chunk by chunk through the default queue
+static void
+BM_serial(benchmark::State & state)
+{
+    size_t chunk = state.range(0);
+    std::vector<float> h_in(N, 1.f);
+    std::vector<float> h_out(N);
+    auto q = ocl::Queue::get_default();
+    auto saxpy = saxpy_kernel();
+    ocl::Range<1> rng { chunk };
+    FloatBuffer d_in { rng };
+    FloatBuffer d_out { rng };
+
+    for (auto _ : state) {
+        for (size_t ofs = 0; ofs < N; ofs += chunk) {
+            q.copy(h_in.data() + ofs, d_in, rng);
+            q.submit([&](auto & h) { h.kernel(saxpy(2.f, d_in, d_out), rng); });
+            q.copy(d_out, h_out.data() + ofs, rng);
+        }
+        q.wait();
+    }
+    state.SetBytesProcessed(state.iterations() * N * 2 * sizeof(float));
+}
+
+/// Stream the same data through a pipeline
+static void
+BM_pipeline(benchmark::State & state)
+{
+    size_t chunk = state.range(0);
+    unsigned int depth = state.range(1);
+    std::vector<float> h_in(N, 1.f);
+    std::vector<float> h_out(N);
+    auto saxpy = saxpy_kernel();
+    ocl::Pipeline<float> pipe(chunk, depth);
+
+    for (auto _ : state) {
+        pipe.run(h_in.data(), h_out.data(), N, [&](auto & in, auto & out, size_t) {
+            return saxpy(2.f, in, out);
+        });
+    }
+    state.SetBytesProcessed(state.iterations() * N * 2 * sizeof(float));
+}
+
+BENCHMARK(BM_serial)->Arg(1 << 18)->Arg(1 << 20)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_pipeline)
+    ->ArgsProduct({ { 1 << 18, 1 << 20, 1 << 22 }, { 2, 3, 4 } })
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/range.h"
+#include "openclcpp-lite/buffer.h"
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+/// Number of commands every thread enqueues per iteration
+const int N_COMMANDS = 256;
+
+/// Enqueue small fills into the default queue and wait for them
+void
+enqueue_fills(benchmark::State & state, ocl::DefaultQueuePolicy policy)
+{
+    ocl::Queue::set_default_policy(policy);
+    ocl::Range<1> rng { 1024 };
+    ocl::Buffer<float> d_a { rng };
+
+    for (auto _ : state) {
+        auto q = ocl::Queue::get_default();
+        for (int i = 0; i < N_COMMANDS; i++)
+            q.fill(d_a, (float) i, rng);
+        q.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * N_COMMANDS);
+}
+
+} // namespace
+
+static void
+BM_default_queue_shared(benchmark::State & state)
+{
+    enqueue_fills(state, ocl::SHARED);
+}
+
+static void
+BM_default_queue_per_thread(benchmark::State & state)
+{
+    enqueue_fills(state, ocl::PER_THREAD);
+}
+
+BENCHMARK(BM_default_queue_shared)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_default_queue_per_thread)->ThreadRange(1, 16)->UseRealTime();
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "benchmark/benchmark.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/range.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/staging_pool.h"
+#include <cstring>
+#include <vector>
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+/// Write and read back a buffer through `Queue::copy`
+///
+/// @param state Benchmark state, `state.range(0)` is the transfer size in bytes
+/// @param staged Stage the transfers through a staging pool
+void
+copy_round_trip(benchmark::State & state, bool staged)
+{
+    ocl::Range<1> rng { (size_t) state.range(0) };
+    std::vector<char> h_a(rng.size(), 1);
+    ocl::Buffer<char> d_a { rng };
+    auto q = ocl::Queue::get_default();
+    if (staged)
+        q.set_staging_pool(std::make_shared<ocl::StagingPool>(q, 0));
+
+    for (auto _ : state) {
+        q.copy(h_a.data(), d_a, rng);
+        q.copy(d_a, h_a.data(), rng).wait();
+    }
+    state.SetBytesProcessed(state.iterations() * 2 * state.range(0));
+}
+
+} // namespace
+
+/// Transfers from and to pageable host memory
+static void
+BM_transfer_pageable(benchmark::State & state)
+{
+    copy_round_trip(state, false);
+}
+
+/// Transfers staged through pinned memory, including the copy between pageable and pinned memory
+static void
+BM_transfer_staged(benchmark::State & state)
+{
+    copy_round_trip(state, true);
+}
+
+/// Transfers from and to pinned memory
+static void
+BM_transfer_pinned(benchmark::State & state)
+{
+    ocl::Range<1> rng { (size_t) state.range(0) };
+    ocl::Buffer<char> d_a { rng };
+    auto q = ocl::Queue::get_default();
+    ocl::StagingPool pool(q);
+    auto stage = pool.acquire(rng.size());
+
+    for (auto _ : state) {
+        q.copy(stage.data(), d_a, rng);
+        q.copy(d_a, stage.data(), rng).wait();
+    }
+    state.SetBytesProcessed(state.iterations() * 2 * state.range(0));
+}
+
+/// Transfers through mapping the buffer into the host address space
+static void
+BM_transfer_mapped(benchmark::State & state)
+{
+    ocl::Range<1> rng { (size_t) state.range(0) };
+    std::vector<char> h_a(rng.size(), 1);
+    ocl::Buffer<char> d_a { rng, ocl::READ_WRITE | ocl::ALLOC_HOST_PTR };
+    auto q = ocl::Queue::get_default();
+
+    for (auto _ : state) {
+        auto * dst = q.enqueue_map_buffer(d_a, true, ocl::WRITE_INVALIDATE_REGION, rng);
+        std::memcpy(dst, h_a.data(), rng.size());
+        q.enqueue_unmap_mem_object(d_a, dst);
+        auto * src = q.enqueue_map_buffer(d_a, true, ocl::READ, rng);
+        std::memcpy(h_a.data(), src, rng.size());
+        q.enqueue_unmap_mem_object(d_a, src).wait();
+    }
+    state.SetBytesProcessed(state.iterations() * 2 * state.range(0));
+}
+
+BENCHMARK(BM_transfer_pageable)->RangeMultiplier(4)->Range(64 << 10, 64 << 20)->UseRealTime();
+BENCHMARK(BM_transfer_staged)->RangeMultiplier(4)->Range(64 << 10, 64 << 20)->UseRealTime();
+BENCHMARK(BM_transfer_pinned)->RangeMultiplier(4)->Range(64 << 10, 64 << 20)->UseRealTime();
+BENCHMARK(BM_transfer_mapped)->RangeMultiplier(4)->Range(64 << 10, 64 << 20)->UseRealTime();
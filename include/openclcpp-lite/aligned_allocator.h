@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/context.h"
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace openclcpp_lite {
+
+/// Allocator of host memory aligned for use as storage of OpenCL buffers
+///
+/// Memory is aligned to the base address alignment of the devices (see `Context::alignment`) and
+/// allocations are padded to a multiple of the alignment, so the memory can back a `USE_HOST_PTR`
+/// buffer without the OpenCL implementation falling back to a copy.
+///
+/// @tparam T C++ type of the allocated elements
+template <typename T>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    /// Create an allocator aligned for the devices of the default context
+    AlignedAllocator() : alignment_(std::max(default_alignment(), alignof(T))) {}
+
+    /// Create an allocator aligned for the devices of a context
+    ///
+    /// @param context OpenCL context
+    explicit AlignedAllocator(const Context & context) :
+        alignment_(std::max(context.alignment(), alignof(T)))
+    {
+    }
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U> & other) :
+        alignment_(std::max(other.alignment(), alignof(T)))
+    {
+    }
+
+    T *
+    allocate(std::size_t n)
+    {
+        auto size = (n * sizeof(T) + this->alignment_ - 1) / this->alignment_ * this->alignment_;
+        return static_cast<T *>(::operator new(size, std::align_val_t(this->alignment_)));
+    }
+
+    void
+    deallocate(T * ptr, std::size_t)
+    {
+        ::operator delete(ptr, std::align_val_t(this->alignment_));
+    }
+
+    /// Alignment of the allocations in bytes
+    std::size_t
+    alignment() const
+    {
+        return this->alignment_;
+    }
+
+    template <typename U>
+    bool
+    operator==(const AlignedAllocator<U> & other) const
+    {
+        return this->alignment_ == other.alignment();
+    }
+
+private:
+    /// Alignment for the devices of the default context, queried only once
+    static std::size_t
+    default_alignment()
+    {
+        static const std::size_t align = Context::get_default().alignment();
+        return align;
+    }
+
+    /// Alignment in bytes
+    std::size_t alignment_;
+};
+
+/// Vector of host memory aligned for use as storage of OpenCL buffers
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+} // namespace openclcpp_lite
@@ -7,15 +7,31 @@
 #include "openclcpp-lite/templ.h"
 #include "openclcpp-lite/flags.h"
 #include "openclcpp-lite/enums.h"
+#include "openclcpp-lite/mapped_view.h"
+#include "openclcpp-lite/memory_accounting.h"
 #include "openclcpp-lite/memory.h"
+#include "openclcpp-lite/memory_pool.h"
 #include "openclcpp-lite/range.h"
 #include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/kernel.h"
 #include "openclcpp-lite/queue.h"
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <numeric>
+#include <source_location>
+#include <span>
+#include <utility>
 
 namespace openclcpp_lite {
 
 /// `D`-dimensional buffer
 ///
+/// Buffers remember their extents (`range`) and the distance between the starts of their rows
+/// (`row_pitch`). Buffers are tightly packed unless created as a `PitchedBuffer`. `Queue` copies
+/// of whole padded buffers become rectangular copies that skip the padding.
+///
 /// @tparam T C++ type of the data element this buffer stores
 template <typename T, int D = 1>
 class Buffer : public Memory {
@@ -25,18 +41,22 @@ public:
     /// Create a buffer from external memory buffer
     ///
     /// @param mem External memory buffer
-    Buffer(cl_mem mem) : Memory(mem) {}
+    /// @param retain Increment the reference count of `mem`. By default, the buffer takes over the
+    ///        reference held by the caller.
+    ///
+    /// The shape of `mem` is unknown, so the buffer has an empty `range`.
+    explicit Buffer(cl_mem mem, bool retain = false) : Memory(mem, retain), pitch_(0) {}
 
     /// Create an uninitialized buffer in a default Context
     ///
     /// @param range Size of the buffer
     /// @param mem_flags Memory flags
-    Buffer(const Range<D> & range, MemoryFlags mem_flags = READ_WRITE)
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Buffer(const Range<D> & range,
+           MemoryFlags mem_flags = READ_WRITE,
+           std::source_location loc = std::source_location::current()) :
+        Buffer(Context::get_default(), range, mem_flags, loc)
     {
-        auto ctx = Context::get_default();
-        cl_int err;
-        this->mem_ = clCreateBuffer(ctx, mem_flags, sizeof(T) * range.size(), nullptr, &err);
-        OPENCL_CHECK(err);
     }
 
     /// Create an uninitialized buffer in a context
@@ -44,50 +64,302 @@ public:
     /// @param context OpenCL context
     /// @param range Size of the buffer
     /// @param mem_flags Memory flags
-    Buffer(const Context & context, const Range<D> & range, MemoryFlags mem_flags = READ_WRITE)
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Buffer(const Context & context,
+           const Range<D> & range,
+           MemoryFlags mem_flags = READ_WRITE,
+           std::source_location loc = std::source_location::current()) :
+        Buffer(context, range, range.size(0), mem_flags, loc)
+    {
+    }
+
+    /// Create an uninitialized buffer from a memory pool
+    ///
+    /// The buffer is a sub-buffer of a slab reserved by the pool. Its memory flags are the flags
+    /// of the pool, and its memory goes back into the pool when the buffer is released.
+    ///
+    /// @param pool Memory pool
+    /// @param range Size of the buffer
+    Buffer(MemoryPool & pool, const Range<D> & range) :
+        Memory(pool.allocate(sizeof(T) * range.size())),
+        range_(range),
+        pitch_(range.size(0))
     {
-        cl_int err;
-        this->mem_ = clCreateBuffer(context, mem_flags, sizeof(T) * range.size(), nullptr, &err);
-        OPENCL_CHECK(err);
     }
 
     /// Create a buffer in the default Context and initialize it from host memory
     ///
+    /// The values are copied by the OpenCL implementation when the buffer is created
+    /// (`COPY_HOST_PTR`), so `src` can be released as soon as the constructor returns.
+    ///
     /// @param src Host memory with the initial values
     /// @param range Size of the buffer
     /// @param mem_flags Memory flags
-    Buffer(const T * src, const Range<D> & range, MemoryFlags mem_flags = READ_WRITE)
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Buffer(const T * src,
+           const Range<D> & range,
+           MemoryFlags mem_flags = READ_WRITE,
+           std::source_location loc = std::source_location::current()) :
+        Buffer(Context::get_default(), src, range, mem_flags, loc)
     {
-        auto ctx = Context::get_default();
-        cl_int err;
-        this->mem_ = clCreateBuffer(ctx, mem_flags, sizeof(T) * range.size(), nullptr, &err);
-        OPENCL_CHECK(err);
-        auto q = Queue::get_default();
-        auto * dst = q.enqueue_map_buffer<T, D>(*this, true, WRITE, range);
-        memcpy(dst, src, byte_size());
-        auto evt = q.enqueue_unmap_mem_object(*this, dst);
-        evt.wait();
     }
 
     /// Create a buffer in a Context and initialize it from host memory
     ///
+    /// The values are copied by the OpenCL implementation when the buffer is created
+    /// (`COPY_HOST_PTR`), so `src` can be released as soon as the constructor returns.
+    ///
     /// @param context OpenCL context
     /// @param src Host memory with the initial values
     /// @param range Size of the buffer
     /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
     Buffer(const Context & context,
            const T * src,
            const Range<D> & range,
-           MemoryFlags mem_flags = READ_WRITE)
+           MemoryFlags mem_flags = READ_WRITE,
+           std::source_location loc = std::source_location::current()) :
+        range_(range),
+        pitch_(range.size(0))
+    {
+        cl_int err;
+        this->mem_ = clCreateBuffer(context,
+                                    MemoryFlags(mem_flags | COPY_HOST_PTR),
+                                    sizeof(T) * range.size(),
+                                    const_cast<T *>(src),
+                                    &err);
+        OPENCL_CHECK(err);
+        MemoryAccounting::track(this->mem_, context, sizeof(T) * range.size(), loc);
+    }
+
+    /// Create a buffer on host memory in the default Context
+    ///
+    /// See the constructor taking a context.
+    ///
+    /// @param host Host memory
+    /// @param owner Object to keep alive for as long as the buffer uses `host`
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Buffer(std::span<T> host,
+           std::shared_ptr<void> owner = nullptr,
+           MemoryFlags mem_flags = READ_WRITE,
+           std::source_location loc = std::source_location::current()) :
+        Buffer(Context::get_default(), host, std::move(owner), mem_flags, loc)
     {
+    }
+
+    /// Create a buffer on host memory in a Context
+    ///
+    /// If all devices in the context share memory with the host (or `USE_HOST_PTR` is passed in
+    /// `mem_flags`), the buffer uses `host` as its storage and kernels work on the host memory
+    /// without any transfer. `owner` is then kept alive until the buffer is destroyed. Otherwise,
+    /// the buffer is a device copy of `host`.
+    ///
+    /// Either way, use `Queue::copy` between the buffer and `host` to synchronize them. For a
+    /// buffer that uses `host` as its storage, these copies only map and unmap the buffer.
+    /// Zero-copy needs host memory aligned to `Context::alignment`, e.g. from an
+    /// `AlignedAllocator`.
+    ///
+    /// The shape of `host` is known only for `D == 1`, buffers with more dimensions have an empty
+    /// `range` and are copied as tightly packed memory.
+    ///
+    /// @param context OpenCL context
+    /// @param host Host memory
+    /// @param owner Object to keep alive for as long as the buffer uses `host`
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Buffer(const Context & context,
+           std::span<T> host,
+           std::shared_ptr<void> owner = nullptr,
+           MemoryFlags mem_flags = READ_WRITE,
+           std::source_location loc = std::source_location::current()) :
+        pitch_(D == 1 ? host.size() : 0)
+    {
+        if constexpr (D == 1)
+            this->range_ = Range<D> { host.size() };
+        bool zero_copy = (mem_flags & USE_HOST_PTR) || context.host_unified_memory();
+        auto flags = mem_flags | (zero_copy ? USE_HOST_PTR : COPY_HOST_PTR);
         cl_int err;
-        this->mem_ = clCreateBuffer(context, mem_flags, sizeof(T) * range.size(), nullptr, &err);
+        this->mem_ = clCreateBuffer(context,
+                                    MemoryFlags(flags),
+                                    host.size_bytes(),
+                                    host.data(),
+                                    &err);
         OPENCL_CHECK(err);
-        auto q = Queue::get_default();
-        auto * dst = q.enqueue_map_buffer<T, D>(*this, true, WRITE, range);
-        memcpy(dst, src, byte_size());
-        auto evt = q.enqueue_unmap_mem_object(*this, dst);
-        evt.wait();
+        MemoryAccounting::track(this->mem_, context, host.size_bytes(), loc);
+        if (zero_copy) {
+            this->host_ = host.data();
+            keep_alive(std::move(owner));
+        }
+    }
+
+    /// Create a buffer in the context of a queue and upload its initial values through the queue
+    ///
+    /// Does not wait for the upload. The values are written with a non-blocking write, so `src`
+    /// must stay valid until the returned event completes (unless the queue stages transfers of
+    /// this size through a `StagingPool`).
+    ///
+    /// @param queue Queue used for the upload
+    /// @param src Host memory with the initial values
+    /// @param range Size of the buffer
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    /// @return The buffer and the event that completes when the buffer holds the initial values
+    static std::pair<Buffer, Event>
+    from_host(const Queue & queue,
+              const T * src,
+              const Range<D> & range,
+              MemoryFlags mem_flags = READ_WRITE,
+              std::source_location loc = std::source_location::current())
+    {
+        Buffer buffer(queue.context(), range, mem_flags, loc);
+        auto upload = queue.copy(src, buffer, range);
+        return { std::move(buffer), std::move(upload) };
+    }
+
+    /// Extents of the buffer in elements, empty if the shape is unknown
+    const Range<D> &
+    range() const
+    {
+        return this->range_;
+    }
+
+    /// Distance in bytes between the starts of two consecutive rows
+    size_t
+    row_pitch() const
+    {
+        return this->pitch_ * sizeof(T);
+    }
+
+    /// Distance in bytes between the starts of two consecutive slices, 0 for buffers with less
+    /// than 3 dimensions
+    size_t
+    slice_pitch() const
+    {
+        if constexpr (D > 2)
+            return row_pitch() * this->range_.size(1);
+        else
+            return 0;
+    }
+
+    /// Check if the rows of the buffer are padded
+    bool
+    padded() const
+    {
+        return this->pitch_ > this->range_.size(0);
+    }
+
+protected:
+    /// Create an uninitialized buffer with padded rows
+    ///
+    /// @param context OpenCL context
+    /// @param range Extents of the buffer
+    /// @param pitch Row pitch in elements, at least `range.size(0)`
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Buffer(const Context & context,
+           const Range<D> & range,
+           size_t pitch,
+           MemoryFlags mem_flags,
+           const std::source_location & loc) :
+        range_(range),
+        pitch_(pitch)
+    {
+        assert(pitch >= range.size(0));
+        auto size = sizeof(T) * pitch * (range.size(0) == 0 ? 0 : range.size() / range.size(0));
+        cl_int err;
+        this->mem_ = clCreateBuffer(context, mem_flags, size, nullptr, &err);
+        OPENCL_CHECK(err);
+        MemoryAccounting::track(this->mem_, context, size, loc);
+    }
+
+private:
+    /// Extents in elements
+    Range<D> range_;
+    /// Row pitch in elements
+    size_t pitch_;
+};
+
+/// `D`-dimensional buffer with rows aligned to the global memory cache line
+///
+/// Every row starts on a cache line boundary of all devices in the context, so work-items of a
+/// work-group reading along a row touch as few cache lines as possible. The padding is skipped by
+/// `Queue` copies of the whole buffer, which exchange tightly packed data with the host.
+///
+/// When passed to a kernel through a `KernelFunctor`, the buffer takes `D` kernel arguments: the
+/// buffer followed by the row pitch (and for 3-dimensional buffers the slice pitch) in elements as
+/// `uint`. Element `(x, y, z)` is at `x + y * row_pitch + z * slice_pitch`.
+///
+/// Example:
+/// ```
+/// // __kernel void scale(__global float * a, uint a_pitch, float s)
+/// PitchedBuffer<float, 2> d_a(ctx, Range<2> { 1000, 1000 });
+/// q.copy(h_a.data(), d_a, d_a.range());
+/// auto scale = Kernel::create<PitchedBuffer<float, 2>, float>(prg, "scale");
+/// q.submit([&](auto & h) { h.kernel(scale(d_a, 2.f), d_a.range()); });
+/// ```
+///
+/// @tparam T C++ type of the data element this buffer stores
+template <typename T, int D>
+class PitchedBuffer : public Buffer<T, D> {
+    static_assert(D == 2 || D == 3, "Pitched buffers have 2 or 3 dimensions");
+
+public:
+    /// Number of kernel arguments the buffer is passed as
+    static constexpr cl_uint NUM_KERNEL_ARGS = D;
+
+    /// Create an uninitialized buffer in a default Context
+    ///
+    /// @param range Extents of the buffer
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    explicit PitchedBuffer(const Range<D> & range,
+                           MemoryFlags mem_flags = READ_WRITE,
+                           std::source_location loc = std::source_location::current()) :
+        PitchedBuffer(Context::get_default(), range, mem_flags, loc)
+    {
+    }
+
+    /// Create an uninitialized buffer in a context
+    ///
+    /// @param context OpenCL context
+    /// @param range Extents of the buffer
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    PitchedBuffer(const Context & context,
+                  const Range<D> & range,
+                  MemoryFlags mem_flags = READ_WRITE,
+                  std::source_location loc = std::source_location::current()) :
+        Buffer<T, D>(context, range, aligned_pitch(context, range.size(0)), mem_flags, loc)
+    {
+    }
+
+    /// Set the kernel arguments of the buffer
+    ///
+    /// @param kernel Kernel
+    /// @param index Index of the first argument
+    void
+    set_kernel_args(Kernel & kernel, cl_uint index) const
+    {
+        kernel.set_arg(index, static_cast<const Memory &>(*this));
+        kernel.set_arg(index + 1, static_cast<cl_uint>(this->row_pitch() / sizeof(T)));
+        if constexpr (D == 3)
+            kernel.set_arg(index + 2, static_cast<cl_uint>(this->slice_pitch() / sizeof(T)));
+    }
+
+    /// Row pitch in elements of a row of `width` elements aligned to the global memory cache line
+    /// of all devices in a context
+    ///
+    /// @param context OpenCL context
+    /// @param width Number of elements in a row
+    static size_t
+    aligned_pitch(const Context & context, size_t width)
+    {
+        size_t line = 1;
+        for (auto & dev : context.devices())
+            line = std::max<size_t>(line, dev.global_mem_cache_line_size());
+        auto unit = std::lcm(line, sizeof(T)) / sizeof(T);
+        return (width + unit - 1) / unit * unit;
     }
 };
 
@@ -3,8 +3,17 @@
 
 #pragma once
 
-// NOLINTNEXTLINE
-#define CL_TARGET_OPENCL_VERSION 120
+// The OpenCL version can be raised by the build (see OPENCLCPP_LITE_OPENCL_VERSION) to enable
+// features like shared virtual memory.
+#ifndef CL_TARGET_OPENCL_VERSION
+    // NOLINTNEXTLINE
+    #define CL_TARGET_OPENCL_VERSION 120
+#endif
+#if CL_TARGET_OPENCL_VERSION >= 200 && !defined(CL_USE_DEPRECATED_OPENCL_1_2_APIS)
+    // command queues and samplers are created with the 1.2 API
+    // NOLINTNEXTLINE
+    #define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+#endif
 #ifdef __APPLE__
     #include <OpenCL/cl.h>
 #else
@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/event.h"
+#include "openclcpp-lite/memory.h"
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace openclcpp_lite {
+
+class Queue;
+
+/// Recorded sequence of commands
+///
+/// Created by `Queue::record`. Replaying the graph enqueues the recorded commands without going
+/// through `Handler`. Kernel arguments captured while recording (or patched via `set_arg`) are
+/// set again right before each kernel is enqueued, so a kernel re-bound outside the graph, or
+/// recorded more than once, still runs with its recorded arguments. If the device supports
+/// `cl_khr_command_buffer` and the graph contains only device-side commands, the graph is
+/// recorded into a command buffer and replayed with a single enqueue.
+///
+/// Commands are replayed in the order they were recorded. Host memory used by recorded copies must
+/// stay valid for as long as the graph is replayed.
+///
+/// Example:
+/// ```
+/// auto graph = q.record([&](Handler & h) {
+///     h.fill(d_r, 0.f, rng);
+///     h.kernel(step(dt, d_u, d_r), rng);
+///     h.copy(d_r, d_u, rng);
+/// });
+/// for (int i = 0; i < n_steps; i++) {
+///     graph.set_arg(1, 0, dt);
+///     graph.replay();
+/// }
+/// ```
+class CommandGraph {
+public:
+    /// Number of recorded commands
+    std::size_t size() const;
+
+    /// Check if the graph is replayed through a `cl_khr_command_buffer` command buffer
+    ///
+    /// @return `true` if the graph uses a command buffer, `false` otherwise
+    bool native() const;
+
+    /// Patch an argument of a recorded kernel
+    ///
+    /// Patching an argument of a graph that uses a command buffer switches it to replaying the
+    /// commands one by one.
+    ///
+    /// @param command Index of the command in recording order
+    /// @param index The argument index
+    /// @param value Argument
+    template <typename T>
+    void
+    set_arg(std::size_t command, cl_uint index, const T & value)
+    {
+        if constexpr (std::is_base_of_v<Memory, T>)
+            set_arg(command, index, static_cast<const Memory &>(value));
+        else
+            set_arg(command, index, sizeof(T), &value);
+    }
+
+    /// Patch a memory object argument of a recorded kernel
+    ///
+    /// The graph keeps a reference to `mem` for as long as it is bound.
+    ///
+    /// @param command Index of the command in recording order
+    /// @param index The argument index
+    /// @param mem Memory object
+    void set_arg(std::size_t command, cl_uint index, const Memory & mem);
+
+    /// Patch an argument of a recorded kernel
+    ///
+    /// @param command Index of the command in recording order
+    /// @param index The argument index
+    /// @param size Size of the argument value in bytes
+    /// @param value Pointer to the argument value
+    void set_arg(std::size_t command, cl_uint index, size_t size, const void * value);
+
+    /// Enqueue the recorded commands into the queue the graph was recorded on
+    ///
+    /// @param wait_list Specify events that need to complete before the recorded commands can be
+    ///        executed
+    /// @return Event that completes when all recorded commands have completed
+    Event replay(WaitList wait_list = WaitList()) const;
+
+private:
+    struct Data;
+
+    explicit CommandGraph(const Queue & queue);
+
+    /// Start capturing kernel arguments set on this thread
+    void begin();
+
+    /// Stop capturing kernel arguments and prepare the graph for replay
+    void end();
+
+    void add_kernel(cl_kernel kernel,
+                    cl_uint dims,
+                    const size_t * offset,
+                    const size_t * global,
+                    const size_t * local,
+                    WaitList wait_list);
+
+    void add_fill(cl_mem buffer,
+                  const void * pattern,
+                  size_t pattern_size,
+                  size_t offset,
+                  size_t size,
+                  WaitList wait_list);
+
+    void add_copy(cl_mem src,
+                  cl_mem dest,
+                  size_t src_offset,
+                  size_t dest_offset,
+                  size_t size,
+                  WaitList wait_list);
+
+    void add_read(cl_mem buffer,
+                  size_t offset,
+                  size_t size,
+                  void * ptr,
+                  WaitList wait_list);
+
+    void add_write(cl_mem buffer,
+                   size_t offset,
+                   size_t size,
+                   const void * ptr,
+                   WaitList wait_list);
+
+    void add_copy_rect(cl_mem src,
+                       cl_mem dest,
+                       const size_t * src_origin,
+                       const size_t * dest_origin,
+                       const size_t * region,
+                       size_t src_row_pitch,
+                       size_t src_slice_pitch,
+                       size_t dest_row_pitch,
+                       size_t dest_slice_pitch,
+                       WaitList wait_list);
+
+    void add_read_rect(cl_mem buffer,
+                       const size_t * buffer_origin,
+                       const size_t * host_origin,
+                       const size_t * region,
+                       size_t buffer_row_pitch,
+                       size_t buffer_slice_pitch,
+                       size_t host_row_pitch,
+                       size_t host_slice_pitch,
+                       void * ptr,
+                       WaitList wait_list);
+
+    void add_write_rect(cl_mem buffer,
+                        const size_t * buffer_origin,
+                        const size_t * host_origin,
+                        const size_t * region,
+                        size_t buffer_row_pitch,
+                        size_t buffer_slice_pitch,
+                        size_t host_row_pitch,
+                        size_t host_slice_pitch,
+                        const void * ptr,
+                        WaitList wait_list);
+
+    /// Remember a kernel argument if a graph is being recorded on this thread
+    static void capture_arg(cl_kernel kernel, cl_uint index, size_t size, const void * value);
+
+    /// Remember a memory object argument and keep a reference to it if a graph is being recorded
+    /// on this thread
+    static void capture_mem_arg(cl_kernel kernel, cl_uint index, cl_mem mem);
+
+    /// Remember a sampler argument and keep a reference to it if a graph is being recorded on this
+    /// thread
+    static void capture_sampler_arg(cl_kernel kernel, cl_uint index, cl_sampler sampler);
+
+#ifdef CL_VERSION_2_0
+    /// Remember a shared virtual memory pointer argument if a graph is being recorded on this
+    /// thread
+    static void capture_svm_arg(cl_kernel kernel, cl_uint index, const void * ptr);
+#endif
+
+    /// Recorded commands and replay state
+    std::shared_ptr<Data> data_;
+
+    /// Graph being recorded on this thread
+    static thread_local Data * recording_;
+
+    friend class Queue;
+    friend class Handler;
+    friend class Kernel;
+};
+
+} // namespace openclcpp_lite
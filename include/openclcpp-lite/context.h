@@ -11,13 +11,21 @@
 
 namespace openclcpp_lite {
 
+/// OpenCL context
+///
+/// Owns a reference to the underlying OpenCL context. Copies share the context and bump its
+/// reference count, the reference is released when the object is destroyed.
 class Context {
 public:
     /// Create a null context
     Context();
 
     /// Create a context from a OpenCL context
-    explicit Context(cl_context context);
+    ///
+    /// @param context OpenCL context
+    /// @param retain Increment the reference count of `context`. By default, the new object takes
+    ///        over the reference held by the caller.
+    explicit Context(cl_context context, bool retain = false);
 
     /// Create a context on a device
     ///
@@ -29,6 +37,13 @@ public:
     /// @param devices Devices to create the context on
     explicit Context(const std::vector<Device> & devices);
 
+    Context(const Context & other);
+    Context(Context && other) noexcept;
+    ~Context();
+
+    Context & operator=(const Context & other);
+    Context & operator=(Context && other) noexcept;
+
     /// Increment the context reference count.
     void retain() const;
 
@@ -46,6 +61,12 @@ public:
     /// Devices attached to this context
     std::vector<Device> devices() const;
 
+    /// Check if all devices in the context share a unified memory subsystem with the host
+    bool host_unified_memory() const;
+
+    /// Alignment in bytes that satisfies the base address alignment of all devices in the context
+    std::size_t alignment() const;
+
     operator cl_context() const { return this->ctx_; }
 
 private:
@@ -28,6 +28,15 @@ public:
         ALL = CL_DEVICE_TYPE_ALL
     };
 
+#ifdef CL_VERSION_2_0
+    enum SVMCapability {
+        SVM_COARSE_GRAIN_BUFFER = CL_DEVICE_SVM_COARSE_GRAIN_BUFFER,
+        SVM_FINE_GRAIN_BUFFER = CL_DEVICE_SVM_FINE_GRAIN_BUFFER,
+        SVM_FINE_GRAIN_SYSTEM = CL_DEVICE_SVM_FINE_GRAIN_SYSTEM,
+        SVM_ATOMICS = CL_DEVICE_SVM_ATOMICS
+    };
+#endif
+
     /// Create an null device
     Device();
 
@@ -83,6 +92,12 @@ public:
     /// Is `true` if images are supported by the OpenCL device and `false` otherwise.
     bool image_support() const;
 
+#ifdef CL_VERSION_2_0
+    /// Types of shared virtual memory supported by the device. Coarse-grained buffers are
+    /// supported by every OpenCL 2.0 device.
+    Flags<SVMCapability> svm_capabilities() const;
+#endif
+
     /// Max height of 2D image in pixels. The minimum value is 8192 if `image_support` is `true`.
     size_t image2d_max_height() const;
 
@@ -33,7 +33,11 @@ enum MemoryFlag {
     COPY_HOST_PTR = CL_MEM_COPY_HOST_PTR,
     HOST_WRITE_ONLY = CL_MEM_HOST_WRITE_ONLY,
     HOST_READ_ONLY = CL_MEM_HOST_READ_ONLY,
-    HOST_NO_ACCESS = CL_MEM_HOST_NO_ACCESS
+    HOST_NO_ACCESS = CL_MEM_HOST_NO_ACCESS,
+#ifdef CL_VERSION_2_0
+    SVM_FINE_GRAIN_BUFFER = CL_MEM_SVM_FINE_GRAIN_BUFFER,
+    SVM_ATOMICS = CL_MEM_SVM_ATOMICS,
+#endif
 };
 
 struct MemoryFlags : public Flags<MemoryFlag> {
@@ -54,6 +58,74 @@ struct MapFlags : public Flags<MapFlag> {
     operator cl_map_flags() const;
 };
 
+enum MigrationFlag {
+    /// Migrate to the host
+    MIGRATE_TO_HOST = CL_MIGRATE_MEM_OBJECT_HOST,
+    /// Move the memory object without its content
+    MIGRATE_CONTENT_UNDEFINED = CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED
+};
+
+struct MigrationFlags : public Flags<MigrationFlag> {
+    MigrationFlags(const MigrationFlag & flag);
+    MigrationFlags(const Flags<MigrationFlag> & flags);
+    operator cl_mem_migration_flags() const;
+};
+
+enum QueueProperty {
+    OUT_OF_ORDER_EXEC_MODE_ENABLE = CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE,
+    PROFILING_ENABLE = CL_QUEUE_PROFILING_ENABLE
+};
+
+struct QueueProperties : public Flags<QueueProperty> {
+    QueueProperties(const QueueProperty & flag);
+    QueueProperties(const Flags<QueueProperty> & flags);
+    operator cl_command_queue_properties() const;
+};
+
+enum ChannelOrder {
+    R = CL_R,
+    A = CL_A,
+    RG = CL_RG,
+    RA = CL_RA,
+    RGB = CL_RGB,
+    RGBA = CL_RGBA,
+    BGRA = CL_BGRA,
+    ARGB = CL_ARGB,
+    INTENSITY = CL_INTENSITY,
+    LUMINANCE = CL_LUMINANCE
+};
+
+enum ChannelType {
+    SNORM_INT8 = CL_SNORM_INT8,
+    SNORM_INT16 = CL_SNORM_INT16,
+    UNORM_INT8 = CL_UNORM_INT8,
+    UNORM_INT16 = CL_UNORM_INT16,
+    UNORM_SHORT_565 = CL_UNORM_SHORT_565,
+    UNORM_SHORT_555 = CL_UNORM_SHORT_555,
+    UNORM_INT_101010 = CL_UNORM_INT_101010,
+    SIGNED_INT8 = CL_SIGNED_INT8,
+    SIGNED_INT16 = CL_SIGNED_INT16,
+    SIGNED_INT32 = CL_SIGNED_INT32,
+    UNSIGNED_INT8 = CL_UNSIGNED_INT8,
+    UNSIGNED_INT16 = CL_UNSIGNED_INT16,
+    UNSIGNED_INT32 = CL_UNSIGNED_INT32,
+    HALF_FLOAT = CL_HALF_FLOAT,
+    FLOAT = CL_FLOAT
+};
+
+enum AddressingMode {
+    ADDRESS_NONE = CL_ADDRESS_NONE,
+    ADDRESS_CLAMP_TO_EDGE = CL_ADDRESS_CLAMP_TO_EDGE,
+    ADDRESS_CLAMP = CL_ADDRESS_CLAMP,
+    ADDRESS_REPEAT = CL_ADDRESS_REPEAT,
+    ADDRESS_MIRRORED_REPEAT = CL_ADDRESS_MIRRORED_REPEAT
+};
+
+enum FilterMode {
+    FILTER_NEAREST = CL_FILTER_NEAREST,
+    FILTER_LINEAR = CL_FILTER_LINEAR
+};
+
 enum CommandExecutionStatus {
     QUEUED = CL_QUEUED,
     SUBMITTED = CL_SUBMITTED,
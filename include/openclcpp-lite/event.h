@@ -6,13 +6,26 @@
 #include "openclcpp-lite/cl.h"
 #include "openclcpp-lite/templ.h"
 #include "openclcpp-lite/enums.h"
+#include <algorithm>
+#include <array>
+#include <coroutine>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <span>
+#include <vector>
 
 namespace openclcpp_lite {
 
 class Queue;
 class Context;
+class WaitList;
+class WaitListStorage;
 
 /// OpenCL event
+///
+/// Owns a reference to the underlying OpenCL event. Copies share the event and bump its reference
+/// count, the reference is released when the object is destroyed.
 class Event {
 public:
     struct ProfilingInfo {
@@ -31,8 +44,22 @@ public:
         uint64_t end;
     };
 
+    /// Create a null event
+    Event();
+
     /// Create an event from OpenCL event
-    explicit Event(cl_event evt);
+    ///
+    /// @param evt OpenCL event
+    /// @param retain Increment the reference count of `evt`. By default, the new object takes over
+    ///        the reference held by the caller.
+    explicit Event(cl_event evt, bool retain = false);
+
+    Event(const Event & other);
+    Event(Event && other) noexcept;
+    ~Event();
+
+    Event & operator=(const Event & other);
+    Event & operator=(Event && other) noexcept;
 
     /// Increment the context reference count.
     void retain() const;
@@ -61,6 +88,56 @@ public:
     /// Returns profiling information for the command associated with event if profiling is enabled.
     ProfilingInfo profiling_info() const;
 
+    /// Register a function to be called when the command identified by the event completes or
+    /// terminates with an error. Use `command_execution_status` to tell the two apart.
+    ///
+    /// The function is called from a thread managed by the OpenCL implementation, so it must be
+    /// thread-safe and must not call blocking OpenCL functions such as `Event::wait` or
+    /// `Queue::wait`. Exceptions thrown by the function are swallowed.
+    ///
+    /// @param callback Function to call
+    /// @return Reference to this event
+    const Event & then(std::function<void()> callback) const;
+
+    /// Get a future that becomes ready when the command identified by the event completes
+    ///
+    /// If the command terminates with an error, the future holds an `Exception`.
+    ///
+    /// @return Future
+    std::future<void> get_future() const;
+
+    /// Awaiter that suspends a coroutine until an event completes
+    class Awaiter {
+    public:
+        explicit Awaiter(cl_event evt);
+        Awaiter(const Awaiter &) = delete;
+        ~Awaiter();
+
+        bool await_ready();
+
+        void await_suspend(std::coroutine_handle<> handle);
+
+        /// Throws `Exception` if the command terminated with an error
+        void await_resume() const;
+
+    private:
+        /// Awaited event, the awaiter holds a reference to it
+        cl_event evt_;
+        /// Execution status of the command once it finished
+        cl_int status_;
+    };
+
+    /// Suspend a coroutine until the command identified by the event completes
+    ///
+    /// The coroutine is resumed on the thread the OpenCL implementation calls event callbacks
+    /// from (see `then`), so it should hand any blocking work over to another thread.
+    ///
+    /// Example:
+    /// ```
+    /// co_await q.copy(d_a, h_a.data(), rng);
+    /// ```
+    Awaiter operator co_await() const;
+
     operator cl_event() const;
 
 private:
@@ -82,12 +159,178 @@ private:
         return val;
     }
 
+    /// Register a function that receives the execution status of a command once it completes
+    static void on_complete(cl_event evt, std::function<void(cl_int)> callback);
+
     /// Underlying OpenCL event
     cl_event evt_;
 
 public:
     /// Waits on the host thread for commands identified by event objects to complete.
-    static void wait(const std::vector<Event> & events);
+    static void wait(WaitList events);
+};
+
+/// Non-owning list of events a command waits for
+///
+/// A single event, a braced list of events or a `std::vector<Event>` converts into a wait list
+/// without copying or allocating. The list refers to the events of the caller, so it is meant to be
+/// used as a parameter type and must not outlive the events. A null event converts into an empty
+/// list.
+class WaitList {
+public:
+    /// Create an empty wait list
+    WaitList() : data_(nullptr), size_(0), sparse_(false) {}
+
+    /// Create a wait list with a single event
+    WaitList(const Event & evt) :
+        data_(&evt),
+        size_(static_cast<cl_event>(evt) == nullptr ? 0 : 1),
+        sparse_(false)
+    {
+    }
+
+    /// Create a wait list from a braced list of events
+    WaitList(std::initializer_list<Event> events) :
+        WaitList(std::span<const Event>(std::data(events), events.size()))
+    {
+    }
+
+    /// Create a wait list from a vector of events
+    WaitList(const std::vector<Event> & events) : WaitList(std::span<const Event>(events)) {}
+
+    /// Create a wait list from a contiguous sequence of events
+    WaitList(std::span<const Event> events) :
+        data_(events.data()),
+        size_(events.size()),
+        sparse_(std::any_of(events.begin(), events.end(), [](const Event & e) {
+            return static_cast<cl_event>(e) == nullptr;
+        }))
+    {
+    }
+
+    /// Check if the list contains null events. Such a list has to be compacted (see `dense`)
+    /// before it is passed into OpenCL.
+    bool
+    sparse() const
+    {
+        return this->sparse_;
+    }
+
+    /// Get the list without null events
+    ///
+    /// @param storage Storage for the compacted list, used only if the list is sparse
+    /// @return This list if it has no null events, the compacted list in `storage` otherwise
+    WaitList dense(WaitListStorage & storage) const;
+
+    /// Number of events in the list
+    std::size_t
+    size() const
+    {
+        return this->size_;
+    }
+
+    /// Check if the list is empty
+    bool
+    empty() const
+    {
+        return this->size_ == 0;
+    }
+
+    /// Events to pass into OpenCL, `nullptr` if the list is empty
+    const cl_event *
+    data() const
+    {
+        static_assert(sizeof(Event) == sizeof(cl_event), "Event must wrap just a cl_event");
+        return this->size_ == 0 ? nullptr : reinterpret_cast<const cl_event *>(this->data_);
+    }
+
+    const Event *
+    begin() const
+    {
+        return this->data_;
+    }
+
+    const Event *
+    end() const
+    {
+        return this->data_ + this->size_;
+    }
+
+private:
+    /// First event
+    const Event * data_;
+    /// Number of events
+    std::size_t size_;
+    /// `true` if some of the events are null
+    bool sparse_;
 };
 
+/// Storage for merging wait lists
+///
+/// Keeps a few events inline and only goes to the heap for longer lists, so merging the wait list
+/// of a command with its tracked dependencies does not allocate in the common case.
+class WaitListStorage {
+public:
+    WaitListStorage() : size_(0) {}
+
+    /// Append an event, null events are skipped
+    void
+    push_back(const Event & evt)
+    {
+        if (static_cast<cl_event>(evt) == nullptr)
+            return;
+        if (this->size_ < N)
+            this->inline_[this->size_] = evt;
+        else {
+            if (this->heap_.empty())
+                this->heap_.assign(this->inline_.begin(), this->inline_.end());
+            this->heap_.push_back(evt);
+        }
+        this->size_++;
+    }
+
+    /// Append events of a wait list
+    void
+    append(WaitList events)
+    {
+        for (auto & e : events)
+            push_back(e);
+    }
+
+    /// Number of stored events
+    std::size_t
+    size() const
+    {
+        return this->size_;
+    }
+
+    operator WaitList() const
+    {
+        if (this->size_ <= N)
+            return std::span<const Event>(this->inline_.data(), this->size_);
+        else
+            return this->heap_;
+    }
+
+private:
+    /// Number of events stored inline
+    static constexpr std::size_t N = 4;
+
+    /// Inline storage
+    std::array<Event, N> inline_;
+    /// Heap storage used once there are more than `N` events
+    std::vector<Event> heap_;
+    /// Number of stored events
+    std::size_t size_;
+};
+
+inline WaitList
+WaitList::dense(WaitListStorage & storage) const
+{
+    if (!this->sparse_)
+        return *this;
+    storage.append(*this);
+    return storage;
+}
+
 } // namespace openclcpp_lite
@@ -0,0 +1,357 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/enums.h"
+#include "openclcpp-lite/memory.h"
+#include "openclcpp-lite/range.h"
+#include "openclcpp-lite/context.h"
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <source_location>
+
+namespace openclcpp_lite {
+
+/// Image format, i.e. the channels of a pixel and how each channel is stored
+struct ImageFormat {
+    /// Channels of a pixel
+    ChannelOrder order;
+    /// Storage of a channel
+    ChannelType type;
+
+    /// Number of channels of a pixel
+    size_t num_of_channels() const;
+
+    /// Size of a pixel in bytes
+    size_t pixel_size() const;
+
+    operator cl_image_format() const;
+
+    bool operator==(const ImageFormat & other) const = default;
+};
+
+/// Default image format of pixels of C++ type `T`
+///
+/// Specialized for the scalar and vector types with a natural format. Other pixel types need an
+/// explicit `ImageFormat` when the image is created.
+template <typename T>
+struct PixelFormat;
+
+template <>
+struct PixelFormat<cl_float> {
+    static constexpr ImageFormat value = { R, FLOAT };
+};
+
+template <>
+struct PixelFormat<cl_float2> {
+    static constexpr ImageFormat value = { RG, FLOAT };
+};
+
+template <>
+struct PixelFormat<cl_float4> {
+    static constexpr ImageFormat value = { RGBA, FLOAT };
+};
+
+template <>
+struct PixelFormat<cl_int> {
+    static constexpr ImageFormat value = { R, SIGNED_INT32 };
+};
+
+template <>
+struct PixelFormat<cl_int4> {
+    static constexpr ImageFormat value = { RGBA, SIGNED_INT32 };
+};
+
+template <>
+struct PixelFormat<cl_uint> {
+    static constexpr ImageFormat value = { R, UNSIGNED_INT32 };
+};
+
+template <>
+struct PixelFormat<cl_uint4> {
+    static constexpr ImageFormat value = { RGBA, UNSIGNED_INT32 };
+};
+
+/// Normalized, so kernels read the pixels as `float4` in [0, 1] and can filter them
+template <>
+struct PixelFormat<cl_uchar4> {
+    static constexpr ImageFormat value = { RGBA, UNORM_INT8 };
+};
+
+/// OpenCL image. Base class for `Image2D`, `Image3D` and `Image2DArray`
+class Image : public Memory {
+public:
+    /// Create a null image
+    Image();
+
+    /// Create an image from an OpenCL image
+    ///
+    /// @param mem OpenCL image
+    /// @param retain Increment the reference count of `mem`. By default, the new object takes over
+    ///        the reference held by the caller.
+    explicit Image(cl_mem mem, bool retain = false);
+
+    /// Return the image format
+    ImageFormat format() const;
+
+    /// Return the size of a pixel in bytes
+    size_t element_size() const;
+
+    /// Return the size in bytes of a row of pixels
+    size_t row_pitch() const;
+
+    /// Return the size in bytes of a 2D slice of a 3D image or of an image of an image array, 0
+    /// for 2D images.
+    size_t slice_pitch() const;
+
+    /// Return the width of the image in pixels
+    size_t width() const;
+
+    /// Return the height of the image in pixels
+    size_t height() const;
+
+    /// Return the depth of a 3D image in pixels, 0 for other images
+    size_t depth() const;
+
+    /// Return the number of images in an image array, 0 for other images
+    size_t array_size() const;
+
+    /// Return the extent of the whole image in the 3-dimensional form used by image commands
+    std::array<size_t, 3> region() const;
+
+protected:
+    /// Create an OpenCL image
+    ///
+    /// The size is validated against the image limits of all devices in the context.
+    ///
+    /// @param context OpenCL context
+    /// @param mem_flags Memory flags
+    /// @param format Image format
+    /// @param type `CL_MEM_OBJECT_IMAGE2D`, `CL_MEM_OBJECT_IMAGE3D` or
+    ///        `CL_MEM_OBJECT_IMAGE2D_ARRAY`
+    /// @param width Width in pixels
+    /// @param height Height in pixels
+    /// @param depth Depth in pixels (3D images)
+    /// @param array_size Number of images (image arrays)
+    /// @param loc Source location recorded by `MemoryAccounting`
+    /// @return New OpenCL image
+    static cl_mem create(const Context & context,
+                         MemoryFlags mem_flags,
+                         const ImageFormat & format,
+                         cl_mem_object_type type,
+                         size_t width,
+                         size_t height,
+                         size_t depth,
+                         size_t array_size,
+                         const std::source_location & loc);
+
+    template <typename T>
+    T
+    get_image_info(cl_image_info name) const
+    {
+        T val;
+        get_info_helper(clGetImageInfo, this->mem_, name, val);
+        return val;
+    }
+};
+
+/// 2D image
+///
+/// @tparam T C++ type of a pixel
+template <typename T>
+class Image2D : public Image {
+public:
+    using type = T;
+
+    /// Create an image with the default format of `T` on the default context
+    ///
+    /// @param size Width and height in pixels
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    explicit Image2D(const Range<2> & size,
+                     MemoryFlags mem_flags = READ_WRITE,
+                     std::source_location loc = std::source_location::current()) :
+        Image2D(Context::get_default(), PixelFormat<T>::value, size, mem_flags, loc)
+    {
+    }
+
+    /// Create an image with the default format of `T`
+    ///
+    /// @param context OpenCL context
+    /// @param size Width and height in pixels
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Image2D(const Context & context,
+            const Range<2> & size,
+            MemoryFlags mem_flags = READ_WRITE,
+            std::source_location loc = std::source_location::current()) :
+        Image2D(context, PixelFormat<T>::value, size, mem_flags, loc)
+    {
+    }
+
+    /// Create an image
+    ///
+    /// @param context OpenCL context
+    /// @param format Image format, its pixel size must be `sizeof(T)`
+    /// @param size Width and height in pixels
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Image2D(const Context & context,
+            const ImageFormat & format,
+            const Range<2> & size,
+            MemoryFlags mem_flags = READ_WRITE,
+            std::source_location loc = std::source_location::current()) :
+        Image(create(context,
+                     mem_flags,
+                     format,
+                     CL_MEM_OBJECT_IMAGE2D,
+                     size.size(0),
+                     size.size(1),
+                     0,
+                     0,
+                     loc))
+    {
+        assert(format.pixel_size() == sizeof(T));
+    }
+
+    /// Return the width and height in pixels
+    Range<2>
+    range() const
+    {
+        return Range<2> { width(), height() };
+    }
+};
+
+/// 3D image
+///
+/// @tparam T C++ type of a pixel
+template <typename T>
+class Image3D : public Image {
+public:
+    using type = T;
+
+    /// Create an image with the default format of `T` on the default context
+    ///
+    /// @param size Width, height and depth in pixels
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    explicit Image3D(const Range<3> & size,
+                     MemoryFlags mem_flags = READ_WRITE,
+                     std::source_location loc = std::source_location::current()) :
+        Image3D(Context::get_default(), PixelFormat<T>::value, size, mem_flags, loc)
+    {
+    }
+
+    /// Create an image with the default format of `T`
+    ///
+    /// @param context OpenCL context
+    /// @param size Width, height and depth in pixels
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Image3D(const Context & context,
+            const Range<3> & size,
+            MemoryFlags mem_flags = READ_WRITE,
+            std::source_location loc = std::source_location::current()) :
+        Image3D(context, PixelFormat<T>::value, size, mem_flags, loc)
+    {
+    }
+
+    /// Create an image
+    ///
+    /// @param context OpenCL context
+    /// @param format Image format, its pixel size must be `sizeof(T)`
+    /// @param size Width, height and depth in pixels
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Image3D(const Context & context,
+            const ImageFormat & format,
+            const Range<3> & size,
+            MemoryFlags mem_flags = READ_WRITE,
+            std::source_location loc = std::source_location::current()) :
+        Image(create(context,
+                     mem_flags,
+                     format,
+                     CL_MEM_OBJECT_IMAGE3D,
+                     size.size(0),
+                     size.size(1),
+                     size.size(2),
+                     0,
+                     loc))
+    {
+        assert(format.pixel_size() == sizeof(T));
+    }
+
+    /// Return the width, height and depth in pixels
+    Range<3>
+    range() const
+    {
+        return Range<3> { width(), height(), depth() };
+    }
+};
+
+/// Array of 2D images of the same size
+///
+/// @tparam T C++ type of a pixel
+template <typename T>
+class Image2DArray : public Image {
+public:
+    using type = T;
+
+    /// Create an image array with the default format of `T` on the default context
+    ///
+    /// @param size Width and height of the images in pixels
+    /// @param n_images Number of images
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Image2DArray(const Range<2> & size,
+                 size_t n_images,
+                 MemoryFlags mem_flags = READ_WRITE,
+                 std::source_location loc = std::source_location::current()) :
+        Image2DArray(Context::get_default(),
+                     PixelFormat<T>::value,
+                     size,
+                     n_images,
+                     mem_flags,
+                     loc)
+    {
+    }
+
+    /// Create an image array
+    ///
+    /// @param context OpenCL context
+    /// @param format Image format, its pixel size must be `sizeof(T)`
+    /// @param size Width and height of the images in pixels
+    /// @param n_images Number of images
+    /// @param mem_flags Memory flags
+    /// @param loc Source location recorded by `MemoryAccounting`
+    Image2DArray(const Context & context,
+                 const ImageFormat & format,
+                 const Range<2> & size,
+                 size_t n_images,
+                 MemoryFlags mem_flags = READ_WRITE,
+                 std::source_location loc = std::source_location::current()) :
+        Image(create(context,
+                     mem_flags,
+                     format,
+                     CL_MEM_OBJECT_IMAGE2D_ARRAY,
+                     size.size(0),
+                     size.size(1),
+                     0,
+                     n_images,
+                     loc))
+    {
+        assert(format.pixel_size() == sizeof(T));
+    }
+
+    /// Return the width and height of the images in pixels
+    Range<2>
+    range() const
+    {
+        return Range<2> { width(), height() };
+    }
+};
+
+} // namespace openclcpp_lite
@@ -8,25 +8,51 @@
 #include "openclcpp-lite/memory.h"
 #include "openclcpp-lite/program.h"
 #include "openclcpp-lite/event.h"
+#include <span>
 #include <string>
+#include <type_traits>
 
 namespace openclcpp_lite {
 
 class Program;
 class Memory;
 class Context;
+class Device;
+class Sampler;
 
 template <typename... Ts>
 class KernelFunctor;
 
+#ifdef CL_VERSION_2_0
+template <typename T>
+class SVMPointer;
+
+namespace internal {
+
+template <typename T>
+struct is_svm_pointer : std::false_type {};
+
+template <typename T>
+struct is_svm_pointer<SVMPointer<T>> : std::true_type {};
+
+} // namespace internal
+#endif
+
 /// OpenCL kernel
+///
+/// Owns a reference to the underlying OpenCL kernel. Copies share the kernel and bump its reference
+/// count, the reference is released when the object is destroyed.
 class Kernel {
 public:
     /// Create empty kernel
     Kernel();
 
     /// Create a kernel from an OpenCL kernel
-    explicit Kernel(cl_kernel kernel);
+    ///
+    /// @param kernel OpenCL kernel
+    /// @param retain Increment the reference count of `kernel`. By default, the new object takes
+    ///        over the reference held by the caller.
+    explicit Kernel(cl_kernel kernel, bool retain = false);
 
     /// Create a kernel from a program and a kernel name
     ///
@@ -34,6 +60,13 @@ public:
     /// @param kernel_name Kernel name
     Kernel(const Program & program, const std::string & kernel_name);
 
+    Kernel(const Kernel & other);
+    Kernel(Kernel && other) noexcept;
+    ~Kernel();
+
+    Kernel & operator=(const Kernel & other);
+    Kernel & operator=(Kernel && other) noexcept;
+
     /// Increments the kernel object reference count
     void retain() const;
 
@@ -59,15 +92,39 @@ public:
     /// declaration in the program source
     std::vector<std::string> attributes() const;
 
+    /// Maximum work-group size that can be used to execute the kernel on a device
+    ///
+    /// @param device Device
+    /// @return Maximum work-group size
+    size_t work_group_size(const Device & device) const;
+
+    /// Preferred multiple of work-group size for launch. This is a performance hint.
+    ///
+    /// @param device Device
+    /// @return Preferred multiple of work-group size
+    size_t preferred_work_group_size_multiple(const Device & device) const;
+
     /// Set the argument value for a specific argument of a kernel.
     ///
+    /// Memory objects (buffers, images) and samplers are passed as their OpenCL handle. Pointers
+    /// into shared virtual memory are passed wrapped in `SVMPointer` (see `svm_ptr`).
+    ///
     /// @param index The argument index
     /// @param value Argument
     template <typename T>
     void
     set_arg(cl_uint index, const T & value)
     {
-        OPENCL_CHECK(clSetKernelArg(this->kern_, index, sizeof(T), &value));
+        if constexpr (std::is_base_of_v<Memory, T>)
+            set_mem_arg(index, value);
+        else if constexpr (std::is_same_v<T, Sampler>)
+            set_sampler_arg(index, value);
+#ifdef CL_VERSION_2_0
+        else if constexpr (internal::is_svm_pointer<T>::value)
+            set_arg_svm(index, value.get());
+#endif
+        else
+            set_arg(index, sizeof(T), &value);
     }
 
     /// Set the argument value for a specific argument of a kernel.
@@ -77,9 +134,38 @@ public:
     /// specified by arg_index
     void set_arg(cl_uint index, size_t size, const void * arg);
 
+#ifdef CL_VERSION_2_0
+    /// Set a shared virtual memory pointer as the argument value for a specific argument of a
+    /// kernel.
+    ///
+    /// @param index The argument index
+    /// @param ptr Pointer into shared virtual memory
+    void set_arg_svm(cl_uint index, const void * ptr);
+
+    /// Declare shared virtual memory that the kernel accesses through pointers stored in other SVM
+    /// allocations (e.g. nodes of a tree), rather than through its arguments.
+    ///
+    /// Not needed for allocations with fine-grained system SVM.
+    ///
+    /// @param ptrs Pointers into the indirectly accessed SVM allocations
+    void set_svm_pointers(std::span<void * const> ptrs);
+#endif
+
     operator cl_kernel() const;
 
 private:
+    /// Set a memory object as the argument value for a specific argument of a kernel
+    ///
+    /// @param index The argument index
+    /// @param mem Memory object
+    void set_mem_arg(cl_uint index, cl_mem mem);
+
+    /// Set a sampler as the argument value for a specific argument of a kernel
+    ///
+    /// @param index The argument index
+    /// @param sampler Sampler
+    void set_sampler_arg(cl_uint index, cl_sampler sampler);
+
     template <typename T>
     T
     get_info(cl_kernel_info name) const
@@ -103,11 +189,4 @@ public:
     }
 };
 
-template <>
-inline void
-Kernel::set_arg(cl_uint index, const Memory & value)
-{
-    OPENCL_CHECK(clSetKernelArg(this->kern_, index, sizeof(cl_mem), &value));
-}
-
 } // namespace openclcpp_lite
@@ -10,10 +10,14 @@
 #include "openclcpp-lite/event.h"
 #include "openclcpp-lite/kernel.h"
 #include <string>
+#include <type_traits>
 
 namespace openclcpp_lite {
 
 /// OpenCL kernel functor
+///
+/// Arguments are bound to consecutive kernel arguments. Types that define `NUM_KERNEL_ARGS` (e.g.
+/// `PitchedBuffer`) take that many kernel arguments and bind them with `set_kernel_args`.
 template <typename... ARGS>
 class KernelFunctor {
 public:
@@ -34,7 +38,7 @@ public:
     ///
     /// @param args Kernel arguments
     /// @return Kernel object
-    Kernel
+    const Kernel &
     operator()(ARGS... args)
     {
         set_args<0>(std::forward<ARGS>(args)...);
@@ -45,19 +49,40 @@ private:
     /// OpenCL kernel
     Kernel kern_;
 
+    /// Number of kernel arguments an argument of type `T` takes
+    template <typename T>
+    static constexpr int
+    num_kernel_args()
+    {
+        if constexpr (requires { T::NUM_KERNEL_ARGS; })
+            return T::NUM_KERNEL_ARGS;
+        else
+            return 1;
+    }
+
+    template <int INDEX, typename T0>
+    void
+    set_arg(const T0 & t0)
+    {
+        if constexpr (requires { T0::NUM_KERNEL_ARGS; })
+            t0.set_kernel_args(this->kern_, INDEX);
+        else
+            this->kern_.set_arg(INDEX, t0);
+    }
+
     template <int INDEX, typename T0, typename... T1S>
     void
     set_args(T0 && t0, T1S &&... t1s)
     {
-        this->kern_.set_arg(INDEX, t0);
-        set_args<INDEX + 1, T1S...>(std::forward<T1S>(t1s)...);
+        set_arg<INDEX>(t0);
+        set_args<INDEX + num_kernel_args<std::decay_t<T0>>(), T1S...>(std::forward<T1S>(t1s)...);
     }
 
     template <int INDEX, typename T0>
     void
     set_args(T0 && t0)
     {
-        this->kern_.set_arg(INDEX, t0);
+        set_arg<INDEX>(t0);
     }
 
     template <int>
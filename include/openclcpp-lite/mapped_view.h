@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/event.h"
+#include "openclcpp-lite/memory.h"
+#include "openclcpp-lite/queue.h"
+#include <cstddef>
+#include <span>
+#include <utility>
+
+namespace openclcpp_lite {
+
+/// Region of a buffer mapped into the host address space
+///
+/// Returned by `Queue::map`. The region is unmapped when the view is destroyed, or earlier by
+/// calling `unmap`. A view from a non-blocking map can be accessed only after `event()` has
+/// completed, call `wait()` or pass the event into a wait list.
+///
+/// Example:
+/// ```
+/// {
+///     auto view = q.map(d_a, WRITE_INVALIDATE_REGION, Range<1> { 10 }, Range<1> { 5 });
+///     std::fill(view.begin(), view.end(), 1.);
+/// } // unmapped here
+/// ```
+///
+/// @tparam T C++ type of the mapped elements
+template <typename T>
+class MappedView {
+public:
+    /// Create an empty view
+    MappedView() : ptr_(nullptr), n_(0) {}
+
+    /// Create a view of a mapped region
+    ///
+    /// @param queue Queue the region was mapped on, it is also used to unmap it
+    /// @param mem Mapped memory object
+    /// @param ptr Mapped host pointer
+    /// @param n Number of mapped elements
+    /// @param evt Event of the map command
+    MappedView(const Queue & queue, const Memory & mem, T * ptr, std::size_t n, Event evt) :
+        queue_(queue),
+        mem_(mem),
+        ptr_(ptr),
+        n_(n),
+        event_(std::move(evt))
+    {
+    }
+
+    MappedView(const MappedView &) = delete;
+
+    MappedView(MappedView && other) noexcept :
+        queue_(std::move(other.queue_)),
+        mem_(std::move(other.mem_)),
+        ptr_(std::exchange(other.ptr_, nullptr)),
+        n_(std::exchange(other.n_, 0)),
+        event_(std::move(other.event_))
+    {
+    }
+
+    ~MappedView()
+    {
+        if (this->ptr_ == nullptr)
+            return;
+        // destructors must not throw, a failed unmap is only lost
+        try {
+            unmap();
+        }
+        catch (...) {
+        }
+    }
+
+    MappedView & operator=(const MappedView &) = delete;
+
+    MappedView &
+    operator=(MappedView && other) noexcept
+    {
+        std::swap(this->queue_, other.queue_);
+        std::swap(this->mem_, other.mem_);
+        std::swap(this->ptr_, other.ptr_);
+        std::swap(this->n_, other.n_);
+        std::swap(this->event_, other.event_);
+        return *this;
+    }
+
+    /// Pointer to the first mapped element
+    T *
+    data() const
+    {
+        return this->ptr_;
+    }
+
+    /// Number of mapped elements
+    std::size_t
+    size() const
+    {
+        return this->n_;
+    }
+
+    /// Check if the view maps no elements
+    bool
+    empty() const
+    {
+        return this->n_ == 0;
+    }
+
+    /// Mapped elements as a span
+    std::span<T>
+    span() const
+    {
+        return std::span<T>(this->ptr_, this->n_);
+    }
+
+    T *
+    begin() const
+    {
+        return this->ptr_;
+    }
+
+    T *
+    end() const
+    {
+        return this->ptr_ + this->n_;
+    }
+
+    T &
+    operator[](std::size_t idx) const
+    {
+        return this->ptr_[idx];
+    }
+
+    /// Event of the map command, the elements can be accessed once it has completed
+    const Event &
+    event() const
+    {
+        return this->event_;
+    }
+
+    /// Wait for the map command to complete
+    void
+    wait() const
+    {
+        if (static_cast<cl_event>(this->event_) != nullptr)
+            this->event_.wait();
+    }
+
+    /// Unmap the region
+    ///
+    /// The view is empty afterwards.
+    ///
+    /// @return Event of the unmap command, a null event if the view was empty
+    Event
+    unmap()
+    {
+        if (this->ptr_ == nullptr)
+            return Event();
+        auto * ptr = std::exchange(this->ptr_, nullptr);
+        this->n_ = 0;
+        this->event_ = Event();
+        return this->queue_.enqueue_unmap_mem_object(this->mem_, ptr);
+    }
+
+private:
+    /// Queue used to unmap the region
+    Queue queue_;
+    /// Mapped memory object, kept alive until the region is unmapped
+    Memory mem_;
+    /// Mapped host pointer
+    T * ptr_;
+    /// Number of mapped elements
+    std::size_t n_;
+    /// Event of the map command
+    Event event_;
+};
+
+} // namespace openclcpp_lite
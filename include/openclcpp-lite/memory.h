@@ -5,17 +5,34 @@
 
 #include "openclcpp-lite/cl.h"
 #include "openclcpp-lite/templ.h"
+#include <memory>
 
 namespace openclcpp_lite {
 
 class Context;
 
 /// OpenCL memory. Base class for Buffers and Images
+///
+/// Owns a reference to the underlying OpenCL memory object. Copies share the memory object and bump
+/// its reference count, the reference is released when the object is destroyed.
 class Memory {
 public:
-    Memory() = default;
+    /// Create a null memory object
+    Memory();
 
-    Memory(cl_mem mem);
+    /// Create a memory object from an OpenCL memory object
+    ///
+    /// @param mem OpenCL memory object
+    /// @param retain Increment the reference count of `mem`. By default, the new object takes over
+    ///        the reference held by the caller.
+    explicit Memory(cl_mem mem, bool retain = false);
+
+    Memory(const Memory & other);
+    Memory(Memory && other) noexcept;
+    ~Memory();
+
+    Memory & operator=(const Memory & other);
+    Memory & operator=(Memory && other) noexcept;
 
     /// Increments the memory object reference count.
     void retain() const;
@@ -44,9 +61,23 @@ public:
     /// This returns 0 if memobj is not a subbuffer object.
     size_t offset() const;
 
+    /// Return the host memory used as storage of the memory object (`USE_HOST_PTR`), `nullptr` if
+    /// the memory object was created without it.
+    void * host_ptr() const;
+
+    /// Return the host memory the object was created on for zero-copy access, `nullptr` if the
+    /// object was not created that way by this library. Unlike `host_ptr`, this does not query
+    /// the OpenCL implementation.
+    void * host_storage() const;
+
     operator cl_mem() const;
 
 protected:
+    /// Keep an object alive until the OpenCL memory object is destroyed
+    ///
+    /// @param owner Object to keep alive, typically the owner of the host memory used as storage
+    void keep_alive(std::shared_ptr<void> owner) const;
+
     template <typename T>
     T
     get_info(cl_mem_info name) const
@@ -58,6 +89,8 @@ protected:
 
     /// Underlying OpenCL memory
     cl_mem mem_;
+    /// Host memory used as storage, remembered when the object is created with `USE_HOST_PTR`
+    void * host_;
 };
 
 } // namespace openclcpp_lite
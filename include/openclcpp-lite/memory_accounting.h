@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include <cstdint>
+#include <iosfwd>
+#include <source_location>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace openclcpp_lite {
+
+class Context;
+class Device;
+
+/// Accounting of live device memory
+///
+/// Every memory object created by the library (buffers, images, memory pool slabs and staging
+/// blocks) is recorded with its context and the source location that created it, and is removed
+/// again when the OpenCL implementation destroys it. Sub-buffers are not recorded, their memory is
+/// accounted to their parent buffer.
+///
+/// OpenCL does not tie a buffer to one device of a context, so a memory object counts against
+/// every device of its context. For single-device contexts this is the exact usage, otherwise it
+/// is the worst case.
+///
+/// The usage of a context, including its peak, is kept until the context is destroyed. Before
+/// OpenCL 3.0 the destruction of a context cannot be observed, so its usage is dropped as soon as
+/// it has no live memory objects.
+///
+/// Example:
+/// ```
+/// auto usage = MemoryAccounting::snapshot().device(dev);
+/// auto batch = (dev.global_mem_size() - usage.live_bytes) / bytes_per_item;
+/// ```
+class MemoryAccounting {
+public:
+    struct Usage {
+        /// Bytes of live memory objects
+        std::size_t live_bytes = 0;
+        /// Highest value of `live_bytes`
+        std::size_t peak_bytes = 0;
+        /// Number of live memory objects
+        std::uint64_t live_allocations = 0;
+        /// Number of memory objects created
+        std::uint64_t total_allocations = 0;
+    };
+
+    /// Usage by memory objects created at one source location
+    struct Site {
+        std::string file;
+        std::uint_least32_t line;
+        std::string function;
+        Usage usage;
+    };
+
+    struct Snapshot {
+        /// Usage of all memory objects
+        Usage total;
+        /// Usage by context, for contexts that have not been destroyed yet
+        std::vector<std::pair<cl_context, Usage>> contexts;
+        /// Usage by device
+        std::vector<std::pair<cl_device_id, Usage>> devices;
+        /// Usage by source location, ordered by live bytes (largest first)
+        std::vector<Site> sites;
+
+        /// Usage of a context, zero if it has no recorded memory objects
+        Usage context(const Context & context) const;
+
+        /// Usage of a device, zero if it has no recorded memory objects
+        Usage device(const Device & device) const;
+    };
+
+    /// Record a memory object
+    ///
+    /// Called for every memory object created by the library. Memory objects created directly
+    /// through the OpenCL API can be recorded with it as well.
+    ///
+    /// @param mem Memory object
+    /// @param context Context of `mem`
+    /// @param size Size of `mem` in bytes
+    /// @param loc Source location that created `mem`
+    static void track(cl_mem mem,
+                      cl_context context,
+                      std::size_t size,
+                      const std::source_location & loc = std::source_location::current());
+
+    /// Get the current usage
+    static Snapshot snapshot();
+
+    /// Write a usage report
+    ///
+    /// @param os Output stream
+    static void dump(std::ostream & os);
+
+    /// Write a usage report into `stderr` when the process exits
+    ///
+    /// @param enable `true` to write the report
+    static void set_dump_at_exit(bool enable);
+
+    /// Turn the accounting on or off
+    ///
+    /// Memory objects created while the accounting is off are not recorded. The accounting is on
+    /// by default.
+    ///
+    /// @param enable `true` to record memory objects
+    static void set_enabled(bool enable);
+
+    /// Check if the accounting is on
+    static bool enabled();
+
+    /// Reset the peak usage to the current usage
+    static void reset_peaks();
+};
+
+} // namespace openclcpp_lite
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/enums.h"
+#include "openclcpp-lite/memory.h"
+#include <cstdint>
+#include <memory>
+#include <source_location>
+
+namespace openclcpp_lite {
+
+class Context;
+
+/// Pool of device memory with size-class sub-allocation
+///
+/// Memory is reserved from the OpenCL implementation in large slabs. Every slab is split into
+/// equally sized blocks of one size class (powers of two, starting at the base address alignment
+/// of the devices in the context), and allocations are handed out as sub-buffers of these blocks.
+/// A block goes back into the pool when the last reference to its sub-buffer is released, so a
+/// buffer allocated from the pool is used like any other buffer. Requests larger than a slab are
+/// allocated directly.
+///
+/// Copies of a pool share the same memory. Blocks stay reserved until `trim` is called or the pool
+/// and all its allocations are gone.
+///
+/// Example:
+/// ```
+/// MemoryPool pool(ctx);
+/// for (int i = 0; i < n; i++) {
+///     Buffer<float> d_tmp { pool, rng };
+///     ...
+/// }
+/// ```
+class MemoryPool {
+public:
+    struct Stats {
+        /// Bytes reserved from the OpenCL implementation (slabs and direct allocations)
+        std::size_t bytes_reserved;
+        /// Bytes of the blocks handed out to live allocations
+        std::size_t bytes_in_use;
+        /// Bytes requested by live allocations
+        std::size_t bytes_requested;
+        /// Number of allocations served from a free block
+        std::uint64_t hits;
+        /// Number of allocations that had to reserve memory from the OpenCL implementation
+        std::uint64_t misses;
+
+        /// Fraction of the in-use bytes lost to rounding requests up to their size class
+        double fragmentation() const;
+
+        /// Fraction of allocations served from a free block
+        double hit_rate() const;
+    };
+
+    /// Create a pool
+    ///
+    /// @param context OpenCL context
+    /// @param slab_size Size of the slabs in bytes. Clamped to the maximum allocation size of the
+    ///        devices in the context.
+    /// @param mem_flags Memory flags of the slabs, inherited by the allocations
+    /// @param loc Source location `MemoryAccounting` records for the memory of the pool
+    explicit MemoryPool(const Context & context,
+                        std::size_t slab_size = DEFAULT_SLAB_SIZE,
+                        MemoryFlags mem_flags = READ_WRITE,
+                        std::source_location loc = std::source_location::current());
+
+    /// Allocate memory
+    ///
+    /// @param size Size of the allocation in bytes
+    /// @return Memory object of exactly `size` bytes
+    Memory allocate(std::size_t size);
+
+    /// Return the context of the pool
+    Context context() const;
+
+    /// Alignment of the allocations in bytes
+    std::size_t alignment() const;
+
+    /// Size of the slabs in bytes
+    std::size_t slab_size() const;
+
+    /// Size of the block an allocation of `size` bytes is served from
+    ///
+    /// @param size Size of the allocation in bytes
+    /// @return Size of the block in bytes, 0 if the allocation bypasses the pool
+    std::size_t size_class(std::size_t size) const;
+
+    /// Return the pool statistics
+    Stats stats() const;
+
+    /// Release slabs without live allocations back to the OpenCL implementation
+    void trim();
+
+private:
+    struct Data;
+
+    /// Default size of the slabs in bytes
+    static constexpr std::size_t DEFAULT_SLAB_SIZE = 64 * 1024 * 1024;
+
+    /// Slabs, free blocks and statistics, shared with the live allocations
+    std::shared_ptr<Data> data_;
+
+public:
+    /// Get the pool on the default context
+    ///
+    /// @return Default pool object
+    static MemoryPool get_default();
+};
+
+} // namespace openclcpp_lite
@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/event.h"
+#include "openclcpp-lite/exception.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/range.h"
+#include <vector>
+
+namespace openclcpp_lite {
+
+/// Streaming pipeline that overlaps host-device transfers with kernel execution
+///
+/// The input is split into chunks that are pushed through `depth` rotating slots of device
+/// buffers. Uploads and downloads go into a transfer queue, kernels into a compute queue, and the
+/// commands are chained with events, so chunk `k + 1` uploads while chunk `k` is being computed.
+///
+/// Example:
+/// ```
+/// Pipeline<float> pipe(ctx, dev, 1 << 20, 3);
+/// pipe.run(input.data(), output.data(), input.size(), [&](auto & in, auto & out, size_t n) {
+///     return scale(2.f, in, out, (cl_uint) n);
+/// });
+/// ```
+///
+/// @tparam T C++ type of the input elements
+/// @tparam U C++ type of the output elements
+template <typename T, typename U = T>
+class Pipeline {
+public:
+    /// Create a pipeline on the default context and device
+    ///
+    /// @param chunk_size Number of elements processed by one kernel launch
+    /// @param depth Number of chunks in flight
+    explicit Pipeline(size_t chunk_size, unsigned int depth = 2) :
+        Pipeline(Context::get_default(), Queue::get_default().device(), chunk_size, depth)
+    {
+    }
+
+    /// Create a pipeline
+    ///
+    /// @param context OpenCL context
+    /// @param device Device the pipeline runs on
+    /// @param chunk_size Number of elements processed by one kernel launch
+    /// @param depth Number of chunks in flight
+    Pipeline(const Context & context,
+             const Device & device,
+             size_t chunk_size,
+             unsigned int depth = 2) :
+        transfer_(context, device),
+        compute_(context, device),
+        chunk_size_(chunk_size)
+    {
+        if (chunk_size == 0)
+            throw Exception("Pipeline chunk size must be positive");
+        if (depth == 0)
+            throw Exception("Pipeline depth must be positive");
+        Range<1> rng { chunk_size };
+        this->slots_.reserve(depth);
+        for (unsigned int i = 0; i < depth; i++)
+            this->slots_.push_back({ Buffer<T>(context, rng, READ_ONLY),
+                                     Buffer<U>(context, rng, WRITE_ONLY),
+                                     Event(),
+                                     Event(),
+                                     Event() });
+    }
+
+    /// Number of elements processed by one kernel launch
+    size_t
+    chunk_size() const
+    {
+        return this->chunk_size_;
+    }
+
+    /// Number of chunks in flight
+    unsigned int
+    depth() const
+    {
+        return this->slots_.size();
+    }
+
+    /// Queue used for host-device transfers
+    const Queue &
+    transfer_queue() const
+    {
+        return this->transfer_;
+    }
+
+    /// Queue used for kernel execution
+    const Queue &
+    compute_queue() const
+    {
+        return this->compute_;
+    }
+
+    /// Stream host data through a kernel
+    ///
+    /// Blocks until all output was written into `output`.
+    ///
+    /// @param input Input data in host memory
+    /// @param output Output data in host memory
+    /// @param n Number of elements in `input` and `output`
+    /// @param kernel Callable taking `(const Buffer<T> & in, const Buffer<U> & out, size_t n)`
+    ///        that sets up the kernel for one chunk of `n` elements and returns it. The kernel is
+    ///        launched over a range of `n` work-items.
+    template <typename F>
+    void
+    run(const T * input, U * output, size_t n, F && kernel)
+    {
+        auto n_chunks = (n + this->chunk_size_ - 1) / this->chunk_size_;
+        std::size_t depth = this->slots_.size();
+        std::size_t lag = depth - 1;
+        for (auto & s : this->slots_)
+            s.write = s.compute = s.read = Event();
+
+        for (std::size_t k = 0; k < n_chunks + lag; k++) {
+            if (k < n_chunks) {
+                auto & s = this->slots_[k % depth];
+                auto ofs = k * this->chunk_size_;
+                auto cnt = std::min(this->chunk_size_, n - ofs);
+
+                // input buffer of this slot is free once the kernel from `depth` chunks ago is done
+                s.write = this->transfer_.enqueue_iwrite_raw(s.in,
+                                                             0,
+                                                             cnt * sizeof(T),
+                                                             input + ofs,
+                                                             s.compute);
+                // output buffer of this slot is free once its previous content was read back
+                WaitListStorage deps;
+                deps.push_back(s.read);
+                deps.push_back(s.write);
+                s.compute = this->compute_.enqueue_kernel(kernel(s.in, s.out, cnt),
+                                                          Range<1> { cnt },
+                                                          deps);
+                this->compute_.flush();
+            }
+            if (k >= lag) {
+                auto j = k - lag;
+                auto & s = this->slots_[j % depth];
+                auto ofs = j * this->chunk_size_;
+                auto cnt = std::min(this->chunk_size_, n - ofs);
+                s.read = this->transfer_.enqueue_iread_raw(s.out,
+                                                           0,
+                                                           cnt * sizeof(U),
+                                                           output + ofs,
+                                                           s.compute);
+            }
+            this->transfer_.flush();
+        }
+        this->compute_.wait();
+        this->transfer_.wait();
+    }
+
+private:
+    /// Device buffers and events of one chunk in flight
+    struct Slot {
+        /// Input buffer
+        Buffer<T> in;
+        /// Output buffer
+        Buffer<U> out;
+        /// Upload of the input
+        Event write;
+        /// Kernel execution
+        Event compute;
+        /// Download of the output
+        Event read;
+    };
+
+    /// Queue for host-device transfers
+    Queue transfer_;
+    /// Queue for kernel execution
+    Queue compute_;
+    /// Number of elements in one chunk
+    size_t chunk_size_;
+    /// Rotating slots
+    std::vector<Slot> slots_;
+};
+
+} // namespace openclcpp_lite
@@ -15,6 +15,9 @@ class Context;
 class Device;
 
 /// OpenCL program
+///
+/// Owns a reference to the underlying OpenCL program. Copies share the program and bump its
+/// reference count, the reference is released when the object is destroyed.
 class Program {
 public:
     enum class BuildStatus {
@@ -43,7 +46,18 @@ public:
     Program();
 
     /// Create a program from a OpenCL object
-    explicit Program(cl_program prg);
+    ///
+    /// @param prg OpenCL program
+    /// @param retain Increment the reference count of `prg`. By default, the new object takes over
+    ///        the reference held by the caller.
+    explicit Program(cl_program prg, bool retain = false);
+
+    Program(const Program & other);
+    Program(Program && other) noexcept;
+    ~Program();
+
+    Program & operator=(const Program & other);
+    Program & operator=(Program && other) noexcept;
 
     /// Increments the program reference count.
     void retain() const;
@@ -75,6 +89,10 @@ public:
     /// least one device in the list of devices associated with program.
     std::vector<std::string> kernel_names() const;
 
+    /// Return the program source code. The string is empty if the program was not created from
+    /// source.
+    std::string source() const;
+
     /// Returns an array that contains the size in bytes of the program binary
     std::vector<size_t> binary_sizes() const;
 
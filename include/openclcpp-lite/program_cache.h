@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/program.h"
+#include <string>
+#include <vector>
+#include <atomic>
+
+namespace openclcpp_lite {
+
+class Context;
+class Device;
+
+/// Persistent on-disk cache of program binaries
+///
+/// Programs are keyed by a hash of the source, the build options, the device name and the driver
+/// version, so a driver upgrade automatically invalidates old entries. Entries are written into a
+/// temporary file first and then atomically renamed, so several processes can share one cache
+/// directory. Entries that fail validation or that the driver refuses to load are rebuilt from
+/// source and overwritten.
+///
+/// Example:
+/// ```
+/// ProgramCache cache("/var/cache/my-app/opencl");
+/// auto prg = cache.build(ctx, src, { "-cl-fast-relaxed-math" });
+/// ```
+class ProgramCache {
+public:
+    /// Create a program cache
+    ///
+    /// @param directory Directory where the program binaries are stored. It is created if it does
+    ///        not exist.
+    explicit ProgramCache(const std::string & directory);
+
+    /// Return the directory where the program binaries are stored
+    const std::string & directory() const;
+
+    /// Create a program from source and build it for all devices in the default context
+    ///
+    /// @param source OpenCL source code
+    /// @param options Build options
+    /// @return Built program
+    Program build(const std::string & source,
+                  const std::vector<std::string> & options = std::vector<std::string>());
+
+    /// Create a program from source and build it for all devices in a context
+    ///
+    /// If all devices have a valid cache entry, the program is created from the cached binaries.
+    /// Otherwise, it is compiled from source and the resulting binaries are stored in the cache.
+    ///
+    /// @param context OpenCL context
+    /// @param source OpenCL source code
+    /// @param options Build options
+    /// @return Built program
+    Program build(const Context & context,
+                  const std::string & source,
+                  const std::vector<std::string> & options = std::vector<std::string>());
+
+    /// Compute the cache key of a program
+    ///
+    /// @param source OpenCL source code
+    /// @param options Build options
+    /// @param device Device the program is built for
+    /// @return Cache key
+    std::string key(const std::string & source,
+                    const std::vector<std::string> & options,
+                    const Device & device) const;
+
+    /// Number of programs that were created from cached binaries
+    unsigned int hits() const;
+
+    /// Number of programs that had to be compiled from source
+    unsigned int misses() const;
+
+    /// Remove all entries from the cache directory
+    void clear() const;
+
+private:
+    /// Build a description of the cache entry. It is stored in the entry and compared when the
+    /// entry is loaded to detect stale or colliding entries.
+    std::string descriptor(const std::string & source,
+                           const std::vector<std::string> & options,
+                           const Device & device) const;
+
+    /// Path to the file holding a cache entry
+    std::string entry_path(const std::string & key) const;
+
+    /// Load a cache entry
+    ///
+    /// @param path Path to the cache entry
+    /// @param descr Expected descriptor of the entry
+    /// @param binary Program binary stored in the entry
+    /// @return `true` if a valid entry was loaded, `false` otherwise
+    bool
+    load(const std::string & path, const std::string & descr, std::vector<char> & binary) const;
+
+    /// Atomically store a cache entry
+    ///
+    /// @param path Path to the cache entry
+    /// @param descr Descriptor of the entry
+    /// @param binary Program binary
+    void
+    store(const std::string & path,
+          const std::string & descr,
+          const std::vector<char> & binary) const;
+
+    /// Cache directory
+    std::string dir_;
+    /// Number of cache hits
+    std::atomic<unsigned int> hits_;
+    /// Number of cache misses
+    std::atomic<unsigned int> misses_;
+};
+
+} // namespace openclcpp_lite
@@ -8,28 +8,56 @@
 #include "openclcpp-lite/enums.h"
 #include "openclcpp-lite/error.h"
 #include "openclcpp-lite/event.h"
+#include "openclcpp-lite/exception.h"
+#include "openclcpp-lite/range.h"
 #include <mutex>
+#include <memory>
+#include <span>
+#include <functional>
+#include <atomic>
+#include <array>
+#include <concepts>
 
 namespace openclcpp_lite {
 
 class Context;
 class Device;
 class Kernel;
-template <int N>
-class Range;
 class Memory;
+class Image;
 template <typename T, int D>
 class Buffer;
 class Handler;
+class CommandGraph;
+class TuningDatabase;
+class StagingPool;
+template <typename T>
+class MappedView;
+
+/// How `Queue::get_default` hands out queues
+enum DefaultQueuePolicy {
+    /// All threads share one queue
+    SHARED,
+    /// Every thread gets its own queue
+    PER_THREAD
+};
 
 /// OpenCL command queue
+///
+/// Owns a reference to the underlying OpenCL command queue. Copies share the queue (including its
+/// dependency tracking) and bump its reference count, the reference is released when the object is
+/// destroyed.
 class Queue {
 public:
     /// Create a null queue
     Queue();
 
     /// Create a queue from a OpenCL command queue
-    explicit Queue(cl_command_queue q);
+    ///
+    /// @param q OpenCL command queue
+    /// @param retain Increment the reference count of `q`. By default, the new object takes over
+    ///        the reference held by the caller.
+    explicit Queue(cl_command_queue q, bool retain = false);
 
     /// Create a queue in a Context
     ///
@@ -44,6 +72,38 @@ public:
     /// @param enable_profiling Enable profiling
     Queue(const Context & context, const Device & device, bool enable_profiling = false);
 
+    /// Create a queue in a Context
+    ///
+    /// If `OUT_OF_ORDER_EXEC_MODE_ENABLE` is set, the queue keeps track of the memory objects each
+    /// command reads and writes and automatically makes every command wait for the commands it
+    /// depends on (read-after-write, write-after-read and write-after-write). Independent commands
+    /// are free to overlap on the device.
+    ///
+    /// Such a queue (and its copies, which share the tracking) must be driven by one thread at a
+    /// time. Looking up the dependencies of a command, enqueueing it and recording it are not one
+    /// atomic step, so commands enqueued concurrently from several threads can miss dependencies on
+    /// each other. Give every thread its own queue instead (see `QueuePool`).
+    ///
+    /// @param context OpenCL context of the queue
+    /// @param properties Queue properties
+    Queue(const Context & context, QueueProperties properties);
+    Queue(const Context & context, QueueProperty property);
+
+    /// Create a queue in a Context
+    ///
+    /// @param context OpenCL context of the queue
+    /// @param device OpenCL device of the queue
+    /// @param properties Queue properties
+    Queue(const Context & context, const Device & device, QueueProperties properties);
+    Queue(const Context & context, const Device & device, QueueProperty property);
+
+    Queue(const Queue & other);
+    Queue(Queue && other) noexcept;
+    ~Queue();
+
+    Queue & operator=(const Queue & other);
+    Queue & operator=(Queue && other) noexcept;
+
     /// Increments the command_queue reference count
     void retain() const;
 
@@ -62,159 +122,677 @@ public:
     /// general use in applications. This feature is provided for identifying memory leaks.
     unsigned int reference_count() const;
 
+    /// Return the properties specified when the command-queue was created.
+    QueueProperties properties() const;
+
+    /// Check if the commands in the queue can execute out of order
+    bool out_of_order() const;
+
     /// Enqueues a command to copy from one buffer object to another.
     ///
+    /// If either buffer has padded rows, `range` is copied as a rectangular region.
+    ///
     /// @param src Source buffer
     /// @param dest Destination buffer
     /// @param range Range.
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
     /// @return Event object that identifies this particular operation
-    template <typename T, int D>
-    Event
-    copy(const Buffer<T, D> & src, const Buffer<T, D> & dest, const Range<D> & range) const
-    {
-        assert(src.byte_size() == dest.byte_size());
-        return enqueue_copy_raw(src, dest, 0 * sizeof(T), 0 * sizeof(T), range.size() * sizeof(T));
-    }
-
     template <typename T, int D>
     Event
     copy(const Buffer<T, D> & src,
          const Buffer<T, D> & dest,
          const Range<D> & range,
-         Event dep_event) const
+         WaitList wait_list = WaitList()) const
     {
+        if (src.padded() || dest.padded())
+            return copy_rect(src, Range<D>(), dest, Range<D>(), range, wait_list);
         assert(src.byte_size() == dest.byte_size());
         return enqueue_copy_raw(src,
                                 dest,
                                 0 * sizeof(T),
                                 0 * sizeof(T),
                                 range.size() * sizeof(T),
-                                { dep_event });
+                                wait_list);
     }
 
-    template <typename T, int D>
-    Event
-    copy(const Buffer<T, D> & src,
-         const Buffer<T, D> & dest,
-         const Range<D> & range,
-         const std::vector<Event> & dep_events) const
-    {
-        assert(src.byte_size() == dest.byte_size());
-        return enqueue_copy_raw(src,
-                                dest,
-                                0 * sizeof(T),
-                                0 * sizeof(T),
-                                range.size() * sizeof(T),
-                                dep_events);
-    }
-
-    /// Enqueue commands to write to a buffer object from host memory in blocking mode
+    /// Enqueue commands to write to a buffer object from host memory in non-blocking mode
+    ///
+    /// If `dest` has padded rows, tightly packed host memory of shape `range` is written as a
+    /// rectangular region.
     ///
     /// @param src The pointer to buffer in host memory where data is to be written from.
     /// @param dest Buffer to write into
     /// @param range Range.
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular write command
     template <typename T, int D>
     Event
-    copy(const void * src, const Buffer<T, D> & dest, const Range<D> & range) const
+    copy(const void * src,
+         const Buffer<T, D> & dest,
+         const Range<D> & range,
+         WaitList wait_list = WaitList()) const
     {
-        return enqueue_iwrite_raw(dest, 0 * sizeof(T), range.size() * sizeof(T), src);
+        if (dest.padded())
+            return copy_rect(static_cast<const T *>(src),
+                             range,
+                             Range<D>(),
+                             dest,
+                             Range<D>(),
+                             range,
+                             wait_list);
+        return enqueue_iwrite_raw(dest, 0 * sizeof(T), range.size() * sizeof(T), src, wait_list);
     }
 
+    /// Enqueue commands to read from a buffer object to host memory in non-blocking mode
+    ///
+    /// If `src` has padded rows, `range` is read as a rectangular region into tightly packed host
+    /// memory.
+    ///
+    /// @param src Buffer to read from
+    /// @param dest The pointer to buffer in host memory where data is to be read into.
+    /// @param range Range.
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular read command
     template <typename T, int D>
     Event
-    copy(const void * src, const Buffer<T, D> & dest, const Range<D> & range, Event dep_event) const
+    copy(const Buffer<T, D> & src,
+         void * dest,
+         const Range<D> & range,
+         WaitList wait_list = WaitList()) const
     {
-        return enqueue_iwrite_raw(dest,
-                                  0 * sizeof(T),
-                                  range.size() * sizeof(T),
-                                  src,
-                                  { dep_event });
+        if (src.padded())
+            return copy_rect(src,
+                             Range<D>(),
+                             static_cast<T *>(dest),
+                             range,
+                             Range<D>(),
+                             range,
+                             wait_list);
+        return enqueue_iread_raw(src, 0 * sizeof(T), range.size() * sizeof(T), dest, wait_list);
     }
 
-    template <typename T, int D>
+    /// Enqueues a command to fill a buffer object with a pattern
+    ///
+    /// Buffers with padded rows are filled including the padding, so `range` must span whole rows.
+    ///
+    /// @tparam T C++ type of the buffer being filled
+    /// @tparam U C++ type of the pattern
+    /// @tparam D Range dimension
+    /// @param buffer Buffer being filled
+    /// @param pattern Pattern to fill the buffer with
+    /// @param range Range
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular write command
+    template <typename T, typename U, int D>
     Event
-    copy(const void * src,
-         const Buffer<T, D> & dest,
+    fill(const Buffer<T, D> & buffer,
+         const U & pattern,
          const Range<D> & range,
-         const std::vector<Event> & dep_events) const
+         WaitList wait_list = WaitList()) const
     {
-        return enqueue_iwrite_raw(dest, 0 * sizeof(T), range.size() * sizeof(T), src, dep_events);
+        if (buffer.padded()) {
+            static_assert(sizeof(T) % sizeof(U) == 0,
+                          "Pattern must evenly divide the buffer element");
+            assert(range.size(0) == buffer.range().size(0));
+            return enqueue_fill_buffer_raw(buffer,
+                                           &pattern,
+                                           sizeof(U),
+                                           0,
+                                           range.size() / range.size(0) * buffer.row_pitch(),
+                                           wait_list);
+        }
+        return enqueue_fill_buffer_raw(buffer,
+                                       &pattern,
+                                       sizeof(U),
+                                       0,
+                                       range.size() * sizeof(U),
+                                       wait_list);
     }
 
-    /// Enqueue commands to read from a buffer object to host memory in non-blocking mode
+    /// Enqueues a command to copy a window of elements from one buffer object to another
     ///
-    /// @param src Buffer to read from
-    /// @param dest The pointer to buffer in host memory where data is to be read into.
-    /// @param range Range.
-    /// @return Event object that identifies this particular kernel execution instance
+    /// Windows are contiguous runs of elements in the flattened buffers. For sub-blocks of
+    /// multi-dimensional buffers use `copy_rect`.
+    ///
+    /// @param src Source buffer
+    /// @param dest Destination buffer
+    /// @param src_origin Index of the first element copied from `src`
+    /// @param dest_origin Index of the first element copied into `dest`
+    /// @param extent Number of elements to copy
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular operation
     template <typename T, int D>
     Event
-    copy(const Buffer<T, D> & src, void * dest, const Range<D> & range) const
+    copy(const Buffer<T, D> & src,
+         const Buffer<T, D> & dest,
+         const Range<1> & src_origin,
+         const Range<1> & dest_origin,
+         const Range<1> & extent,
+         WaitList wait_list = WaitList()) const
     {
-        return enqueue_iread_raw(src, 0 * sizeof(T), range.size() * sizeof(T), dest);
+        assert((src_origin.size(0) + extent.size()) * sizeof(T) <= src.byte_size());
+        assert((dest_origin.size(0) + extent.size()) * sizeof(T) <= dest.byte_size());
+        return enqueue_copy_raw(src,
+                                dest,
+                                src_origin.size(0) * sizeof(T),
+                                dest_origin.size(0) * sizeof(T),
+                                extent.size() * sizeof(T),
+                                wait_list);
     }
 
+    /// Enqueue commands to write a window of elements from host memory into a buffer object in
+    /// non-blocking mode
+    ///
+    /// `src` must stay valid until the returned event completes.
+    ///
+    /// @param src Host memory holding the `extent` elements to write
+    /// @param dest Buffer to write into
+    /// @param origin Index of the first element written in `dest`
+    /// @param extent Number of elements to write
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular write command
     template <typename T, int D>
     Event
-    copy(const Buffer<T, D> & src, void * dest, const Range<D> & range, Event dep_event) const
+    copy(const void * src,
+         const Buffer<T, D> & dest,
+         const Range<1> & origin,
+         const Range<1> & extent,
+         WaitList wait_list = WaitList()) const
     {
-        return enqueue_iread_raw(src, 0 * sizeof(T), range.size() * sizeof(T), dest, { dep_event });
+        assert((origin.size(0) + extent.size()) * sizeof(T) <= dest.byte_size());
+        return enqueue_iwrite_raw(dest,
+                                  origin.size(0) * sizeof(T),
+                                  extent.size() * sizeof(T),
+                                  src,
+                                  wait_list);
     }
 
+    /// Enqueue commands to read a window of elements from a buffer object into host memory in
+    /// non-blocking mode
+    ///
+    /// `dest` must stay valid until the returned event completes.
+    ///
+    /// @param src Buffer to read from
+    /// @param dest Host memory receiving the `extent` elements
+    /// @param origin Index of the first element read from `src`
+    /// @param extent Number of elements to read
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular read command
     template <typename T, int D>
     Event
     copy(const Buffer<T, D> & src,
          void * dest,
-         const Range<D> & range,
-         const std::vector<Event> & dep_events) const
+         const Range<1> & origin,
+         const Range<1> & extent,
+         WaitList wait_list = WaitList()) const
     {
-        return enqueue_iread_raw(src, 0 * sizeof(T), range.size() * sizeof(T), dest, dep_events);
+        assert((origin.size(0) + extent.size()) * sizeof(T) <= src.byte_size());
+        return enqueue_iread_raw(src,
+                                 origin.size(0) * sizeof(T),
+                                 extent.size() * sizeof(T),
+                                 dest,
+                                 wait_list);
     }
 
-    /// Enqueues a command to fill a buffer object with a pattern
+    /// Enqueues a command to fill a window of elements of a buffer object with a pattern
+    ///
+    /// The size of `T` must be a multiple of the size of `U`.
     ///
     /// @tparam T C++ type of the buffer being filled
     /// @tparam U C++ type of the pattern
     /// @tparam D Range dimension
     /// @param buffer Buffer being filled
     /// @param pattern Pattern to fill the buffer with
-    /// @param range Range
+    /// @param origin Index of the first element filled
+    /// @param extent Number of elements to fill
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
     /// @return Event object that identifies this particular write command
-    template <typename T, typename U, int D>
-    Event
-    fill(const Buffer<T, D> & buffer, const U & pattern, const Range<D> & range) const
-    {
-        return enqueue_fill_buffer_raw(buffer, &pattern, sizeof(U), 0, range.size() * sizeof(U));
-    }
-
     template <typename T, typename U, int D>
     Event
     fill(const Buffer<T, D> & buffer,
          const U & pattern,
-         const Range<D> & range,
-         Event dep_event) const
+         const Range<1> & origin,
+         const Range<1> & extent,
+         WaitList wait_list = WaitList()) const
     {
+        static_assert(sizeof(T) % sizeof(U) == 0, "Pattern must evenly divide the buffer element");
+        assert((origin.size(0) + extent.size()) * sizeof(T) <= buffer.byte_size());
         return enqueue_fill_buffer_raw(buffer,
                                        &pattern,
                                        sizeof(U),
-                                       0,
-                                       range.size() * sizeof(U),
-                                       { dep_event });
+                                       origin.size(0) * sizeof(T),
+                                       extent.size() * sizeof(T),
+                                       wait_list);
     }
 
-    template <typename T, typename U, int D>
+    /// Enqueues a command to copy a rectangular region from one buffer object to another
+    ///
+    /// Buffers are treated as row-major `D`-dimensional arrays of the given shape (the first
+    /// dimension is the fastest varying one). Origins and region are in elements.
+    ///
+    /// @param src Source buffer
+    /// @param src_shape Shape of the source buffer
+    /// @param src_origin Position of the region in the source buffer
+    /// @param dest Destination buffer
+    /// @param dest_shape Shape of the destination buffer
+    /// @param dest_origin Position of the region in the destination buffer
+    /// @param region Size of the region being copied
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular operation
+    template <typename T, int D>
     Event
-    fill(const Buffer<T, D> & buffer,
-         const U & pattern,
-         const Range<D> & range,
-         const std::vector<Event> & dep_events) const
+    copy_rect(const Buffer<T, D> & src,
+              const Range<D> & src_shape,
+              const Range<D> & src_origin,
+              const Buffer<T, D> & dest,
+              const Range<D> & dest_shape,
+              const Range<D> & dest_origin,
+              const Range<D> & region,
+              WaitList wait_list = WaitList()) const
     {
-        return enqueue_fill_buffer_raw(buffer,
-                                       &pattern,
-                                       sizeof(U),
-                                       0,
-                                       range.size() * sizeof(U),
-                                       dep_events);
+        assert(src_shape.size() * sizeof(T) <= src.byte_size());
+        assert(dest_shape.size() * sizeof(T) <= dest.byte_size());
+        auto src_ofs = rect_3d(src_origin, sizeof(T), 0);
+        auto dest_ofs = rect_3d(dest_origin, sizeof(T), 0);
+        auto rgn = rect_3d(region, sizeof(T), 1);
+        return enqueue_copy_rect_raw(src,
+                                     dest,
+                                     src_ofs.data(),
+                                     dest_ofs.data(),
+                                     rgn.data(),
+                                     row_pitch(src_shape, sizeof(T)),
+                                     slice_pitch(src_shape, sizeof(T)),
+                                     row_pitch(dest_shape, sizeof(T)),
+                                     slice_pitch(dest_shape, sizeof(T)),
+                                     wait_list);
+    }
+
+    /// Enqueue commands to write a rectangular region from host memory into a buffer object in
+    /// non-blocking mode
+    ///
+    /// Host memory and buffer are treated as row-major `D`-dimensional arrays of the given shape
+    /// (the first dimension is the fastest varying one). Origins and region are in elements.
+    /// `src` must stay valid until the returned event completes.
+    ///
+    /// @param src Host memory to write from
+    /// @param src_shape Shape of the host array
+    /// @param src_origin Position of the region in the host array
+    /// @param dest Buffer to write into
+    /// @param dest_shape Shape of the buffer
+    /// @param dest_origin Position of the region in the buffer
+    /// @param region Size of the region being written
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular write command
+    template <typename T, int D>
+    Event
+    copy_rect(const T * src,
+              const Range<D> & src_shape,
+              const Range<D> & src_origin,
+              const Buffer<T, D> & dest,
+              const Range<D> & dest_shape,
+              const Range<D> & dest_origin,
+              const Range<D> & region,
+              WaitList wait_list = WaitList()) const
+    {
+        assert(dest_shape.size() * sizeof(T) <= dest.byte_size());
+        auto buffer_ofs = rect_3d(dest_origin, sizeof(T), 0);
+        auto host_ofs = rect_3d(src_origin, sizeof(T), 0);
+        auto rgn = rect_3d(region, sizeof(T), 1);
+        return enqueue_iwrite_rect_raw(dest,
+                                       buffer_ofs.data(),
+                                       host_ofs.data(),
+                                       rgn.data(),
+                                       row_pitch(dest_shape, sizeof(T)),
+                                       slice_pitch(dest_shape, sizeof(T)),
+                                       row_pitch(src_shape, sizeof(T)),
+                                       slice_pitch(src_shape, sizeof(T)),
+                                       src,
+                                       wait_list);
+    }
+
+    /// Enqueue commands to read a rectangular region from a buffer object into host memory in
+    /// non-blocking mode
+    ///
+    /// Buffer and host memory are treated as row-major `D`-dimensional arrays of the given shape
+    /// (the first dimension is the fastest varying one). Origins and region are in elements.
+    /// `dest` must stay valid until the returned event completes.
+    ///
+    /// @param src Buffer to read from
+    /// @param src_shape Shape of the buffer
+    /// @param src_origin Position of the region in the buffer
+    /// @param dest Host memory to read into
+    /// @param dest_shape Shape of the host array
+    /// @param dest_origin Position of the region in the host array
+    /// @param region Size of the region being read
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular read command
+    template <typename T, int D>
+    Event
+    copy_rect(const Buffer<T, D> & src,
+              const Range<D> & src_shape,
+              const Range<D> & src_origin,
+              T * dest,
+              const Range<D> & dest_shape,
+              const Range<D> & dest_origin,
+              const Range<D> & region,
+              WaitList wait_list = WaitList()) const
+    {
+        assert(src_shape.size() * sizeof(T) <= src.byte_size());
+        auto buffer_ofs = rect_3d(src_origin, sizeof(T), 0);
+        auto host_ofs = rect_3d(dest_origin, sizeof(T), 0);
+        auto rgn = rect_3d(region, sizeof(T), 1);
+        return enqueue_iread_rect_raw(src,
+                                      buffer_ofs.data(),
+                                      host_ofs.data(),
+                                      rgn.data(),
+                                      row_pitch(src_shape, sizeof(T)),
+                                      slice_pitch(src_shape, sizeof(T)),
+                                      row_pitch(dest_shape, sizeof(T)),
+                                      slice_pitch(dest_shape, sizeof(T)),
+                                      dest,
+                                      wait_list);
+    }
+
+    /// Enqueues a command to copy a rectangular region from one buffer object to another using
+    /// the shapes and row pitches of the buffers
+    ///
+    /// Origins and region are in elements.
+    ///
+    /// @param src Source buffer
+    /// @param src_origin Position of the region in the source buffer
+    /// @param dest Destination buffer
+    /// @param dest_origin Position of the region in the destination buffer
+    /// @param region Size of the region being copied
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular operation
+    template <typename T, int D>
+    Event
+    copy_rect(const Buffer<T, D> & src,
+              const Range<D> & src_origin,
+              const Buffer<T, D> & dest,
+              const Range<D> & dest_origin,
+              const Range<D> & region,
+              WaitList wait_list = WaitList()) const
+    {
+        auto src_ofs = rect_3d(src_origin, sizeof(T), 0);
+        auto dest_ofs = rect_3d(dest_origin, sizeof(T), 0);
+        auto rgn = rect_3d(region, sizeof(T), 1);
+        return enqueue_copy_rect_raw(src,
+                                     dest,
+                                     src_ofs.data(),
+                                     dest_ofs.data(),
+                                     rgn.data(),
+                                     src.row_pitch(),
+                                     src.slice_pitch(),
+                                     dest.row_pitch(),
+                                     dest.slice_pitch(),
+                                     wait_list);
+    }
+
+    /// Enqueue commands to write a rectangular region from host memory into a buffer object using
+    /// the shape and row pitch of the buffer in non-blocking mode
+    ///
+    /// Host memory is treated as a tightly packed row-major `D`-dimensional array of the given
+    /// shape. Origins and region are in elements. `src` must stay valid until the returned event
+    /// completes.
+    ///
+    /// @param src Host memory to write from
+    /// @param src_shape Shape of the host array
+    /// @param src_origin Position of the region in the host array
+    /// @param dest Buffer to write into
+    /// @param dest_origin Position of the region in the buffer
+    /// @param region Size of the region being written
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular write command
+    template <typename T, int D>
+    Event
+    copy_rect(const T * src,
+              const Range<D> & src_shape,
+              const Range<D> & src_origin,
+              const Buffer<T, D> & dest,
+              const Range<D> & dest_origin,
+              const Range<D> & region,
+              WaitList wait_list = WaitList()) const
+    {
+        auto buffer_ofs = rect_3d(dest_origin, sizeof(T), 0);
+        auto host_ofs = rect_3d(src_origin, sizeof(T), 0);
+        auto rgn = rect_3d(region, sizeof(T), 1);
+        return enqueue_iwrite_rect_raw(dest,
+                                       buffer_ofs.data(),
+                                       host_ofs.data(),
+                                       rgn.data(),
+                                       dest.row_pitch(),
+                                       dest.slice_pitch(),
+                                       row_pitch(src_shape, sizeof(T)),
+                                       slice_pitch(src_shape, sizeof(T)),
+                                       src,
+                                       wait_list);
+    }
+
+    /// Enqueue commands to read a rectangular region from a buffer object into host memory using
+    /// the shape and row pitch of the buffer in non-blocking mode
+    ///
+    /// Host memory is treated as a tightly packed row-major `D`-dimensional array of the given
+    /// shape. Origins and region are in elements. `dest` must stay valid until the returned event
+    /// completes.
+    ///
+    /// @param src Buffer to read from
+    /// @param src_origin Position of the region in the buffer
+    /// @param dest Host memory to read into
+    /// @param dest_shape Shape of the host array
+    /// @param dest_origin Position of the region in the host array
+    /// @param region Size of the region being read
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular read command
+    template <typename T, int D>
+    Event
+    copy_rect(const Buffer<T, D> & src,
+              const Range<D> & src_origin,
+              T * dest,
+              const Range<D> & dest_shape,
+              const Range<D> & dest_origin,
+              const Range<D> & region,
+              WaitList wait_list = WaitList()) const
+    {
+        auto buffer_ofs = rect_3d(src_origin, sizeof(T), 0);
+        auto host_ofs = rect_3d(dest_origin, sizeof(T), 0);
+        auto rgn = rect_3d(region, sizeof(T), 1);
+        return enqueue_iread_rect_raw(src,
+                                      buffer_ofs.data(),
+                                      host_ofs.data(),
+                                      rgn.data(),
+                                      src.row_pitch(),
+                                      src.slice_pitch(),
+                                      row_pitch(dest_shape, sizeof(T)),
+                                      slice_pitch(dest_shape, sizeof(T)),
+                                      dest,
+                                      wait_list);
+    }
+
+    /// Enqueues a command to write host memory into an image in non-blocking mode
+    ///
+    /// @tparam I Image type (`Image2D`, `Image3D` or `Image2DArray`)
+    /// @param src Host memory with `dest.width() * dest.height() * ...` tightly packed pixels
+    /// @param dest Image being written
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular write command
+    template <typename I>
+        requires std::derived_from<I, Image>
+    Event
+    copy(const typename I::type * src, const I & dest, WaitList wait_list = WaitList()) const
+    {
+        std::array<size_t, 3> origin = { 0, 0, 0 };
+        return enqueue_iwrite_image_raw(dest, origin.data(), dest.region().data(), src, wait_list);
+    }
+
+    /// Enqueues a command to write host memory into a region of an image in non-blocking mode
+    ///
+    /// @tparam I Image type (`Image2D`, `Image3D` or `Image2DArray`)
+    /// @param src Host memory with the tightly packed pixels of the region
+    /// @param dest Image being written
+    /// @param origin (x, y, z) of the region in pixels, z is 0 for 2D images and the image index
+    ///        for image arrays
+    /// @param region (width, height, depth) of the region in pixels, depth is 1 for 2D images and
+    ///        the number of images for image arrays
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular write command
+    template <typename I>
+        requires std::derived_from<I, Image>
+    Event
+    copy(const typename I::type * src,
+         const I & dest,
+         const Range<3> & origin,
+         const Range<3> & region,
+         WaitList wait_list = WaitList()) const
+    {
+        return enqueue_iwrite_image_raw(dest, origin, region, src, wait_list);
+    }
+
+    /// Enqueues a command to read an image into host memory in non-blocking mode
+    ///
+    /// @tparam I Image type (`Image2D`, `Image3D` or `Image2DArray`)
+    /// @param src Image being read
+    /// @param dest Host memory for the tightly packed pixels of the image
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular read command
+    template <typename I>
+        requires std::derived_from<I, Image>
+    Event
+    copy(const I & src, typename I::type * dest, WaitList wait_list = WaitList()) const
+    {
+        std::array<size_t, 3> origin = { 0, 0, 0 };
+        return enqueue_iread_image_raw(src, origin.data(), src.region().data(), dest, wait_list);
+    }
+
+    /// Enqueues a command to read a region of an image into host memory in non-blocking mode
+    ///
+    /// @tparam I Image type (`Image2D`, `Image3D` or `Image2DArray`)
+    /// @param src Image being read
+    /// @param dest Host memory for the tightly packed pixels of the region
+    /// @param origin (x, y, z) of the region in pixels, see above
+    /// @param region (width, height, depth) of the region in pixels, see above
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular read command
+    template <typename I>
+        requires std::derived_from<I, Image>
+    Event
+    copy(const I & src,
+         typename I::type * dest,
+         const Range<3> & origin,
+         const Range<3> & region,
+         WaitList wait_list = WaitList()) const
+    {
+        return enqueue_iread_image_raw(src, origin, region, dest, wait_list);
+    }
+
+    /// Enqueues a command to copy an image into another image of the same size and format
+    ///
+    /// @tparam I Image type (`Image2D`, `Image3D` or `Image2DArray`)
+    /// @param src Source image
+    /// @param dest Destination image
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular copy command
+    template <typename I>
+        requires std::derived_from<I, Image>
+    Event
+    copy(const I & src, const I & dest, WaitList wait_list = WaitList()) const
+    {
+        std::array<size_t, 3> origin = { 0, 0, 0 };
+        return enqueue_copy_image_raw(src,
+                                      dest,
+                                      origin.data(),
+                                      origin.data(),
+                                      src.region().data(),
+                                      wait_list);
+    }
+
+    /// Enqueues a command to copy a region of an image into another image of the same format
+    ///
+    /// @tparam I Image type (`Image2D`, `Image3D` or `Image2DArray`)
+    /// @param src Source image
+    /// @param dest Destination image
+    /// @param src_origin (x, y, z) of the region in `src` in pixels, see above
+    /// @param dest_origin (x, y, z) of the region in `dest` in pixels, see above
+    /// @param region (width, height, depth) of the region in pixels, see above
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular copy command
+    template <typename I>
+        requires std::derived_from<I, Image>
+    Event
+    copy(const I & src,
+         const I & dest,
+         const Range<3> & src_origin,
+         const Range<3> & dest_origin,
+         const Range<3> & region,
+         WaitList wait_list = WaitList()) const
+    {
+        return enqueue_copy_image_raw(src, dest, src_origin, dest_origin, region, wait_list);
+    }
+
+    /// Enqueues a command to fill an image with a color
+    ///
+    /// @tparam I Image type (`Image2D`, `Image3D` or `Image2DArray`)
+    /// @tparam C Color type: `cl_float4` for images with floating-point or normalized channels,
+    ///         `cl_int4` for signed and `cl_uint4` for unsigned integer channels. Channels missing
+    ///         from the image format are ignored.
+    /// @param image Image being filled
+    /// @param color Fill color
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular fill command
+    template <typename I, typename C>
+        requires std::derived_from<I, Image>
+    Event
+    fill(const I & image, const C & color, WaitList wait_list = WaitList()) const
+    {
+        std::array<size_t, 3> origin = { 0, 0, 0 };
+        return fill(image, color, Range<3>(origin), Range<3>(image.region()), wait_list);
+    }
+
+    /// Enqueues a command to fill a region of an image with a color
+    ///
+    /// @tparam I Image type (`Image2D`, `Image3D` or `Image2DArray`)
+    /// @tparam C Color type, see above
+    /// @param image Image being filled
+    /// @param color Fill color
+    /// @param origin (x, y, z) of the region in pixels, see above
+    /// @param region (width, height, depth) of the region in pixels, see above
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular fill command
+    template <typename I, typename C>
+        requires std::derived_from<I, Image>
+    Event
+    fill(const I & image,
+         const C & color,
+         const Range<3> & origin,
+         const Range<3> & region,
+         WaitList wait_list = WaitList()) const
+    {
+        static_assert(std::is_same_v<C, cl_float4> || std::is_same_v<C, cl_int4> ||
+                          std::is_same_v<C, cl_uint4>,
+                      "Image fill color must be cl_float4, cl_int4 or cl_uint4");
+        return enqueue_fill_image_raw(image, &color, origin, region, wait_list);
     }
 
     /// Enqueues a command to map a region of the buffer object given by `buffer` into the host
@@ -248,6 +826,31 @@ public:
                                                        range.size() * sizeof(T)));
     }
 
+    /// Enqueues a command to map a window of elements of the buffer object given by `buffer` into
+    /// the host address space and returns a pointer to this mapped region.
+    ///
+    /// @param buffer Buffer to map
+    /// @param blocking Indicates if the map operation is blocking or non-blocking.
+    /// @param flags Map flags, see above
+    /// @param origin Index of the first mapped element
+    /// @param extent Number of mapped elements
+    /// @return Pointer to the element at `origin`. Only `extent` elements can be accessed.
+    template <typename T, int D>
+    T *
+    enqueue_map_buffer(const Buffer<T, D> & buffer,
+                       bool blocking,
+                       MapFlags flags,
+                       const Range<1> & origin,
+                       const Range<1> & extent) const
+    {
+        assert((origin.size(0) + extent.size()) * sizeof(T) <= buffer.byte_size());
+        return static_cast<T *>(enqueue_map_buffer_raw(buffer,
+                                                       blocking,
+                                                       flags,
+                                                       origin.size(0) * sizeof(T),
+                                                       extent.size() * sizeof(T)));
+    }
+
     /// Enqueues a command to unmap a previously mapped region of a memory object
     ///
     /// @param mem Memory object to unmap
@@ -255,15 +858,134 @@ public:
     /// @return Event object that identifies this particular operation
     Event enqueue_unmap_mem_object(const Memory & mem, void * mapped_ptr) const;
 
-    template <typename F>
+    /// Map a buffer into the host address space
+    ///
+    /// @param buffer Buffer to map
+    /// @param flags Map flags, see `enqueue_map_buffer`
+    /// @param blocking If `false`, the map is enqueued and the view can be accessed only after its
+    ///        event has completed
+    /// @return View of all elements of the buffer, unmapped when destroyed
+    template <typename T, int D>
+    MappedView<T>
+    map(const Buffer<T, D> & buffer, MapFlags flags, bool blocking = true) const
+    {
+        Range<1> n_elems { buffer.byte_size() / sizeof(T) };
+        return map(buffer, flags, Range<1> { 0 }, n_elems, blocking);
+    }
+
+    /// Map a window of elements of a buffer into the host address space
+    ///
+    /// Only the window is mapped, so an implementation that has to copy the data transfers just
+    /// the elements that are accessed.
+    ///
+    /// @param buffer Buffer to map
+    /// @param flags Map flags, see `enqueue_map_buffer`
+    /// @param origin Index of the first mapped element
+    /// @param extent Number of mapped elements
+    /// @param blocking If `false`, the map is enqueued and the view can be accessed only after its
+    ///        event has completed
+    /// @return View of the window, unmapped when destroyed
+    template <typename T, int D>
+    MappedView<T>
+    map(const Buffer<T, D> & buffer,
+        MapFlags flags,
+        const Range<1> & origin,
+        const Range<1> & extent,
+        bool blocking = true) const
+    {
+        assert((origin.size(0) + extent.size()) * sizeof(T) <= buffer.byte_size());
+        Event evt;
+        auto * ptr = enqueue_map_buffer_raw(buffer,
+                                            blocking,
+                                            flags,
+                                            origin.size(0) * sizeof(T),
+                                            extent.size() * sizeof(T),
+                                            evt);
+        return MappedView<T>(*this, buffer, static_cast<T *>(ptr), extent.size(), std::move(evt));
+    }
+
+#ifdef CL_VERSION_2_0
+    /// Map coarse-grained shared virtual memory for access by the host
+    ///
+    /// SVM commands are not tracked per allocation, so in an out-of-order queue they depend on
+    /// (and are a dependency of) all other commands.
+    ///
+    /// @param ptr First mapped element, must point into memory from an `SVMAllocator`
+    /// @param n Number of mapped elements
+    /// @param flags Map flags, see `enqueue_map_buffer`
+    /// @param blocking If `false`, the host can access the memory only after the returned event
+    ///        has completed
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular map command
+    template <typename T>
     Event
-    submit(F && f)
+    svm_map(T * ptr,
+            size_t n,
+            MapFlags flags,
+            bool blocking = true,
+            WaitList wait_list = WaitList()) const
     {
-        Handler h(*this);
-        f(h);
-        return enqueue_marker();
+        return enqueue_svm_map_raw(ptr, n * sizeof(T), flags, blocking, wait_list);
     }
 
+    /// Unmap shared virtual memory previously mapped with `svm_map`, so devices can access it
+    ///
+    /// @param ptr Pointer passed into `svm_map`
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular unmap command
+    Event svm_unmap(void * ptr, WaitList wait_list = WaitList()) const;
+#endif
+
+    /// Migrate memory objects to the device of this queue (or to the host)
+    ///
+    /// Moves the memory objects ahead of the commands that use them, so the transfer happens at a
+    /// known point and can overlap with other work instead of delaying the first kernel that
+    /// accesses them on the device. In out-of-order queues, the migration is ordered like a
+    /// command writing the memory objects.
+    ///
+    /// @param mems Memory objects to migrate
+    /// @param flags `MIGRATE_TO_HOST` to migrate to the host, `MIGRATE_CONTENT_UNDEFINED` for
+    ///        memory objects that are overwritten before they are read. Without flags, the
+    ///        memory objects move to the device of the queue with their content.
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular migration command
+    Event migrate(std::span<const cl_mem> mems,
+                  MigrationFlags flags = Flags<MigrationFlag>(),
+                  WaitList wait_list = WaitList()) const;
+
+    /// Migrate a memory object to the device of this queue (or to the host)
+    ///
+    /// @param mem Memory object to migrate
+    /// @param flags Migration flags
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular migration command
+    Event migrate(const Memory & mem,
+                  MigrationFlags flags = Flags<MigrationFlag>(),
+                  WaitList wait_list = WaitList()) const;
+
+    /// Submit a group of commands
+    ///
+    /// The commands are enqueued through a `Handler` passed into `f`. The queue is flushed after
+    /// the group is enqueued, so the commands start executing without the host waiting for them.
+    ///
+    /// @param f Callable taking a `Handler &` that enqueues the commands
+    /// @return Event that completes when all commands in the group have completed
+    template <typename F>
+    Event submit(F && f);
+
+    /// Record a group of commands into a graph that can be replayed later
+    ///
+    /// Commands issued through the `Handler` passed into `f` are recorded and not executed.
+    /// Kernel arguments set while `f` runs are captured together with the commands.
+    ///
+    /// @param f Callable taking a `Handler &` that issues the commands
+    /// @return Recorded command graph
+    CommandGraph record(const std::function<void(Handler &)> & f);
+
     /// Issues all previously queued OpenCL commands in a command-queue to the device associated
     /// with the command-queue.
     void flush() const;
@@ -272,12 +994,98 @@ public:
     /// associated device and have completed.
     void wait() const;
 
+    /// Set the database of tuned work-group sizes
+    ///
+    /// Kernels launched over a `Range` (i.e. without an explicit local range) use the tuned
+    /// local size if the database has a valid entry for them. The database is only read from.
+    /// The setting applies to this queue object and copies made from it afterwards.
+    ///
+    /// @param db Tuning database, `nullptr` to stop consulting a database
+    void set_tuning_database(std::shared_ptr<TuningDatabase> db);
+
+    /// Get the database of tuned work-group sizes
+    std::shared_ptr<TuningDatabase> tuning_database() const;
+
+    /// Set the pool of pinned host memory used to stage transfers
+    ///
+    /// Writes and blocking reads between host memory and buffers of at least
+    /// `StagingPool::threshold()` bytes go through pinned memory from the pool. Writes copy the
+    /// host data into pinned memory before they are enqueued, so the host memory can be reused
+    /// right away. Non-blocking reads go directly into host memory, so that `wait()` covers them.
+    /// The setting applies to this queue object and copies made from it afterwards.
+    ///
+    /// @param pool Staging pool, `nullptr` to transfer directly from and to host memory
+    void set_staging_pool(std::shared_ptr<StagingPool> pool);
+
+    /// Get the pool of pinned host memory used to stage transfers
+    std::shared_ptr<StagingPool> staging_pool() const;
+
+    operator cl_command_queue() const;
+
 private:
+    /// Tracks the last commands that read and wrote memory objects in an out-of-order queue
+    class DependencyTracker;
+
+    /// Build a wait list for a command
+    ///
+    /// In an out-of-order queue, the events of previously enqueued commands the command depends on
+    /// are added to `wait_list`. A command with no declared reads or writes depends on all
+    /// previously enqueued commands. The command must be passed into `record` before another
+    /// thread builds the wait list of its next command (see the out-of-order queue constructor).
+    ///
+    /// @param reads Memory objects the command reads from
+    /// @param writes Memory objects the command writes into
+    /// @param wait_list Events the caller wants the command to wait for
+    /// @param storage Storage for the combined wait list
+    /// @return Wait list to pass into the enqueue call
+    WaitList dependencies(std::span<const cl_mem> reads,
+                          std::span<const cl_mem> writes,
+                          WaitList wait_list,
+                          WaitListStorage & storage) const;
+
+    /// Record an enqueued command, so that subsequent commands can depend on it
+    ///
+    /// @param reads Memory objects the command reads from
+    /// @param writes Memory objects the command writes into
+    /// @param evt Event of the command. Null event indicates that the command has already
+    ///        completed (i.e. it was blocking).
+    void
+    record(std::span<const cl_mem> reads, std::span<const cl_mem> writes, const Event & evt) const;
+
+    /// Look up the tuned local size of a kernel in the tuning database. Must only be called with a
+    /// tuning database set.
+    ///
+    /// @return `true` if the database has a valid entry, `false` otherwise
+    bool
+    tuned_local(const Kernel & kernel, cl_uint dims, const size_t * global, size_t * local) const;
+
+    /// Check if a transfer of `size` bytes goes through the staging pool
+    bool staged(size_t size) const;
+
+    /// Check if `ptr` points into the host memory used as storage of `buffer` at `offset`
+    static bool aliases(const Memory & buffer, size_t offset, const void * ptr);
+
+    /// Enqueue a map and an unmap of a buffer region that uses host memory as its storage, so that
+    /// the host memory and the device agree on its contents
+    ///
+    /// @param mem Buffer
+    /// @param flags `READ` to bring the host memory up to date, `WRITE_INVALIDATE_REGION` to make
+    ///        the device see the host memory
+    /// @param offset Offset of the region in bytes
+    /// @param size Size of the region in bytes
+    /// @param wait_list Events the map waits for
+    /// @return Event of the unmap
+    Event enqueue_sync_host_raw(cl_mem mem,
+                                MapFlags flags,
+                                size_t offset,
+                                size_t size,
+                                WaitList wait_list) const;
+
     /// A synchronization point that enqueues a barrier operation.
     ///
     /// @param wait_list Specify events that need to complete before
     /// @return Event object the identified this barrier
-    Event enqueue_barrier(const std::vector<Event> & wait_list = std::vector<Event>()) const;
+    Event enqueue_barrier(WaitList wait_list = WaitList()) const;
 
     /// Enqueues a marker command which waits for either a list of events to complete, or all
     /// previously enqueued commands to complete.
@@ -285,7 +1093,7 @@ private:
     /// @param wait_list Events that need to complete before this particular command can be
     ///        executed.
     /// @return Event object that identifies this particular marker
-    Event enqueue_marker(const std::vector<Event> & wait_list = std::vector<Event>()) const;
+    Event enqueue_marker(WaitList wait_list = WaitList()) const;
 
     /// Enqueues a command to execute a kernel on a device.
     ///
@@ -293,25 +1101,61 @@ private:
     /// @param global Global range
     /// @param wait_list Specify events that need to complete before this particular command can be
     ///        executed
+    /// @param reads Memory objects the kernel reads from
+    /// @param writes Memory objects the kernel writes into
     /// @return Event object that identifies this particular kernel execution instance
     template <int N>
     Event
     enqueue_kernel(const Kernel & kernel,
                    const Range<N> & global,
-                   const std::vector<Event> & wait_list = std::vector<Event>()) const
+                   WaitList wait_list = WaitList(),
+                   std::span<const cl_mem> reads = {},
+                   std::span<const cl_mem> writes = {}) const
+    {
+        if (this->tuning_ != nullptr) {
+            std::array<size_t, N> local;
+            if (tuned_local(kernel, global.dimensions(), global, local.data()))
+                return enqueue_kernel(kernel,
+                                      NDRange<N>(global, Range<N>(local)),
+                                      wait_list,
+                                      reads,
+                                      writes);
+        }
+        return enqueue_kernel(kernel, NDRange<N>(global), wait_list, reads, writes);
+    }
+
+    /// Enqueues a command to execute a kernel on a device.
+    ///
+    /// @param kernel Kernel to execute
+    /// @param range Index space with global range, local range and global offset
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @param reads Memory objects the kernel reads from
+    /// @param writes Memory objects the kernel writes into
+    /// @return Event object that identifies this particular kernel execution instance
+    template <int N>
+    Event
+    enqueue_kernel(const Kernel & kernel,
+                   const NDRange<N> & range,
+                   WaitList wait_list = WaitList(),
+                   std::span<const cl_mem> reads = {},
+                   std::span<const cl_mem> writes = {}) const
     {
+        WaitListStorage storage;
+        auto deps = dependencies(reads, writes, wait_list, storage);
         cl_event evt;
-        OPENCL_CHECK(
-            clEnqueueNDRangeKernel(this->q_,
-                                   kernel,
-                                   global.dimensions(),
-                                   nullptr,
-                                   global,
-                                   nullptr,
-                                   wait_list.size(),
-                                   wait_list.empty() ? nullptr : (cl_event *) &wait_list.front(),
-                                   &evt));
-        return Event(evt);
+        OPENCL_CHECK(clEnqueueNDRangeKernel(this->q_,
+                                            kernel,
+                                            range.dimensions(),
+                                            range.offset_ptr(),
+                                            range.global(),
+                                            range.local_ptr(),
+                                            deps.size(),
+                                            deps.data(),
+                                            &evt));
+        Event e(evt);
+        record(reads, writes, e);
+        return e;
     }
 
     /// Enqueue commands to read from a buffer object to host memory in blocking mode
@@ -326,7 +1170,7 @@ private:
                           size_t offset,
                           size_t size,
                           void * ptr,
-                          const std::vector<Event> & wait_list = std::vector<Event>()) const;
+                          WaitList wait_list = WaitList()) const;
 
     /// Enqueue commands to read from a buffer object to host memory in non-blocking mode
     ///
@@ -341,7 +1185,7 @@ private:
                             size_t offset,
                             size_t size,
                             void * ptr,
-                            const std::vector<Event> & wait_list = std::vector<Event>()) const;
+                            WaitList wait_list = WaitList()) const;
 
     /// Enqueue commands to write to a buffer object from host memory in blocking mode
     ///
@@ -355,7 +1199,7 @@ private:
                            size_t offset,
                            size_t size,
                            const void * ptr,
-                           const std::vector<Event> & wait_list = std::vector<Event>()) const;
+                           WaitList wait_list = WaitList()) const;
 
     /// Enqueue commands to write to a buffer object from host memory in non-blocking mode
     ///
@@ -370,7 +1214,7 @@ private:
                              size_t offset,
                              size_t size,
                              const void * ptr,
-                             const std::vector<Event> & wait_list = std::vector<Event>()) const;
+                             WaitList wait_list = WaitList()) const;
 
     /// Enqueues a command to copy from one buffer object to another.
     ///
@@ -387,7 +1231,131 @@ private:
                            size_t src_offset,
                            size_t dest_offset,
                            size_t size,
-                           const std::vector<Event> & wait_list = std::vector<Event>()) const;
+                           WaitList wait_list = WaitList()) const;
+
+    /// Enqueue commands to read a rectangular region from a buffer object to host memory in
+    /// non-blocking mode
+    ///
+    /// @param buffer Buffer to read from
+    /// @param buffer_origin The (x, y, z) offset in the buffer, x in bytes
+    /// @param host_origin The (x, y, z) offset in host memory, x in bytes
+    /// @param region The (width in bytes, height in rows, depth in slices) of the region
+    /// @param buffer_row_pitch Length of each row in bytes in the buffer, 0 for `region[0]`
+    /// @param buffer_slice_pitch Length of each slice in bytes in the buffer, 0 for
+    ///        `region[1] * buffer_row_pitch`
+    /// @param host_row_pitch Length of each row in bytes in host memory, 0 for `region[0]`
+    /// @param host_slice_pitch Length of each slice in bytes in host memory, 0 for
+    ///        `region[1] * host_row_pitch`
+    /// @param ptr The pointer to buffer in host memory where data is to be read into.
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular read command
+    Event enqueue_iread_rect_raw(const Memory & buffer,
+                                 const size_t * buffer_origin,
+                                 const size_t * host_origin,
+                                 const size_t * region,
+                                 size_t buffer_row_pitch,
+                                 size_t buffer_slice_pitch,
+                                 size_t host_row_pitch,
+                                 size_t host_slice_pitch,
+                                 void * ptr,
+                                 WaitList wait_list = WaitList()) const;
+
+    /// Enqueue commands to write a rectangular region to a buffer object from host memory in
+    /// non-blocking mode
+    ///
+    /// @param buffer Buffer to write into
+    /// @param buffer_origin The (x, y, z) offset in the buffer, x in bytes
+    /// @param host_origin The (x, y, z) offset in host memory, x in bytes
+    /// @param region The (width in bytes, height in rows, depth in slices) of the region
+    /// @param buffer_row_pitch Length of each row in bytes in the buffer, 0 for `region[0]`
+    /// @param buffer_slice_pitch Length of each slice in bytes in the buffer, 0 for
+    ///        `region[1] * buffer_row_pitch`
+    /// @param host_row_pitch Length of each row in bytes in host memory, 0 for `region[0]`
+    /// @param host_slice_pitch Length of each slice in bytes in host memory, 0 for
+    ///        `region[1] * host_row_pitch`
+    /// @param ptr The pointer to buffer in host memory where data is to be written from.
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular write command
+    Event
+    enqueue_iwrite_rect_raw(const Memory & buffer,
+                            const size_t * buffer_origin,
+                            const size_t * host_origin,
+                            const size_t * region,
+                            size_t buffer_row_pitch,
+                            size_t buffer_slice_pitch,
+                            size_t host_row_pitch,
+                            size_t host_slice_pitch,
+                            const void * ptr,
+                            WaitList wait_list = WaitList()) const;
+
+    /// Enqueues a command to copy a rectangular region from one buffer object to another
+    ///
+    /// @param src Source buffer
+    /// @param dest Destination buffer
+    /// @param src_origin The (x, y, z) offset in `src`, x in bytes
+    /// @param dest_origin The (x, y, z) offset in `dest`, x in bytes
+    /// @param region The (width in bytes, height in rows, depth in slices) of the region
+    /// @param src_row_pitch Length of each row in bytes in `src`, 0 for `region[0]`
+    /// @param src_slice_pitch Length of each slice in bytes in `src`, 0 for
+    ///        `region[1] * src_row_pitch`
+    /// @param dest_row_pitch Length of each row in bytes in `dest`, 0 for `region[0]`
+    /// @param dest_slice_pitch Length of each slice in bytes in `dest`, 0 for
+    ///        `region[1] * dest_row_pitch`
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular copy command
+    Event enqueue_copy_rect_raw(const Memory & src,
+                                const Memory & dest,
+                                const size_t * src_origin,
+                                const size_t * dest_origin,
+                                const size_t * region,
+                                size_t src_row_pitch,
+                                size_t src_slice_pitch,
+                                size_t dest_row_pitch,
+                                size_t dest_slice_pitch,
+                                WaitList wait_list = WaitList()) const;
+
+    /// Convert a position or size of a `D`-dimensional region in elements into the 3-dimensional
+    /// form used by rectangular copies (x in bytes)
+    ///
+    /// @param r Position or size in elements
+    /// @param elem_size Size of one element in bytes
+    /// @param pad Value of the dimensions beyond `D`
+    template <int D>
+    static std::array<size_t, 3>
+    rect_3d(const Range<D> & r, size_t elem_size, size_t pad)
+    {
+        static_assert(D >= 1 && D <= 3, "Rectangular copies support 1 to 3 dimensions");
+        std::array<size_t, 3> a = { pad, pad, pad };
+        for (int i = 0; i < D; i++)
+            a[i] = r.size(i);
+        a[0] *= elem_size;
+        return a;
+    }
+
+    /// Row pitch in bytes of an array of a given shape, 0 for 1-dimensional arrays
+    template <int D>
+    static size_t
+    row_pitch(const Range<D> & shape, size_t elem_size)
+    {
+        if constexpr (D > 1)
+            return shape.size(0) * elem_size;
+        else
+            return 0;
+    }
+
+    /// Slice pitch in bytes of an array of a given shape, 0 for arrays with less than 3 dimensions
+    template <int D>
+    static size_t
+    slice_pitch(const Range<D> & shape, size_t elem_size)
+    {
+        if constexpr (D > 2)
+            return shape.size(0) * shape.size(1) * elem_size;
+        else
+            return 0;
+    }
 
     /// Enqueues a command to map a region of the buffer object given by `buffer` into the host
     /// address space and returns a pointer to this mapped region.
@@ -413,6 +1381,22 @@ private:
                                   size_t offset,
                                   size_t size) const;
 
+    /// Enqueues a command to map a region of a buffer object and returns the event of the command
+    ///
+    /// @param buffer Buffer to map
+    /// @param blocking Indicates if the map operation is blocking or non-blocking.
+    /// @param flags Map flags
+    /// @param offset The offset in bytes of the region in the buffer object that is being mapped.
+    /// @param size The size of the region in the buffer object that is being mapped.
+    /// @param evt Set to the event of the map command
+    /// @return Pointer to the mapped region
+    void * enqueue_map_buffer_raw(const Memory & buffer,
+                                  bool blocking,
+                                  MapFlags flags,
+                                  size_t offset,
+                                  size_t size,
+                                  Event & evt) const;
+
     /// Enqueues a command to fill a buffer object with a pattern of a given pattern size.
     ///
     /// @param buffer A valid buffer object
@@ -431,7 +1415,81 @@ private:
                             size_t pattern_size,
                             size_t offset,
                             size_t size,
-                            const std::vector<Event> & wait_list = std::vector<Event>()) const;
+                            WaitList wait_list = WaitList()) const;
+
+#ifdef CL_VERSION_2_0
+    /// Enqueue a command to map shared virtual memory
+    ///
+    /// @param ptr Mapped memory
+    /// @param size Size in bytes
+    /// @param flags Map flags
+    /// @param blocking Indicates if the map operation is blocking or non-blocking
+    /// @param wait_list Events the command waits for
+    /// @return Event object that identifies this particular map command
+    Event enqueue_svm_map_raw(void * ptr,
+                              size_t size,
+                              MapFlags flags,
+                              bool blocking,
+                              WaitList wait_list = WaitList()) const;
+#endif
+
+    /// Enqueue a command to read a region of an image into host memory in non-blocking mode
+    ///
+    /// @param image Image being read
+    /// @param origin (x, y, z) of the region in pixels
+    /// @param region (width, height, depth) of the region in pixels
+    /// @param ptr Host memory for the tightly packed pixels of the region
+    /// @param wait_list Events the command waits for
+    /// @return Event object that identifies this particular read command
+    Event enqueue_iread_image_raw(const Memory & image,
+                                  const size_t * origin,
+                                  const size_t * region,
+                                  void * ptr,
+                                  WaitList wait_list = WaitList()) const;
+
+    /// Enqueue a command to write host memory into a region of an image in non-blocking mode
+    ///
+    /// @param image Image being written
+    /// @param origin (x, y, z) of the region in pixels
+    /// @param region (width, height, depth) of the region in pixels
+    /// @param ptr Host memory with the tightly packed pixels of the region
+    /// @param wait_list Events the command waits for
+    /// @return Event object that identifies this particular write command
+    Event enqueue_iwrite_image_raw(const Memory & image,
+                                   const size_t * origin,
+                                   const size_t * region,
+                                   const void * ptr,
+                                   WaitList wait_list = WaitList()) const;
+
+    /// Enqueue a command to copy a region of an image into another image
+    ///
+    /// @param src Source image
+    /// @param dest Destination image
+    /// @param src_origin (x, y, z) of the region in `src` in pixels
+    /// @param dest_origin (x, y, z) of the region in `dest` in pixels
+    /// @param region (width, height, depth) of the region in pixels
+    /// @param wait_list Events the command waits for
+    /// @return Event object that identifies this particular copy command
+    Event enqueue_copy_image_raw(const Memory & src,
+                                 const Memory & dest,
+                                 const size_t * src_origin,
+                                 const size_t * dest_origin,
+                                 const size_t * region,
+                                 WaitList wait_list = WaitList()) const;
+
+    /// Enqueue a command to fill a region of an image with a color
+    ///
+    /// @param image Image being filled
+    /// @param color Fill color (`cl_float4`, `cl_int4` or `cl_uint4`)
+    /// @param origin (x, y, z) of the region in pixels
+    /// @param region (width, height, depth) of the region in pixels
+    /// @param wait_list Events the command waits for
+    /// @return Event object that identifies this particular fill command
+    Event enqueue_fill_image_raw(const Memory & image,
+                                 const void * color,
+                                 const size_t * origin,
+                                 const size_t * region,
+                                 WaitList wait_list = WaitList()) const;
 
     template <typename T>
     T
@@ -444,23 +1502,95 @@ private:
 
     /// Underlying OpenCL queue
     cl_command_queue q_;
+    /// Dependency tracking (only for out-of-order queues)
+    std::shared_ptr<DependencyTracker> deps_;
+    /// Database of tuned work-group sizes consulted by kernel launches
+    std::shared_ptr<TuningDatabase> tuning_;
+    /// Device of the queue, resolved when a tuning database is set
+    cl_device_id tuning_device_ = nullptr;
+    /// Pinned memory used to stage large transfers
+    std::shared_ptr<StagingPool> staging_;
 
 public:
     /// Get the default queue
     ///
+    /// The queue is created on the default context and device. Depending on the default queue
+    /// policy, it is either shared by all threads or private to the calling thread.
+    ///
     /// @return Default queue object
     static Queue get_default();
 
+    /// Set how the default queue is handed out
+    ///
+    /// With `PER_THREAD`, every host thread enqueues into its own queue, so threads do not contend
+    /// for one queue and `wait()` only waits for the work of the calling thread.
+    ///
+    /// @param policy Default queue policy
+    static void set_default_policy(DefaultQueuePolicy policy);
+
+    /// Get the default queue policy
+    static DefaultQueuePolicy default_policy();
+
 private:
     static std::once_flag have_default_;
     static Queue default_queue_;
+    static std::atomic<DefaultQueuePolicy> default_policy_;
 
     friend class Handler;
+    friend class CommandGraph;
+    template <typename T, typename U>
+    friend class Pipeline;
 };
 
 /// Handler
+///
+/// Enqueues a group of commands submitted via `Queue::submit`. Events passed into `depends_on`
+/// are waited on by all subsequent commands of the group.
+///
+/// Whole-buffer copies of buffers with padded rows (`PitchedBuffer`) are done as rectangular
+/// regions, like with `Queue::copy`.
 class Handler {
 public:
+    /// Make all subsequent commands in this group wait for events
+    ///
+    /// @param events Events to wait for
+    /// @return Reference to this handler
+    Handler &
+    depends_on(WaitList events)
+    {
+        this->deps_.append(events);
+        return *this;
+    }
+
+    /// Declare memory objects the next kernel reads from
+    ///
+    /// On out-of-order queues, the declared reads and writes are used to build dependencies
+    /// between the kernel and other commands. A kernel without any declared reads or writes waits
+    /// for all previously enqueued commands and all subsequent commands wait for it. On in-order
+    /// queues, the declarations are ignored.
+    ///
+    /// @param mems Memory objects
+    /// @return Reference to this handler
+    template <typename... MEMS>
+    Handler &
+    reads(const MEMS &... mems)
+    {
+        (this->reads_.push_back(mems), ...);
+        return *this;
+    }
+
+    /// Declare memory objects the next kernel writes into
+    ///
+    /// @param mems Memory objects
+    /// @return Reference to this handler
+    template <typename... MEMS>
+    Handler &
+    writes(const MEMS &... mems)
+    {
+        (this->writes_.push_back(mems), ...);
+        return *this;
+    }
+
     /// Enqueues a command to execute a kernel on a device.
     ///
     /// @param kernel Kernel to execute
@@ -469,10 +1599,57 @@ public:
     ///        executed
     /// @return Event object that identifies this particular kernel execution instance
     template <int N>
-    void
-    kernel(const Kernel & kernel, const Range<N> & global) const
+    Event
+    kernel(const Kernel & kernel,
+           const Range<N> & global,
+           WaitList wait_list = WaitList())
+    {
+        if (this->graph_ != nullptr)
+            return this->kernel(kernel, NDRange<N>(global), wait_list);
+        WaitListStorage storage;
+        auto evt = this->q_.enqueue_kernel(kernel,
+                                           global,
+                                           waits(wait_list, storage),
+                                           this->reads_,
+                                           this->writes_);
+        this->reads_.clear();
+        this->writes_.clear();
+        return add(evt);
+    }
+
+    /// Enqueues a command to execute a kernel on a device.
+    ///
+    /// @param kernel Kernel to execute
+    /// @param range Index space with global range, local range and global offset
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular kernel execution instance
+    template <int N>
+    Event
+    kernel(const Kernel & kernel,
+           const NDRange<N> & range,
+           WaitList wait_list = WaitList())
     {
-        this->q_.enqueue_kernel(kernel, global);
+        WaitListStorage storage;
+        if (this->graph_ != nullptr) {
+            record_kernel(kernel,
+                          range.dimensions(),
+                          range.offset_ptr(),
+                          range.global(),
+                          range.local_ptr(),
+                          waits(wait_list, storage));
+            this->reads_.clear();
+            this->writes_.clear();
+            return Event();
+        }
+        auto evt = this->q_.enqueue_kernel(kernel,
+                                           range,
+                                           waits(wait_list, storage),
+                                           this->reads_,
+                                           this->writes_);
+        this->reads_.clear();
+        this->writes_.clear();
+        return add(evt);
     }
 
     /// Enqueues a command to fill a buffer object with a pattern
@@ -487,10 +1664,30 @@ public:
     ///        executed
     /// @return Event object that identifies this particular write command
     template <typename T, typename U, int D>
-    void
-    fill(const Buffer<T, D> & buffer, const U & pattern, const Range<D> & range)
+    Event
+    fill(const Buffer<T, D> & buffer,
+         const U & pattern,
+         const Range<D> & range,
+         WaitList wait_list = WaitList())
     {
-        this->q_.enqueue_fill_buffer_raw(buffer, &pattern, sizeof(U), 0, range.size() * sizeof(U));
+        WaitListStorage storage;
+        auto size = range.size() * sizeof(U);
+        if (buffer.padded()) {
+            static_assert(sizeof(T) % sizeof(U) == 0,
+                          "Pattern must evenly divide the buffer element");
+            assert(range.size(0) == buffer.range().size(0));
+            size = range.size() / range.size(0) * buffer.row_pitch();
+        }
+        if (this->graph_ != nullptr) {
+            record_fill(buffer, &pattern, sizeof(U), 0, size, waits(wait_list, storage));
+            return Event();
+        }
+        return add(this->q_.enqueue_fill_buffer_raw(buffer,
+                                                    &pattern,
+                                                    sizeof(U),
+                                                    0,
+                                                    size,
+                                                    waits(wait_list, storage)));
     }
 
     /// Enqueue commands to read from a buffer object to host memory in blocking mode
@@ -501,9 +1698,27 @@ public:
     ///        executed
     template <typename T, int D>
     void
-    copy(const Buffer<T, D> & src, void * dest, const Range<D> & range) const
+    copy(const Buffer<T, D> & src,
+         void * dest,
+         const Range<D> & range,
+         WaitList wait_list = WaitList())
     {
-        this->q_.enqueue_read_raw(src, 0 * sizeof(T), range.size() * sizeof(T), dest);
+        if (src.padded()) {
+            auto evt = icopy(src, dest, range, wait_list);
+            if (this->graph_ == nullptr)
+                evt.wait();
+            return;
+        }
+        WaitListStorage storage;
+        if (this->graph_ != nullptr) {
+            record_read(src, 0, range.size() * sizeof(T), dest, waits(wait_list, storage));
+            return;
+        }
+        this->q_.enqueue_read_raw(src,
+                                  0 * sizeof(T),
+                                  range.size() * sizeof(T),
+                                  dest,
+                                  waits(wait_list, storage));
     }
 
     /// Enqueue commands to write to a buffer object from host memory in blocking mode
@@ -514,9 +1729,27 @@ public:
     ///        executed
     template <typename T, int D>
     void
-    copy(const void * src, const Buffer<T, D> & dest, const Range<D> & range) const
+    copy(const void * src,
+         const Buffer<T, D> & dest,
+         const Range<D> & range,
+         WaitList wait_list = WaitList())
     {
-        this->q_.enqueue_write_raw(dest, 0 * sizeof(T), range.size() * sizeof(T), src);
+        if (dest.padded()) {
+            auto evt = icopy(src, dest, range, wait_list);
+            if (this->graph_ == nullptr)
+                evt.wait();
+            return;
+        }
+        WaitListStorage storage;
+        if (this->graph_ != nullptr) {
+            record_write(dest, 0, range.size() * sizeof(T), src, waits(wait_list, storage));
+            return;
+        }
+        this->q_.enqueue_write_raw(dest,
+                                   0 * sizeof(T),
+                                   range.size() * sizeof(T),
+                                   src,
+                                   waits(wait_list, storage));
     }
 
     /// Enqueues a command to copy from one buffer object to another.
@@ -528,24 +1761,438 @@ public:
     ///        executed
     /// @return Event object that identifies this particular operation
     template <typename T, int D>
-    void
-    copy(const Buffer<T, D> & src, const Buffer<T, D> & dest, const Range<D> & range) const
+    Event
+    copy(const Buffer<T, D> & src,
+         const Buffer<T, D> & dest,
+         const Range<D> & range,
+         WaitList wait_list = WaitList())
     {
+        WaitListStorage storage;
+        if (src.padded() || dest.padded()) {
+            std::array<size_t, 3> origin = { 0, 0, 0 };
+            auto rgn = Queue::rect_3d(range, sizeof(T), 1);
+            return copy_rect(src,
+                             dest,
+                             origin.data(),
+                             origin.data(),
+                             rgn.data(),
+                             src.row_pitch(),
+                             src.slice_pitch(),
+                             dest.row_pitch(),
+                             dest.slice_pitch(),
+                             waits(wait_list, storage));
+        }
         assert(src.byte_size() == dest.byte_size());
-        this->q_.enqueue_copy_raw(src,
-                                  dest,
-                                  0 * sizeof(T),
-                                  0 * sizeof(T),
-                                  range.size() * sizeof(T));
+        if (this->graph_ != nullptr) {
+            record_copy(src, dest, 0, 0, range.size() * sizeof(T), waits(wait_list, storage));
+            return Event();
+        }
+        return add(this->q_.enqueue_copy_raw(src,
+                                             dest,
+                                             0 * sizeof(T),
+                                             0 * sizeof(T),
+                                             range.size() * sizeof(T),
+                                             waits(wait_list, storage)));
+    }
+
+    /// Enqueue commands to read from a buffer object to host memory in non-blocking mode
+    ///
+    /// `dest` must stay valid until the returned event completes.
+    ///
+    /// @param src Buffer to read from
+    /// @param dest The pointer to buffer in host memory where data is to be read into.
+    /// @param range Range.
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular read command
+    template <typename T, int D>
+    Event
+    icopy(const Buffer<T, D> & src,
+          void * dest,
+          const Range<D> & range,
+          WaitList wait_list = WaitList())
+    {
+        WaitListStorage storage;
+        if (src.padded()) {
+            std::array<size_t, 3> origin = { 0, 0, 0 };
+            auto rgn = Queue::rect_3d(range, sizeof(T), 1);
+            return read_rect(src,
+                             origin.data(),
+                             origin.data(),
+                             rgn.data(),
+                             src.row_pitch(),
+                             src.slice_pitch(),
+                             Queue::row_pitch(range, sizeof(T)),
+                             Queue::slice_pitch(range, sizeof(T)),
+                             dest,
+                             waits(wait_list, storage));
+        }
+        if (this->graph_ != nullptr) {
+            record_read(src, 0, range.size() * sizeof(T), dest, waits(wait_list, storage));
+            return Event();
+        }
+        return add(this->q_.enqueue_iread_raw(src,
+                                              0 * sizeof(T),
+                                              range.size() * sizeof(T),
+                                              dest,
+                                              waits(wait_list, storage)));
+    }
+
+    /// Enqueue commands to write to a buffer object from host memory in non-blocking mode
+    ///
+    /// `src` must stay valid until the returned event completes.
+    ///
+    /// @param src The pointer to buffer in host memory where data is to be written from.
+    /// @param dest Buffer to write into
+    /// @param range Range.
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular write command
+    template <typename T, int D>
+    Event
+    icopy(const void * src,
+          const Buffer<T, D> & dest,
+          const Range<D> & range,
+          WaitList wait_list = WaitList())
+    {
+        WaitListStorage storage;
+        if (dest.padded()) {
+            std::array<size_t, 3> origin = { 0, 0, 0 };
+            auto rgn = Queue::rect_3d(range, sizeof(T), 1);
+            return write_rect(dest,
+                              origin.data(),
+                              origin.data(),
+                              rgn.data(),
+                              dest.row_pitch(),
+                              dest.slice_pitch(),
+                              Queue::row_pitch(range, sizeof(T)),
+                              Queue::slice_pitch(range, sizeof(T)),
+                              src,
+                              waits(wait_list, storage));
+        }
+        if (this->graph_ != nullptr) {
+            record_write(dest, 0, range.size() * sizeof(T), src, waits(wait_list, storage));
+            return Event();
+        }
+        return add(this->q_.enqueue_iwrite_raw(dest,
+                                               0 * sizeof(T),
+                                               range.size() * sizeof(T),
+                                               src,
+                                               waits(wait_list, storage)));
+    }
+
+    /// Enqueues a command to fill a window of elements of a buffer object with a pattern
+    ///
+    /// @param buffer Buffer being filled
+    /// @param pattern Pattern to fill the buffer with
+    /// @param origin Index of the first element filled
+    /// @param extent Number of elements to fill
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular write command
+    template <typename T, typename U, int D>
+    Event
+    fill(const Buffer<T, D> & buffer,
+         const U & pattern,
+         const Range<1> & origin,
+         const Range<1> & extent,
+         WaitList wait_list = WaitList())
+    {
+        static_assert(sizeof(T) % sizeof(U) == 0, "Pattern must evenly divide the buffer element");
+        WaitListStorage storage;
+        auto ofs = origin.size(0) * sizeof(T);
+        auto size = extent.size() * sizeof(T);
+        if (this->graph_ != nullptr) {
+            record_fill(buffer, &pattern, sizeof(U), ofs, size, waits(wait_list, storage));
+            return Event();
+        }
+        return add(this->q_.enqueue_fill_buffer_raw(buffer,
+                                                    &pattern,
+                                                    sizeof(U),
+                                                    ofs,
+                                                    size,
+                                                    waits(wait_list, storage)));
+    }
+
+    /// Enqueue commands to read a window of elements from a buffer object to host memory in
+    /// blocking mode
+    ///
+    /// @param src Buffer to read from
+    /// @param dest Host memory receiving the `extent` elements
+    /// @param origin Index of the first element read from `src`
+    /// @param extent Number of elements to read
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    template <typename T, int D>
+    void
+    copy(const Buffer<T, D> & src,
+         void * dest,
+         const Range<1> & origin,
+         const Range<1> & extent,
+         WaitList wait_list = WaitList())
+    {
+        WaitListStorage storage;
+        auto ofs = origin.size(0) * sizeof(T);
+        auto size = extent.size() * sizeof(T);
+        if (this->graph_ != nullptr) {
+            record_read(src, ofs, size, dest, waits(wait_list, storage));
+            return;
+        }
+        this->q_.enqueue_read_raw(src, ofs, size, dest, waits(wait_list, storage));
+    }
+
+    /// Enqueue commands to write a window of elements to a buffer object from host memory in
+    /// blocking mode
+    ///
+    /// @param src Host memory holding the `extent` elements to write
+    /// @param dest Buffer to write into
+    /// @param origin Index of the first element written in `dest`
+    /// @param extent Number of elements to write
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    template <typename T, int D>
+    void
+    copy(const void * src,
+         const Buffer<T, D> & dest,
+         const Range<1> & origin,
+         const Range<1> & extent,
+         WaitList wait_list = WaitList())
+    {
+        WaitListStorage storage;
+        auto ofs = origin.size(0) * sizeof(T);
+        auto size = extent.size() * sizeof(T);
+        if (this->graph_ != nullptr) {
+            record_write(dest, ofs, size, src, waits(wait_list, storage));
+            return;
+        }
+        this->q_.enqueue_write_raw(dest, ofs, size, src, waits(wait_list, storage));
+    }
+
+    /// Enqueues a command to copy a window of elements from one buffer object to another
+    ///
+    /// @param src Source buffer
+    /// @param dest Destination buffer
+    /// @param src_origin Index of the first element copied from `src`
+    /// @param dest_origin Index of the first element copied into `dest`
+    /// @param extent Number of elements to copy
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular operation
+    template <typename T, int D>
+    Event
+    copy(const Buffer<T, D> & src,
+         const Buffer<T, D> & dest,
+         const Range<1> & src_origin,
+         const Range<1> & dest_origin,
+         const Range<1> & extent,
+         WaitList wait_list = WaitList())
+    {
+        WaitListStorage storage;
+        auto src_ofs = src_origin.size(0) * sizeof(T);
+        auto dest_ofs = dest_origin.size(0) * sizeof(T);
+        auto size = extent.size() * sizeof(T);
+        if (this->graph_ != nullptr) {
+            record_copy(src, dest, src_ofs, dest_ofs, size, waits(wait_list, storage));
+            return Event();
+        }
+        return add(this->q_.enqueue_copy_raw(src,
+                                             dest,
+                                             src_ofs,
+                                             dest_ofs,
+                                             size,
+                                             waits(wait_list, storage)));
+    }
+
+    /// Enqueue commands to read a window of elements from a buffer object to host memory in
+    /// non-blocking mode
+    ///
+    /// `dest` must stay valid until the returned event completes.
+    ///
+    /// @param src Buffer to read from
+    /// @param dest Host memory receiving the `extent` elements
+    /// @param origin Index of the first element read from `src`
+    /// @param extent Number of elements to read
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular read command
+    template <typename T, int D>
+    Event
+    icopy(const Buffer<T, D> & src,
+          void * dest,
+          const Range<1> & origin,
+          const Range<1> & extent,
+          WaitList wait_list = WaitList())
+    {
+        WaitListStorage storage;
+        auto ofs = origin.size(0) * sizeof(T);
+        auto size = extent.size() * sizeof(T);
+        if (this->graph_ != nullptr) {
+            record_read(src, ofs, size, dest, waits(wait_list, storage));
+            return Event();
+        }
+        return add(this->q_.enqueue_iread_raw(src, ofs, size, dest, waits(wait_list, storage)));
+    }
+
+    /// Enqueue commands to write a window of elements to a buffer object from host memory in
+    /// non-blocking mode
+    ///
+    /// `src` must stay valid until the returned event completes.
+    ///
+    /// @param src Host memory holding the `extent` elements to write
+    /// @param dest Buffer to write into
+    /// @param origin Index of the first element written in `dest`
+    /// @param extent Number of elements to write
+    /// @param wait_list Specify events that need to complete before this particular command can be
+    ///        executed
+    /// @return Event object that identifies this particular write command
+    template <typename T, int D>
+    Event
+    icopy(const void * src,
+          const Buffer<T, D> & dest,
+          const Range<1> & origin,
+          const Range<1> & extent,
+          WaitList wait_list = WaitList())
+    {
+        WaitListStorage storage;
+        auto ofs = origin.size(0) * sizeof(T);
+        auto size = extent.size() * sizeof(T);
+        if (this->graph_ != nullptr) {
+            record_write(dest, ofs, size, src, waits(wait_list, storage));
+            return Event();
+        }
+        return add(this->q_.enqueue_iwrite_raw(dest, ofs, size, src, waits(wait_list, storage)));
     }
 
 private:
-    Handler(Queue & q) : q_(q) {}
+    Handler(Queue & q, CommandGraph * graph = nullptr) : q_(q), graph_(graph) {}
+
+    // Recording into a command graph. Commands recorded into a graph do not have events, so they
+    // return null events.
+
+    void record_kernel(const Kernel & kernel,
+                       cl_uint dims,
+                       const size_t * offset,
+                       const size_t * global,
+                       const size_t * local,
+                       WaitList wait_list);
+
+    void record_fill(const Memory & buffer,
+                     const void * pattern,
+                     size_t pattern_size,
+                     size_t offset,
+                     size_t size,
+                     WaitList wait_list);
+
+    void record_copy(const Memory & src,
+                     const Memory & dest,
+                     size_t src_offset,
+                     size_t dest_offset,
+                     size_t size,
+                     WaitList wait_list);
+
+    void record_read(const Memory & buffer,
+                     size_t offset,
+                     size_t size,
+                     void * ptr,
+                     WaitList wait_list);
+
+    void record_write(const Memory & buffer,
+                      size_t offset,
+                      size_t size,
+                      const void * ptr,
+                      WaitList wait_list);
+
+    // Rectangular commands used for buffers with padded rows, enqueued or recorded into the graph.
+    // The wait list must already contain the group dependencies.
+
+    Event copy_rect(const Memory & src,
+                    const Memory & dest,
+                    const size_t * src_origin,
+                    const size_t * dest_origin,
+                    const size_t * region,
+                    size_t src_row_pitch,
+                    size_t src_slice_pitch,
+                    size_t dest_row_pitch,
+                    size_t dest_slice_pitch,
+                    WaitList wait_list);
+
+    Event read_rect(const Memory & buffer,
+                    const size_t * buffer_origin,
+                    const size_t * host_origin,
+                    const size_t * region,
+                    size_t buffer_row_pitch,
+                    size_t buffer_slice_pitch,
+                    size_t host_row_pitch,
+                    size_t host_slice_pitch,
+                    void * ptr,
+                    WaitList wait_list);
+
+    Event write_rect(const Memory & buffer,
+                     const size_t * buffer_origin,
+                     const size_t * host_origin,
+                     const size_t * region,
+                     size_t buffer_row_pitch,
+                     size_t buffer_slice_pitch,
+                     size_t host_row_pitch,
+                     size_t host_slice_pitch,
+                     const void * ptr,
+                     WaitList wait_list);
+
+    /// Build the wait list of a command from the group dependencies and command specific events
+    ///
+    /// @param wait_list Command specific events
+    /// @param storage Storage for the combined wait list
+    /// @return Wait list to pass into the enqueue call
+    WaitList
+    waits(WaitList wait_list, WaitListStorage & storage) const
+    {
+        if (this->deps_.size() == 0)
+            return wait_list.dense(storage);
+        storage.append(this->deps_);
+        storage.append(wait_list);
+        return storage;
+    }
+
+    /// Remember an event of a command in this group
+    ///
+    /// Only needed on queues that track dependencies. On other queues, the marker closing the
+    /// group waits for all previously enqueued commands anyway.
+    ///
+    /// @param evt Event of the command
+    /// @return `evt`
+    Event
+    add(const Event & evt)
+    {
+        if (this->q_.deps_ != nullptr)
+            this->events_.push_back(evt);
+        return evt;
+    }
 
     /// Queue to be handled
     Queue & q_;
+    /// Graph the commands are recorded into, `nullptr` when enqueuing directly
+    CommandGraph * graph_;
+    /// Events all commands in this group wait for
+    WaitListStorage deps_;
+    /// Events of the commands enqueued in this group
+    WaitListStorage events_;
+    /// Memory objects the next kernel reads from
+    std::vector<cl_mem> reads_;
+    /// Memory objects the next kernel writes into
+    std::vector<cl_mem> writes_;
 
     friend class Queue;
 };
 
+template <typename F>
+Event
+Queue::submit(F && f)
+{
+    Handler h(*this);
+    f(h);
+    auto evt = enqueue_marker(h.events_);
+    flush();
+    return evt;
+}
+
 } // namespace openclcpp_lite
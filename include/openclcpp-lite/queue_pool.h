@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/enums.h"
+#include "openclcpp-lite/queue.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace openclcpp_lite {
+
+/// Pool of queues with one queue per host thread
+///
+/// Every thread calling `get` receives its own queue on the same context and device, so threads
+/// enqueue work independently of each other and the work of one thread executes in order. A queue
+/// is created on the first call from a thread, later calls find it in a cache of the thread without
+/// locking. The queues are owned by the pool and released when the pool is destroyed.
+///
+/// Example:
+/// ```
+/// QueuePool pool(ctx, dev);
+/// std::vector<std::thread> workers;
+/// for (int i = 0; i < 4; i++)
+///     workers.emplace_back([&]() {
+///         auto q = pool.get();
+///         ...
+///         q.wait();
+///     });
+/// ```
+class QueuePool {
+public:
+    /// Create a pool on the default context and device
+    QueuePool();
+
+    /// Create a pool
+    ///
+    /// @param context OpenCL context
+    /// @param device Device the queues are created on
+    QueuePool(const Context & context, const Device & device);
+
+    /// Create a pool
+    ///
+    /// @param context OpenCL context
+    /// @param device Device the queues are created on
+    /// @param properties Properties of the created queues
+    QueuePool(const Context & context, const Device & device, QueueProperties properties);
+
+    QueuePool(const QueuePool &) = delete;
+    QueuePool & operator=(const QueuePool &) = delete;
+
+    /// Get the queue of the calling thread. The queue is created on the first call from a thread.
+    ///
+    /// @return Queue of the calling thread
+    Queue get();
+
+    /// Number of queues created so far
+    std::size_t size() const;
+
+    /// Block until all commands in all queues of the pool have completed
+    void wait() const;
+
+private:
+    /// Context the queues are created in
+    Context context_;
+    /// Device the queues are created on
+    Device device_;
+    /// Properties of the created queues
+    QueueProperties properties_;
+    /// Identifies the pool in the per-thread caches, never reused by another pool
+    std::uint64_t id_;
+    /// Guards `queues_`
+    mutable std::mutex mutex_;
+    /// Queues of the threads, in the order they were created. A deque keeps the queues in place
+    /// when new ones are added, so threads can use theirs without locking.
+    std::deque<Queue> queues_;
+};
+
+} // namespace openclcpp_lite
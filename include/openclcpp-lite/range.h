@@ -33,6 +33,11 @@ public:
         }
     }
 
+    /// Create N-dimensional range
+    ///
+    /// @param size Sizes of the range in each dimension
+    explicit Range(const std::array<size_t, N> & size) : sz_(size), dims_(N) {}
+
     operator const size_t *() const { return this->sz_.data(); }
 
     /// Runtime number of dimensions
@@ -77,4 +82,87 @@ private:
     cl_uint dims_;
 };
 
+/// N-dimensional index space of a kernel launch
+///
+/// Consists of a global range, an optional local (work-group) range and an optional global offset.
+/// Empty local range leaves the work-group size up to the OpenCL implementation.
+///
+/// @tparam N Number of dimensions
+template <int N>
+class NDRange {
+public:
+    /// Create an index space with a global range only
+    ///
+    /// @param global Global range
+    NDRange(const Range<N> & global) : global_(global) {}
+
+    /// Create an index space with explicit work-group size
+    ///
+    /// @param global Global range
+    /// @param local Local range
+    NDRange(const Range<N> & global, const Range<N> & local) : global_(global), local_(local) {}
+
+    /// Create an index space with explicit work-group size and a global offset
+    ///
+    /// @param global Global range
+    /// @param local Local range, can be empty
+    /// @param offset Global offset
+    NDRange(const Range<N> & global, const Range<N> & local, const Range<N> & offset) :
+        global_(global),
+        local_(local),
+        offset_(offset)
+    {
+    }
+
+    /// Runtime number of dimensions
+    size_t
+    dimensions() const
+    {
+        return this->global_.dimensions();
+    }
+
+    /// Global range
+    const Range<N> &
+    global() const
+    {
+        return this->global_;
+    }
+
+    /// Local range
+    const Range<N> &
+    local() const
+    {
+        return this->local_;
+    }
+
+    /// Global offset
+    const Range<N> &
+    offset() const
+    {
+        return this->offset_;
+    }
+
+    /// Pointer to local sizes to pass into OpenCL, `nullptr` if the local range is empty
+    const size_t *
+    local_ptr() const
+    {
+        return this->local_.dimensions() == 0 ? nullptr : (const size_t *) this->local_;
+    }
+
+    /// Pointer to the global offset to pass into OpenCL, `nullptr` if the offset is empty
+    const size_t *
+    offset_ptr() const
+    {
+        return this->offset_.dimensions() == 0 ? nullptr : (const size_t *) this->offset_;
+    }
+
+private:
+    /// Global range
+    Range<N> global_;
+    /// Local range
+    Range<N> local_;
+    /// Global offset
+    Range<N> offset_;
+};
+
 } // namespace openclcpp_lite
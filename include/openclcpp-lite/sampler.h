@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/templ.h"
+#include "openclcpp-lite/enums.h"
+
+namespace openclcpp_lite {
+
+class Context;
+
+/// OpenCL sampler, describes how a kernel reads an image
+///
+/// Owns a reference to the underlying OpenCL sampler. Copies share the sampler and bump its
+/// reference count, the reference is released when the object is destroyed.
+class Sampler {
+public:
+    /// Create a null sampler
+    Sampler();
+
+    /// Create a sampler from an OpenCL sampler
+    ///
+    /// @param sampler OpenCL sampler
+    /// @param retain Increment the reference count of `sampler`. By default, the new object takes
+    ///        over the reference held by the caller.
+    explicit Sampler(cl_sampler sampler, bool retain = false);
+
+    /// Create a sampler
+    ///
+    /// @param context OpenCL context
+    /// @param normalized_coords `true` if image coordinates are normalized to [0, 1)
+    /// @param addressing_mode How out-of-range image coordinates are handled
+    /// @param filter_mode Filter applied when reading the image
+    Sampler(const Context & context,
+            bool normalized_coords,
+            AddressingMode addressing_mode = ADDRESS_CLAMP_TO_EDGE,
+            FilterMode filter_mode = FILTER_NEAREST);
+
+    Sampler(const Sampler & other);
+    Sampler(Sampler && other) noexcept;
+    ~Sampler();
+
+    Sampler & operator=(const Sampler & other);
+    Sampler & operator=(Sampler && other) noexcept;
+
+    /// Increments the sampler reference count
+    void retain() const;
+
+    /// Decrements the sampler reference count
+    void release() const;
+
+    /// Return the sampler reference count.
+    unsigned int reference_count() const;
+
+    /// Return the context associated with the sampler.
+    Context context() const;
+
+    /// Return `true` if image coordinates are normalized
+    bool normalized_coords() const;
+
+    /// Return the addressing mode
+    AddressingMode addressing_mode() const;
+
+    /// Return the filter mode
+    FilterMode filter_mode() const;
+
+    operator cl_sampler() const;
+
+private:
+    template <typename T>
+    T
+    get_info(cl_sampler_info name) const
+    {
+        T val;
+        get_info_helper(clGetSamplerInfo, this->sampler_, name, val);
+        return val;
+    }
+
+    /// Underlying OpenCL sampler
+    cl_sampler sampler_;
+};
+
+} // namespace openclcpp_lite
@@ -0,0 +1,295 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/enums.h"
+#include "openclcpp-lite/event.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/range.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <source_location>
+#include <span>
+#include <vector>
+
+namespace openclcpp_lite {
+
+/// 1-dimensional array split across several buffers
+///
+/// A single OpenCL buffer cannot be larger than `Device::max_mem_alloc_size()`, which is often a
+/// fraction of the global memory. A sharded buffer holds one logical array in consecutive shards
+/// of at most that size. Element `i` lives in shard `i / shard_size()` at index
+/// `i % shard_size()`.
+///
+/// Uploads, downloads and fills are routed to the shards that cover the requested elements.
+/// `launch` runs a kernel once per shard, with the global offset set to the index of the first
+/// element of the shard. A kernel finds the element in its shard buffer with
+/// `get_global_id(0) - get_global_offset(0)`, and `get_global_id(0)` is the index into the logical
+/// array.
+///
+/// Example:
+/// ```
+/// ShardedBuffer<float> d_a(ctx, n);
+/// d_a.upload(q, h_a);
+/// d_a.launch(q, [&](size_t i) -> const Kernel & { return scale(d_a.shard(i), 2.f); });
+/// Event::wait(d_a.download(q, h_a));
+/// ```
+///
+/// @tparam T C++ type of the data element this buffer stores
+template <typename T>
+class ShardedBuffer {
+public:
+    using type = T;
+
+    /// Create an uninitialized buffer in the default Context
+    ///
+    /// @param n Number of elements
+    /// @param mem_flags Memory flags of the shards
+    /// @param loc Source location recorded by `MemoryAccounting`
+    explicit ShardedBuffer(std::size_t n,
+                           MemoryFlags mem_flags = READ_WRITE,
+                           std::source_location loc = std::source_location::current()) :
+        ShardedBuffer(Context::get_default(), n, mem_flags, loc)
+    {
+    }
+
+    /// Create an uninitialized buffer with shards as large as all devices of a context allow
+    ///
+    /// @param context OpenCL context
+    /// @param n Number of elements
+    /// @param mem_flags Memory flags of the shards
+    /// @param loc Source location recorded by `MemoryAccounting`
+    ShardedBuffer(const Context & context,
+                  std::size_t n,
+                  MemoryFlags mem_flags = READ_WRITE,
+                  std::source_location loc = std::source_location::current()) :
+        ShardedBuffer(context, n, mem_flags, max_shard_size(context), loc)
+    {
+    }
+
+    /// Create an uninitialized buffer with a given shard size
+    ///
+    /// @param context OpenCL context
+    /// @param n Number of elements
+    /// @param mem_flags Memory flags of the shards
+    /// @param shard_size Maximum number of elements in a shard
+    /// @param loc Source location recorded by `MemoryAccounting`
+    ShardedBuffer(const Context & context,
+                  std::size_t n,
+                  MemoryFlags mem_flags,
+                  std::size_t shard_size,
+                  std::source_location loc = std::source_location::current()) :
+        n_(n),
+        shard_size_(shard_size)
+    {
+        assert(shard_size > 0);
+        for (std::size_t ofs = 0; ofs < n; ofs += shard_size) {
+            auto len = std::min(shard_size, n - ofs);
+            this->shards_.emplace_back(context, Range<1> { len }, mem_flags, loc);
+        }
+    }
+
+    /// Number of elements
+    std::size_t
+    size() const
+    {
+        return this->n_;
+    }
+
+    /// Maximum number of elements in a shard
+    std::size_t
+    shard_size() const
+    {
+        return this->shard_size_;
+    }
+
+    /// Number of shards
+    std::size_t
+    num_of_shards() const
+    {
+        return this->shards_.size();
+    }
+
+    /// Buffer of a shard
+    ///
+    /// @param i Shard index
+    const Buffer<T> &
+    shard(std::size_t i) const
+    {
+        return this->shards_[i];
+    }
+
+    /// Index of the first element of a shard
+    ///
+    /// @param i Shard index
+    std::size_t
+    shard_offset(std::size_t i) const
+    {
+        return i * this->shard_size_;
+    }
+
+    /// Enqueue commands to write host memory into the buffer in non-blocking mode
+    ///
+    /// `src` must stay valid until the returned events complete.
+    ///
+    /// @param queue Queue
+    /// @param src Host memory with the elements to write
+    /// @param origin Index of the first element written
+    /// @param wait_list Specify events that need to complete before the commands can be executed
+    /// @return Events of the write commands, one per shard touched
+    std::vector<Event>
+    upload(const Queue & queue,
+           std::span<const T> src,
+           std::size_t origin = 0,
+           WaitList wait_list = WaitList()) const
+    {
+        assert(origin + src.size() <= this->n_);
+        std::vector<Event> events;
+        for_each_window(origin, src.size(), [&](std::size_t i, std::size_t ofs, std::size_t at) {
+            auto len = std::min(this->shard_size_ - ofs, src.size() - at);
+            events.push_back(queue.copy(src.data() + at,
+                                        this->shards_[i],
+                                        Range<1> { ofs },
+                                        Range<1> { len },
+                                        wait_list));
+            return len;
+        });
+        return events;
+    }
+
+    /// Enqueue commands to read the buffer into host memory in non-blocking mode
+    ///
+    /// `dest` must stay valid until the returned events complete.
+    ///
+    /// @param queue Queue
+    /// @param dest Host memory receiving the elements
+    /// @param origin Index of the first element read
+    /// @param wait_list Specify events that need to complete before the commands can be executed
+    /// @return Events of the read commands, one per shard touched
+    std::vector<Event>
+    download(const Queue & queue,
+             std::span<T> dest,
+             std::size_t origin = 0,
+             WaitList wait_list = WaitList()) const
+    {
+        assert(origin + dest.size() <= this->n_);
+        std::vector<Event> events;
+        for_each_window(origin, dest.size(), [&](std::size_t i, std::size_t ofs, std::size_t at) {
+            auto len = std::min(this->shard_size_ - ofs, dest.size() - at);
+            events.push_back(queue.copy(this->shards_[i],
+                                        dest.data() + at,
+                                        Range<1> { ofs },
+                                        Range<1> { len },
+                                        wait_list));
+            return len;
+        });
+        return events;
+    }
+
+    /// Enqueue commands to fill elements of the buffer with a value
+    ///
+    /// @param queue Queue
+    /// @param value Value to fill with
+    /// @param origin Index of the first element filled
+    /// @param count Number of elements to fill
+    /// @param wait_list Specify events that need to complete before the commands can be executed
+    /// @return Events of the fill commands, one per shard touched
+    std::vector<Event>
+    fill(const Queue & queue,
+         const T & value,
+         std::size_t origin,
+         std::size_t count,
+         WaitList wait_list = WaitList()) const
+    {
+        assert(origin + count <= this->n_);
+        std::vector<Event> events;
+        for_each_window(origin, count, [&](std::size_t i, std::size_t ofs, std::size_t at) {
+            auto len = std::min(this->shard_size_ - ofs, count - at);
+            events.push_back(queue.fill(this->shards_[i],
+                                        value,
+                                        Range<1> { ofs },
+                                        Range<1> { len },
+                                        wait_list));
+            return len;
+        });
+        return events;
+    }
+
+    /// Enqueue commands to fill the whole buffer with a value
+    ///
+    /// @param queue Queue
+    /// @param value Value to fill with
+    /// @param wait_list Specify events that need to complete before the commands can be executed
+    /// @return Events of the fill commands, one per shard
+    std::vector<Event>
+    fill(const Queue & queue, const T & value, WaitList wait_list = WaitList()) const
+    {
+        return fill(queue, value, 0, this->n_, wait_list);
+    }
+
+    /// Run a kernel over all elements, once per shard
+    ///
+    /// `f` is called with the index of a shard and returns the kernel with its arguments set for
+    /// that shard (e.g. from a `KernelFunctor`). The kernel is enqueued over the elements of the
+    /// shard before `f` is called for the next shard.
+    ///
+    /// @param queue Queue
+    /// @param f Callable taking a shard index and returning a `const Kernel &`
+    /// @return Event that completes when the kernels of all shards have completed
+    template <typename F>
+    Event
+    launch(Queue & queue, F && f) const
+    {
+        return queue.submit([&](Handler & h) {
+            for (std::size_t i = 0; i < this->shards_.size(); i++) {
+                auto len = std::min(this->shard_size_, this->n_ - shard_offset(i));
+                NDRange<1> rng(Range<1> { len }, Range<1>(), Range<1> { shard_offset(i) });
+                h.kernel(f(i), rng);
+            }
+        });
+    }
+
+    /// Largest shard in elements that all devices of a context can allocate
+    ///
+    /// @param context OpenCL context
+    static std::size_t
+    max_shard_size(const Context & context)
+    {
+        std::size_t max_alloc = 0;
+        for (auto & dev : context.devices()) {
+            std::size_t sz = dev.max_mem_alloc_size();
+            max_alloc = max_alloc == 0 ? sz : std::min(max_alloc, sz);
+        }
+        return std::max<std::size_t>(max_alloc / sizeof(T), 1);
+    }
+
+private:
+    /// Call `f(shard, offset in shard, offset in the window)` for consecutive pieces of a window
+    /// of elements. `f` returns the number of elements it handled.
+    template <typename F>
+    void
+    for_each_window(std::size_t origin, std::size_t count, F && f) const
+    {
+        std::size_t at = 0;
+        while (at < count) {
+            auto idx = origin + at;
+            at += f(idx / this->shard_size_, idx % this->shard_size_, at);
+        }
+    }
+
+    /// Number of elements
+    std::size_t n_;
+    /// Maximum number of elements in a shard
+    std::size_t shard_size_;
+    /// Shards
+    std::vector<Buffer<T>> shards_;
+};
+
+} // namespace openclcpp_lite
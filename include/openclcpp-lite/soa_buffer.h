@@ -0,0 +1,221 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/enums.h"
+#include "openclcpp-lite/event.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/queue.h"
+#include <cassert>
+#include <cstddef>
+#include <source_location>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace openclcpp_lite {
+
+namespace internal {
+
+/// Record and field type of a pointer to a data member
+template <auto FIELD>
+struct FieldTraits;
+
+template <typename S, typename M, M S::*FIELD>
+struct FieldTraits<FIELD> {
+    using record_type = S;
+    using type = M;
+};
+
+} // namespace internal
+
+/// Structure-of-arrays buffer
+///
+/// Stores selected fields of a host record type as separate device buffers, one per field, so
+/// work-items reading the same field of consecutive records access contiguous memory. Records are
+/// split into the fields on upload and put back together on download, one pass per field.
+///
+/// When passed to a kernel through a `KernelFunctor`, every field takes its own kernel argument,
+/// in the order of `FIELDS`.
+///
+/// Example:
+/// ```
+/// struct Particle { cl_float4 pos; cl_float4 vel; cl_int id; };
+/// using Particles = SoABuffer<&Particle::pos, &Particle::vel>;
+///
+/// // __kernel void move(__global float4 * pos, __global const float4 * vel, float dt)
+/// Particles d_p(ctx, h_p.size());
+/// d_p.upload(q, h_p);
+/// auto move = Kernel::create<Particles, float>(prg, "move");
+/// q.submit([&](auto & h) { h.kernel(move(d_p, dt), Range<1> { h_p.size() }); });
+/// d_p.download(q, h_p);
+/// ```
+///
+/// @tparam FIELDS Pointers to the data members of the record type stored by the buffer
+template <auto... FIELDS>
+class SoABuffer {
+    static_assert(sizeof...(FIELDS) > 0, "SoABuffer needs at least one field");
+
+public:
+    /// Host record type
+    using record_type =
+        typename internal::FieldTraits<std::get<0>(std::make_tuple(FIELDS...))>::record_type;
+
+    /// Type of the `I`-th field
+    template <std::size_t I>
+    using field_type =
+        typename internal::FieldTraits<std::get<I>(std::make_tuple(FIELDS...))>::type;
+
+    /// Number of kernel arguments the buffer is passed as
+    static constexpr cl_uint NUM_KERNEL_ARGS = sizeof...(FIELDS);
+
+    /// Create an uninitialized buffer in the default Context
+    ///
+    /// @param n Number of records
+    /// @param mem_flags Memory flags of the field buffers
+    /// @param loc Source location recorded by `MemoryAccounting`
+    explicit SoABuffer(std::size_t n,
+                       MemoryFlags mem_flags = READ_WRITE,
+                       std::source_location loc = std::source_location::current()) :
+        SoABuffer(Context::get_default(), n, mem_flags, loc)
+    {
+    }
+
+    /// Create an uninitialized buffer in a context
+    ///
+    /// @param context OpenCL context
+    /// @param n Number of records
+    /// @param mem_flags Memory flags of the field buffers
+    /// @param loc Source location recorded by `MemoryAccounting`
+    SoABuffer(const Context & context,
+              std::size_t n,
+              MemoryFlags mem_flags = READ_WRITE,
+              std::source_location loc = std::source_location::current()) :
+        fields_(Buffer<typename internal::FieldTraits<FIELDS>::type>(context,
+                                                                   Range<1> { n },
+                                                                   mem_flags,
+                                                                   loc)...),
+        n_(n)
+    {
+    }
+
+    /// Number of records
+    std::size_t
+    size() const
+    {
+        return this->n_;
+    }
+
+    /// Device buffer of the `I`-th field
+    template <std::size_t I>
+    const Buffer<field_type<I>> &
+    field() const
+    {
+        return std::get<I>(this->fields_);
+    }
+
+    /// Upload records into the buffer
+    ///
+    /// Every field buffer is mapped, filled from `src` and unmapped. `src` can be released as soon
+    /// as the call returns.
+    ///
+    /// @param queue Queue used for mapping
+    /// @param src Host records, at most `size()`
+    /// @return Events of the unmap commands, the buffer holds the records once they complete
+    std::vector<Event>
+    upload(const Queue & queue, std::span<const record_type> src) const
+    {
+        assert(src.size() <= this->n_);
+        std::vector<Event> events;
+        if (src.empty())
+            return events;
+        events.reserve(sizeof...(FIELDS));
+        upload(queue, src, events, std::index_sequence_for<decltype(FIELDS)...>());
+        return events;
+    }
+
+    /// Download records from the buffer
+    ///
+    /// Only the fields stored in the buffer are written into `dest`, other members are left as
+    /// they are. The call blocks until `dest` holds the records.
+    ///
+    /// @param queue Queue used for mapping
+    /// @param dest Host records, at most `size()`
+    void
+    download(const Queue & queue, std::span<record_type> dest) const
+    {
+        assert(dest.size() <= this->n_);
+        if (dest.empty())
+            return;
+        download(queue, dest, std::index_sequence_for<decltype(FIELDS)...>());
+    }
+
+    /// Set the kernel arguments of the buffer
+    ///
+    /// @param kernel Kernel
+    /// @param index Index of the first argument
+    void
+    set_kernel_args(Kernel & kernel, cl_uint index) const
+    {
+        set_kernel_args(kernel, index, std::index_sequence_for<decltype(FIELDS)...>());
+    }
+
+private:
+    template <std::size_t... I>
+    void
+    upload(const Queue & queue,
+           std::span<const record_type> src,
+           std::vector<Event> & events,
+           std::index_sequence<I...>) const
+    {
+        (events.push_back(upload_field<I, FIELDS>(queue, src)), ...);
+    }
+
+    template <std::size_t I, auto FIELD>
+    Event
+    upload_field(const Queue & queue, std::span<const record_type> src) const
+    {
+        auto view = queue.map(field<I>(),
+                              WRITE_INVALIDATE_REGION,
+                              Range<1> { 0 },
+                              Range<1> { src.size() });
+        for (std::size_t i = 0; i < src.size(); i++)
+            view[i] = src[i].*FIELD;
+        return view.unmap();
+    }
+
+    template <std::size_t... I>
+    void
+    download(const Queue & queue, std::span<record_type> dest, std::index_sequence<I...>) const
+    {
+        (download_field<I, FIELDS>(queue, dest), ...);
+    }
+
+    template <std::size_t I, auto FIELD>
+    void
+    download_field(const Queue & queue, std::span<record_type> dest) const
+    {
+        auto view = queue.map(field<I>(), READ, Range<1> { 0 }, Range<1> { dest.size() });
+        for (std::size_t i = 0; i < dest.size(); i++)
+            dest[i].*FIELD = view[i];
+    }
+
+    template <std::size_t... I>
+    void
+    set_kernel_args(Kernel & kernel, cl_uint index, std::index_sequence<I...>) const
+    {
+        (kernel.set_arg(index + I, static_cast<const Memory &>(std::get<I>(this->fields_))), ...);
+    }
+
+    /// Device buffers of the fields
+    std::tuple<Buffer<typename internal::FieldTraits<FIELDS>::type>...> fields_;
+    /// Number of records
+    std::size_t n_;
+};
+
+} // namespace openclcpp_lite
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/event.h"
+#include <cstddef>
+#include <memory>
+#include <source_location>
+#include <span>
+
+namespace openclcpp_lite {
+
+class Queue;
+class StagingPool;
+
+/// Pinned host memory handed out by a `StagingPool`
+///
+/// The memory goes back into the pool when the object is destroyed. If commands still use the
+/// memory, call `in_use_until` first, so that the pool does not hand it out again before they
+/// complete.
+class StagingBuffer {
+public:
+    StagingBuffer(const StagingBuffer &) = delete;
+    StagingBuffer(StagingBuffer && other) noexcept;
+    ~StagingBuffer();
+
+    StagingBuffer & operator=(const StagingBuffer &) = delete;
+
+    /// Pointer to the pinned host memory
+    void * data() const;
+
+    /// Size of the staging buffer in bytes
+    std::size_t size() const;
+
+    /// Pinned host memory as a span of bytes
+    std::span<std::byte> span() const;
+
+    /// Pinned host memory as a span of `T`
+    template <typename T>
+    std::span<T>
+    as() const
+    {
+        return std::span<T>(static_cast<T *>(data()), size() / sizeof(T));
+    }
+
+    /// Keep the memory out of the pool until a command completes
+    ///
+    /// @param evt Event of the last command using the memory
+    void in_use_until(const Event & evt);
+
+private:
+    struct Block;
+
+    StagingBuffer(std::shared_ptr<void> pool, Block * block, std::size_t size);
+
+    /// Keeps the pool alive while the memory is handed out
+    std::shared_ptr<void> pool_;
+    /// Block of the pool
+    Block * block_;
+    /// Requested size
+    std::size_t size_;
+
+    friend class StagingPool;
+};
+
+/// Pool of pinned host memory for host-device transfers
+///
+/// The pool allocates `ALLOC_HOST_PTR` buffers, maps them once and keeps them mapped, so the
+/// OpenCL implementation can transfer data from and to them without copying through pageable
+/// memory first. Blocks are reused once the commands that used them have completed.
+///
+/// A queue with a staging pool (see `Queue::set_staging_pool`) automatically stages transfers
+/// between host memory and buffers of at least `threshold()` bytes through the pool.
+///
+/// Example:
+/// ```
+/// auto q = Queue::get_default();
+/// q.set_staging_pool(std::make_shared<StagingPool>(q));
+/// q.copy(h_a.data(), d_a, rng).wait();
+/// ```
+class StagingPool {
+public:
+    /// Create a staging pool
+    ///
+    /// @param queue Queue used to map the pinned buffers. The pool allocates memory in the context
+    ///        of this queue.
+    /// @param threshold Transfers of at least this many bytes are staged by queues using the pool
+    /// @param loc Source location `MemoryAccounting` records for the memory of the pool
+    explicit StagingPool(const Queue & queue,
+                         std::size_t threshold = DEFAULT_THRESHOLD,
+                         std::source_location loc = std::source_location::current());
+
+    StagingPool(const StagingPool &) = delete;
+    StagingPool & operator=(const StagingPool &) = delete;
+
+    /// Get pinned host memory
+    ///
+    /// @param size Size in bytes
+    /// @return Staging buffer of `size` bytes
+    StagingBuffer acquire(std::size_t size);
+
+    /// Size from which queues stage transfers through the pool
+    std::size_t threshold() const;
+
+    /// Number of bytes of pinned memory allocated by the pool
+    std::size_t capacity() const;
+
+    /// Release blocks that are not handed out
+    void trim();
+
+private:
+    struct Data;
+
+    /// Default size from which transfers are staged
+    static constexpr std::size_t DEFAULT_THRESHOLD = 1024 * 1024;
+    /// Smallest block allocated by the pool
+    static constexpr std::size_t MIN_BLOCK_SIZE = 64 * 1024;
+
+    /// Blocks of the pool, shared with the handed out staging buffers
+    std::shared_ptr<Data> data_;
+    /// Transfer size from which queues stage
+    std::size_t threshold_;
+
+    friend class StagingBuffer;
+};
+
+} // namespace openclcpp_lite
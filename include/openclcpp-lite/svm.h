@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+
+#ifdef CL_VERSION_2_0
+
+    #include "openclcpp-lite/context.h"
+    #include "openclcpp-lite/enums.h"
+    #include <cstddef>
+    #include <new>
+    #include <vector>
+
+namespace openclcpp_lite {
+
+/// Allocator of shared virtual memory (SVM)
+///
+/// SVM is addressed by the same pointers on the host and on the devices of the context, so
+/// pointer-based data structures (lists, trees, graphs) built on the host can be passed to kernels
+/// as they are. Pointers are passed to kernels wrapped in `SVMPointer` (see `svm_ptr`).
+///
+/// Coarse-grained memory (the default) may be accessed by the host only while it is mapped with
+/// `Queue::svm_map`. This includes constructing elements, so an `SVMVector` in coarse-grained
+/// memory is created empty, sized with `reserve` and filled while mapped. Fine-grained memory
+/// (`SVM_FINE_GRAIN_BUFFER`, see `Device::svm_capabilities`) can be accessed by the host and the
+/// devices without mapping.
+///
+/// Example:
+/// ```
+/// SVMVector<Node> nodes;
+/// nodes.reserve(n);
+/// q.svm_map(nodes.data(), n, WRITE);
+/// for (int i = 0; i < n; i++)
+///     nodes.push_back({ i, i + 1 < n ? nodes.data() + i + 1 : nullptr });
+/// q.svm_unmap(nodes.data());
+/// q.submit([&](Handler & h) { h.kernel(sum_list(svm_ptr(nodes.data()), d_out), rng); });
+/// ```
+///
+/// @tparam T C++ type of the allocated elements
+template <typename T>
+class SVMAllocator {
+public:
+    using value_type = T;
+
+    /// Create an allocator of coarse-grained memory in the default context
+    SVMAllocator() : context_(Context::get_default()), flags_(READ_WRITE) {}
+
+    /// Create an allocator
+    ///
+    /// @param context OpenCL context
+    /// @param mem_flags Memory flags, add `SVM_FINE_GRAIN_BUFFER` (and `SVM_ATOMICS`) for
+    ///        fine-grained memory
+    explicit SVMAllocator(const Context & context, MemoryFlags mem_flags = READ_WRITE) :
+        context_(context),
+        flags_(mem_flags)
+    {
+    }
+
+    template <typename U>
+    SVMAllocator(const SVMAllocator<U> & other) : context_(other.context()), flags_(other.flags())
+    {
+    }
+
+    T *
+    allocate(std::size_t n)
+    {
+        auto * ptr = clSVMAlloc(this->context_, this->flags_, n * sizeof(T), alignof(T));
+        if (ptr == nullptr)
+            throw std::bad_alloc();
+        return static_cast<T *>(ptr);
+    }
+
+    void
+    deallocate(T * ptr, std::size_t)
+    {
+        clSVMFree(this->context_, ptr);
+    }
+
+    /// Context the memory is allocated in
+    const Context &
+    context() const
+    {
+        return this->context_;
+    }
+
+    /// Memory flags of the allocations
+    MemoryFlags
+    flags() const
+    {
+        return this->flags_;
+    }
+
+    /// Check if the allocations are fine-grained
+    bool
+    fine_grained() const
+    {
+        return this->flags_ & SVM_FINE_GRAIN_BUFFER;
+    }
+
+    template <typename U>
+    bool
+    operator==(const SVMAllocator<U> & other) const
+    {
+        return this->context_ == other.context() &&
+               (cl_mem_flags) this->flags_ == (cl_mem_flags) other.flags();
+    }
+
+private:
+    /// Context the memory is allocated in
+    Context context_;
+    /// Memory flags
+    MemoryFlags flags_;
+};
+
+/// Vector in shared virtual memory
+template <typename T>
+using SVMVector = std::vector<T, SVMAllocator<T>>;
+
+/// Pointer into shared virtual memory passed as a kernel argument
+///
+/// Kernel arguments of this type are set with `clSetKernelArgSVMPointer`, other pointers are
+/// passed by value like any other argument.
+///
+/// @tparam T C++ type of the pointed-to elements
+template <typename T>
+class SVMPointer {
+public:
+    /// Wrap a pointer
+    ///
+    /// @param ptr Pointer into memory from an `SVMAllocator`
+    explicit SVMPointer(T * ptr) : ptr_(ptr) {}
+
+    /// Wrapped pointer
+    T *
+    get() const
+    {
+        return this->ptr_;
+    }
+
+private:
+    /// Pointer into shared virtual memory
+    T * ptr_;
+};
+
+/// Wrap a pointer into shared virtual memory to be passed as a kernel argument
+///
+/// @param ptr Pointer into memory from an `SVMAllocator`
+/// @return Kernel argument
+template <typename T>
+SVMPointer<T>
+svm_ptr(T * ptr)
+{
+    return SVMPointer<T>(ptr);
+}
+
+} // namespace openclcpp_lite
+
+#endif
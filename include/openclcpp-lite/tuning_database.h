@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/range.h"
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace openclcpp_lite {
+
+class Kernel;
+class Device;
+
+/// Persistent database of tuned work-group sizes
+///
+/// Entries are keyed by the kernel function name, a hash of the device name, vendor and version,
+/// and a problem-size bucket (`log2` of the global size in each dimension). Every entry remembers
+/// the hash of the program source (of the program binaries for programs created from binaries)
+/// and the driver version it was tuned with; entries that do not match the current program or
+/// driver are ignored and dropped. Since the key does not depend on
+/// the particular machine, databases can be exported and imported between machines with the same
+/// hardware.
+///
+/// Example:
+/// ```
+/// auto db = std::make_shared<TuningDatabase>("tuning.db");
+/// tuner.set_database(db);
+/// q.set_tuning_database(db);
+/// ...
+/// db->save();
+/// ```
+class TuningDatabase {
+public:
+    /// Create an empty in-memory database
+    TuningDatabase();
+
+    /// Create a database backed by a file. Entries are loaded from the file if it exists.
+    ///
+    /// @param file_name File the database is stored in
+    explicit TuningDatabase(const std::string & file_name);
+
+    /// File the database is stored in, empty for in-memory databases
+    const std::string & file_name() const;
+
+    /// Look up the tuned local range of a kernel
+    ///
+    /// @param kernel Kernel
+    /// @param device Device the kernel runs on
+    /// @param global Global range
+    /// @param local Tuned local range, set only if a valid entry was found
+    /// @return `true` if a valid entry was found, `false` otherwise
+    template <int N>
+    bool
+    lookup(const Kernel & kernel, const Device & device, const Range<N> & global, Range<N> & local)
+    {
+        std::array<size_t, N> sz;
+        if (!lookup_raw(kernel, device, global.dimensions(), global, sz.data()))
+            return false;
+        local = Range<N>(sz);
+        return true;
+    }
+
+    /// Store the tuned local range of a kernel
+    ///
+    /// @param kernel Kernel
+    /// @param device Device the kernel was tuned on
+    /// @param global Global range
+    /// @param local Tuned local range
+    template <int N>
+    void
+    store(const Kernel & kernel,
+          const Device & device,
+          const Range<N> & global,
+          const Range<N> & local)
+    {
+        store_raw(kernel, device, global.dimensions(), global, local);
+    }
+
+    /// Number of entries
+    std::size_t size() const;
+
+    /// Remove all entries
+    void clear();
+
+    /// Write the database into its file
+    void save() const;
+
+    /// Write the database into a file
+    ///
+    /// @param file_name File to write into
+    void export_to(const std::string & file_name) const;
+
+    /// Merge entries from a file into the database. Entries from the file replace existing ones.
+    ///
+    /// @param file_name File to read from
+    void import_from(const std::string & file_name);
+
+private:
+    struct Key {
+        /// Kernel function name
+        std::string function;
+        /// Hash of the device identification
+        uint64_t device;
+        /// Number of dimensions
+        cl_uint dims;
+        /// Problem-size bucket in each dimension
+        std::array<uint32_t, 3> bucket;
+
+        bool operator<(const Key & other) const;
+    };
+
+    struct Entry {
+        /// Tuned local size
+        std::array<size_t, 3> local;
+        /// Hash of the program source
+        uint64_t source;
+        /// Driver version
+        std::string driver;
+    };
+
+    struct DeviceInfo {
+        uint64_t hash;
+        std::string driver;
+    };
+
+    struct SourceInfo {
+        /// Reference to the program, so its handle is not reused while it is cached
+        Program program;
+        uint64_t hash;
+    };
+
+    bool lookup_raw(const Kernel & kernel,
+                    const Device & device,
+                    cl_uint dims,
+                    const size_t * global,
+                    size_t * local);
+
+    void store_raw(const Kernel & kernel,
+                   const Device & device,
+                   cl_uint dims,
+                   const size_t * global,
+                   const size_t * local);
+
+    Key
+    key(const Kernel & kernel, const DeviceInfo & dev, cl_uint dims, const size_t * global) const;
+
+    /// Hash of the source of the program a kernel belongs to, or of its binaries if the program
+    /// has no source
+    uint64_t source_hash(const Kernel & kernel);
+
+    /// Identification of a device
+    const DeviceInfo & device_info(const Device & device);
+
+    /// Read entries from a file
+    void read(const std::string & file_name, std::map<Key, Entry> & entries) const;
+
+    /// Atomically write entries into a file
+    void write(const std::string & file_name) const;
+
+    /// File the database is stored in
+    std::string file_name_;
+    /// Guards all members below
+    mutable std::mutex mutex_;
+    /// Entries
+    std::map<Key, Entry> entries_;
+    /// Source hashes per program
+    std::unordered_map<cl_program, SourceInfo> sources_;
+    /// Identification per device
+    std::unordered_map<cl_device_id, DeviceInfo> devices_;
+
+    friend class Queue;
+    friend class WorkGroupTuner;
+};
+
+} // namespace openclcpp_lite
@@ -7,6 +7,7 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <cstdint>
 
 namespace openclcpp_lite {
 namespace utils {
@@ -46,5 +47,28 @@ std::vector<char> read_file_bin(const std::string & file_name);
 /// @param bin Binary blob to write
 void write_file_bin(const std::string & file_name, const std::vector<char> & bin);
 
+/// Compute 64-bit FNV-1a hash of a memory block
+///
+/// The hash is stable across processes and machines, so it can be used for on-disk keys.
+///
+/// @param data Pointer to the memory block
+/// @param size Size of the memory block in bytes
+/// @param seed Initial hash value. Use a previous result to hash several blocks together.
+/// @return Hash value
+uint64_t hash_bytes(const void * data, size_t size, uint64_t seed = 14695981039346656037ULL);
+
+/// Compute 64-bit FNV-1a hash of a string
+///
+/// @param str String to hash
+/// @param seed Initial hash value. Use a previous result to hash several strings together.
+/// @return Hash value
+uint64_t hash(const std::string & str, uint64_t seed = 14695981039346656037ULL);
+
+/// Convert a 64-bit value into a fixed-width (16 characters) hexadecimal string
+///
+/// @param value Value to convert
+/// @return Hexadecimal representation of `value`
+std::string to_hex(uint64_t value);
+
 } // namespace utils
 } // namespace openclcpp_lite
@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/enums.h"
+#include "openclcpp-lite/error.h"
+#include "openclcpp-lite/queue.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace openclcpp_lite {
+
+/// Distributes 1-dimensional work across the devices of a context
+///
+/// The work is split into one contiguous part per device, sized by the number of compute units of
+/// the device. Buffers are split into sub-buffers along the same parts with `scatter`, which also
+/// migrates every sub-buffer to its device. The transfers are then done before the kernels run
+/// rather than when the first kernel on a device touches the data.
+///
+/// Every device gets its own in-order queue, so the kernels of a part run after its migrations.
+/// Work on other queues is ordered with the migration events returned by `scatter`.
+///
+/// Example:
+/// ```
+/// WorkDistributor dist(Context(devices));
+/// auto parts = dist.partition<float>(n);
+/// auto [a, a_migrated] = dist.scatter(d_a, parts, Flags<MigrationFlag>(), upload);
+/// auto [b, b_migrated] = dist.scatter(d_b, parts, MIGRATE_CONTENT_UNDEFINED);
+/// for (size_t i = 0; i < parts.size(); i++)
+///     dist.queue(parts[i].device).submit([&](auto & h) {
+///         h.kernel(square(a[i], b[i]), Range<1> { parts[i].size });
+///     });
+/// dist.wait();
+/// ```
+class WorkDistributor {
+public:
+    /// Part of the work assigned to one device
+    struct Part {
+        /// Index of the device in `Context::devices()`
+        std::size_t device;
+        /// Index of the first work item
+        std::size_t offset;
+        /// Number of work items
+        std::size_t size;
+    };
+
+    /// Create a distributor for the devices of a context
+    ///
+    /// @param context OpenCL context
+    explicit WorkDistributor(const Context & context);
+
+    /// Context the work is distributed in
+    const Context & context() const;
+
+    /// Number of devices
+    std::size_t num_of_devices() const;
+
+    /// Queue of a device
+    ///
+    /// @param device Index of the device in `Context::devices()`
+    Queue queue(std::size_t device) const;
+
+    /// Split work items into parts
+    ///
+    /// Devices get a share of the work proportional to their number of compute units. Devices
+    /// whose share would be empty get no part.
+    ///
+    /// @param n Number of work items
+    /// @param granularity Offsets of the parts are multiples of this number
+    /// @return Parts, ordered by offset
+    std::vector<Part> partition(std::size_t n, std::size_t granularity = 1) const;
+
+    /// Split elements of type `T` into parts that can be used as sub-buffers
+    ///
+    /// @param n Number of elements
+    /// @return Parts, ordered by offset
+    template <typename T>
+    std::vector<Part>
+    partition(std::size_t n) const
+    {
+        return partition(n, granularity(sizeof(T)));
+    }
+
+    /// Smallest number of elements of `elem_size` bytes that keeps a sub-buffer origin aligned to
+    /// the base address alignment of all devices
+    ///
+    /// @param elem_size Size of an element in bytes
+    std::size_t granularity(std::size_t elem_size) const;
+
+    /// Split a buffer into sub-buffers and migrate them to their devices
+    ///
+    /// @param buffer Buffer to split
+    /// @param parts Parts from `partition`
+    /// @param flags Migration flags, `MIGRATE_CONTENT_UNDEFINED` for buffers that are only written
+    ///        by the kernels
+    /// @param wait_list Specify events that need to complete before the migrations can be
+    ///        executed, e.g. the upload of `buffer`
+    /// @return One sub-buffer per part and the events of their migrations
+    template <typename T>
+    std::pair<std::vector<Buffer<T>>, std::vector<Event>>
+    scatter(const Buffer<T> & buffer,
+            const std::vector<Part> & parts,
+            MigrationFlags flags = Flags<MigrationFlag>(),
+            WaitList wait_list = WaitList()) const
+    {
+        std::vector<Buffer<T>> subs;
+        std::vector<Event> events;
+        subs.reserve(parts.size());
+        events.reserve(parts.size());
+        for (auto & p : parts) {
+            cl_buffer_region region = { p.offset * sizeof(T), p.size * sizeof(T) };
+            cl_int err;
+            auto mem = clCreateSubBuffer(buffer, 0, CL_BUFFER_CREATE_TYPE_REGION, &region, &err);
+            OPENCL_CHECK(err);
+            auto & sub = subs.emplace_back(mem);
+            events.push_back(queue(p.device).migrate(sub, flags, wait_list));
+        }
+        return { std::move(subs), std::move(events) };
+    }
+
+    /// Flush the queues of all devices
+    void flush() const;
+
+    /// Block until all commands in the queues of all devices have completed
+    void wait() const;
+
+private:
+    /// Context the work is distributed in
+    Context context_;
+    /// Queue per device
+    std::vector<Queue> queues_;
+    /// Number of compute units per device
+    std::vector<std::size_t> weights_;
+    /// Base address alignment of the devices in bytes
+    std::size_t alignment_;
+};
+
+} // namespace openclcpp_lite
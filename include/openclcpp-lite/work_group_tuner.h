@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "openclcpp-lite/cl.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/range.h"
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace openclcpp_lite {
+
+class Context;
+class TuningDatabase;
+
+/// Finds the fastest work-group size of a kernel by timing candidate local ranges
+///
+/// Candidates are powers of two in each dimension that divide the global range and fit into
+/// `Device::max_work_item_sizes()`, `Device::max_work_group_size()` and
+/// `Kernel::work_group_size()`. The kernel is launched with its current arguments, so it must be
+/// safe to run repeatedly. The winner is remembered per kernel and global range and returned
+/// without timing on subsequent calls. With a `TuningDatabase` set, results are also looked up
+/// from and stored into the database, so they survive restarts.
+///
+/// Example:
+/// ```
+/// WorkGroupTuner tuner;
+/// q.submit([&](Handler & h) {
+///     h.kernel(vec_add(d_a, d_b, d_c), tuner.range(vec_add(d_a, d_b, d_c), rng));
+/// });
+/// ```
+class WorkGroupTuner {
+public:
+    /// Create a tuner for the default device
+    WorkGroupTuner();
+
+    /// Create a tuner
+    ///
+    /// @param context OpenCL context
+    /// @param device Device the kernels are tuned for
+    WorkGroupTuner(const Context & context, const Device & device);
+
+    /// Number of timed launches per candidate
+    unsigned int repetitions() const;
+
+    /// Set the number of timed launches per candidate. The fastest launch is used.
+    ///
+    /// @param n Number of timed launches
+    void set_repetitions(unsigned int n);
+
+    /// Set the database the results are stored into and looked up from
+    ///
+    /// @param db Tuning database, `nullptr` to use none
+    void set_database(std::shared_ptr<TuningDatabase> db);
+
+    /// Get the database the results are stored into
+    std::shared_ptr<TuningDatabase> database() const;
+
+    /// Find the fastest local range for a kernel
+    ///
+    /// @param kernel Kernel with all arguments set
+    /// @param global Global range
+    /// @return Fastest local range
+    template <int N>
+    Range<N>
+    tune(const Kernel & kernel, const Range<N> & global)
+    {
+        auto best = tune_raw(kernel, global.dimensions(), global);
+        std::array<size_t, N> local;
+        for (int i = 0; i < N; i++)
+            local[i] = best[i];
+        return Range<N>(local);
+    }
+
+    /// Get the index space with the fastest local range for a kernel
+    ///
+    /// @param kernel Kernel with all arguments set
+    /// @param global Global range
+    /// @return Index space to launch the kernel with
+    template <int N>
+    NDRange<N>
+    range(const Kernel & kernel, const Range<N> & global)
+    {
+        return NDRange<N>(global, tune(kernel, global));
+    }
+
+    /// Number of remembered results
+    std::size_t size() const;
+
+    /// Forget all remembered results
+    void clear();
+
+private:
+    using Key = std::tuple<cl_kernel, cl_uint, std::array<size_t, 3>>;
+
+    std::array<size_t, 3> tune_raw(const Kernel & kernel, cl_uint dims, const size_t * global);
+
+    /// Candidate local sizes
+    std::vector<std::array<size_t, 3>>
+    candidates(const Kernel & kernel, cl_uint dims, const size_t * global) const;
+
+    /// Time a kernel launch
+    ///
+    /// @return Fastest execution time in nanoseconds, or 0 if the local size was refused
+    uint64_t time(const Kernel & kernel,
+                  cl_uint dims,
+                  const size_t * global,
+                  const size_t * local) const;
+
+    /// Device the kernels are tuned for
+    Device device_;
+    /// Profiling queue used for timing
+    Queue queue_;
+    /// Number of timed launches per candidate
+    unsigned int reps_;
+    /// Guards `cache_`
+    mutable std::mutex mutex_;
+    /// Remembered results
+    std::map<Key, std::array<size_t, 3>> cache_;
+    /// Persistent database of results
+    std::shared_ptr<TuningDatabase> db_;
+};
+
+} // namespace openclcpp_lite
@@ -0,0 +1,742 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "openclcpp-lite/command_graph.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/memory.h"
+#include "openclcpp-lite/sampler.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/platform.h"
+#include "openclcpp-lite/error.h"
+#include "openclcpp-lite/exception.h"
+#include "fmt/format.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#ifdef __APPLE__
+    #include <OpenCL/cl_ext.h>
+#else
+    #include <CL/cl_ext.h>
+#endif
+
+// clang-format off
+#if defined(cl_khr_command_buffer) && defined(CL_KHR_COMMAND_BUFFER_EXTENSION_VERSION)
+    #if CL_KHR_COMMAND_BUFFER_EXTENSION_VERSION >= CL_MAKE_VERSION(0, 9, 5)
+        #define OPENCLCPP_LITE_COMMAND_BUFFER
+    #endif
+#endif
+// clang-format on
+
+namespace openclcpp_lite {
+
+struct CommandGraph::Data {
+    /// Captured kernel argument
+    struct Arg {
+        cl_uint index;
+        size_t size;
+        /// Argument value, empty for `__local` arguments
+        std::vector<char> value;
+        /// `true` if the value is a shared virtual memory pointer
+        bool svm = false;
+        /// Reference to the memory object passed as the argument, if any
+        Memory mem;
+        /// Reference to the sampler passed as the argument, if any
+        Sampler sampler;
+    };
+
+    struct Command {
+        enum Type { KERNEL, FILL, COPY, READ, WRITE, COPY_RECT, READ_RECT, WRITE_RECT } type;
+
+        explicit Command(Type t) : type(t) {}
+
+        /// The graph holds references to the kernels, memory objects and events it replays
+        Kernel kernel;
+        cl_uint dims = 0;
+        std::array<size_t, 3> global = { 0, 0, 0 };
+        /// Local sizes, empty if left up to the implementation
+        std::vector<size_t> local;
+        /// Global offset, empty if none
+        std::vector<size_t> offset;
+        std::vector<Arg> args;
+        Memory src;
+        Memory dest;
+        size_t src_offset = 0;
+        size_t dest_offset = 0;
+        size_t size = 0;
+        /// Rectangular copies, host memory is `dest` of reads and `src` of writes
+        std::array<size_t, 3> src_origin = { 0, 0, 0 };
+        std::array<size_t, 3> dest_origin = { 0, 0, 0 };
+        std::array<size_t, 3> region = { 0, 0, 0 };
+        size_t src_row_pitch = 0;
+        size_t src_slice_pitch = 0;
+        size_t dest_row_pitch = 0;
+        size_t dest_slice_pitch = 0;
+        std::vector<char> pattern;
+        void * ptr = nullptr;
+        std::vector<Event> wait_list;
+    };
+
+    explicit Data(const Queue & q) : queue(q), in_order(!q.out_of_order()) {}
+
+    ~Data()
+    {
+#ifdef OPENCLCPP_LITE_COMMAND_BUFFER
+        if (this->cmd_buf != nullptr)
+            this->release_cmd_buf(this->cmd_buf);
+#endif
+    }
+
+    /// Set a captured argument of a kernel
+    static void
+    set_arg(cl_kernel kernel, const Arg & a)
+    {
+#ifdef CL_VERSION_2_0
+        if (a.svm) {
+            void * ptr;
+            std::memcpy(&ptr, a.value.data(), sizeof(ptr));
+            OPENCL_CHECK(clSetKernelArgSVMPointer(kernel, a.index, ptr));
+            return;
+        }
+#endif
+        OPENCL_CHECK(
+            clSetKernelArg(kernel, a.index, a.size, a.value.empty() ? nullptr : a.value.data()));
+    }
+
+    /// Set captured arguments of a kernel command
+    static void
+    set_args(const Command & cmd)
+    {
+        for (auto & a : cmd.args)
+            set_arg(cmd.kernel, a);
+    }
+
+    /// Enqueue a single command
+    static void
+    enqueue(cl_command_queue q,
+            const Command & cmd,
+            cl_uint n_waits,
+            const cl_event * waits,
+            cl_event * evt)
+    {
+        switch (cmd.type) {
+        case Command::KERNEL:
+            // the kernel may have been re-bound outside the graph since the last replay
+            set_args(cmd);
+            OPENCL_CHECK(clEnqueueNDRangeKernel(q,
+                                                cmd.kernel,
+                                                cmd.dims,
+                                                cmd.offset.empty() ? nullptr : cmd.offset.data(),
+                                                cmd.global.data(),
+                                                cmd.local.empty() ? nullptr : cmd.local.data(),
+                                                n_waits,
+                                                waits,
+                                                evt));
+            break;
+        case Command::FILL:
+            OPENCL_CHECK(clEnqueueFillBuffer(q,
+                                             cmd.dest,
+                                             cmd.pattern.data(),
+                                             cmd.pattern.size(),
+                                             cmd.dest_offset,
+                                             cmd.size,
+                                             n_waits,
+                                             waits,
+                                             evt));
+            break;
+        case Command::COPY:
+            OPENCL_CHECK(clEnqueueCopyBuffer(q,
+                                             cmd.src,
+                                             cmd.dest,
+                                             cmd.src_offset,
+                                             cmd.dest_offset,
+                                             cmd.size,
+                                             n_waits,
+                                             waits,
+                                             evt));
+            break;
+        case Command::READ:
+            OPENCL_CHECK(clEnqueueReadBuffer(q,
+                                             cmd.src,
+                                             CL_FALSE,
+                                             cmd.src_offset,
+                                             cmd.size,
+                                             cmd.ptr,
+                                             n_waits,
+                                             waits,
+                                             evt));
+            break;
+        case Command::WRITE:
+            OPENCL_CHECK(clEnqueueWriteBuffer(q,
+                                              cmd.dest,
+                                              CL_FALSE,
+                                              cmd.dest_offset,
+                                              cmd.size,
+                                              cmd.ptr,
+                                              n_waits,
+                                              waits,
+                                              evt));
+            break;
+        case Command::COPY_RECT:
+            OPENCL_CHECK(clEnqueueCopyBufferRect(q,
+                                                 cmd.src,
+                                                 cmd.dest,
+                                                 cmd.src_origin.data(),
+                                                 cmd.dest_origin.data(),
+                                                 cmd.region.data(),
+                                                 cmd.src_row_pitch,
+                                                 cmd.src_slice_pitch,
+                                                 cmd.dest_row_pitch,
+                                                 cmd.dest_slice_pitch,
+                                                 n_waits,
+                                                 waits,
+                                                 evt));
+            break;
+        case Command::READ_RECT:
+            OPENCL_CHECK(clEnqueueReadBufferRect(q,
+                                                 cmd.src,
+                                                 CL_FALSE,
+                                                 cmd.src_origin.data(),
+                                                 cmd.dest_origin.data(),
+                                                 cmd.region.data(),
+                                                 cmd.src_row_pitch,
+                                                 cmd.src_slice_pitch,
+                                                 cmd.dest_row_pitch,
+                                                 cmd.dest_slice_pitch,
+                                                 cmd.ptr,
+                                                 n_waits,
+                                                 waits,
+                                                 evt));
+            break;
+        case Command::WRITE_RECT:
+            OPENCL_CHECK(clEnqueueWriteBufferRect(q,
+                                                  cmd.dest,
+                                                  CL_FALSE,
+                                                  cmd.dest_origin.data(),
+                                                  cmd.src_origin.data(),
+                                                  cmd.region.data(),
+                                                  cmd.dest_row_pitch,
+                                                  cmd.dest_slice_pitch,
+                                                  cmd.src_row_pitch,
+                                                  cmd.src_slice_pitch,
+                                                  cmd.ptr,
+                                                  n_waits,
+                                                  waits,
+                                                  evt));
+            break;
+        }
+    }
+
+    /// Record the commands into a `cl_khr_command_buffer` if possible
+    void build_cmd_buf();
+
+    /// Queue the graph was recorded on
+    Queue queue;
+    /// `true` if `queue` executes commands in order
+    bool in_order;
+    /// Recorded commands
+    std::vector<Command> commands;
+    /// Kernel arguments captured while recording
+    std::map<cl_kernel, std::map<cl_uint, Arg>> args;
+
+#ifdef OPENCLCPP_LITE_COMMAND_BUFFER
+    cl_command_buffer_khr cmd_buf = nullptr;
+    clEnqueueCommandBufferKHR_fn enqueue_cmd_buf = nullptr;
+    clReleaseCommandBufferKHR_fn release_cmd_buf = nullptr;
+#endif
+};
+
+thread_local CommandGraph::Data * CommandGraph::recording_ = nullptr;
+
+void
+CommandGraph::Data::build_cmd_buf()
+{
+#ifdef OPENCLCPP_LITE_COMMAND_BUFFER
+    if (!this->in_order)
+        return;
+    for (auto & cmd : this->commands)
+        if (cmd.type == Command::READ || cmd.type == Command::WRITE ||
+            cmd.type == Command::READ_RECT || cmd.type == Command::WRITE_RECT ||
+            !cmd.wait_list.empty())
+            return;
+
+    auto device = this->queue.device();
+    if (!device.extensions().contains("cl_khr_command_buffer"))
+        return;
+    cl_platform_id platform = device.platform();
+    auto address = [&](const char * name) {
+        return clGetExtensionFunctionAddressForPlatform(platform, name);
+    };
+    auto create = (clCreateCommandBufferKHR_fn) address("clCreateCommandBufferKHR");
+    auto finalize = (clFinalizeCommandBufferKHR_fn) address("clFinalizeCommandBufferKHR");
+    auto release = (clReleaseCommandBufferKHR_fn) address("clReleaseCommandBufferKHR");
+    auto enqueue = (clEnqueueCommandBufferKHR_fn) address("clEnqueueCommandBufferKHR");
+    auto cmd_kernel = (clCommandNDRangeKernelKHR_fn) address("clCommandNDRangeKernelKHR");
+    auto cmd_fill = (clCommandFillBufferKHR_fn) address("clCommandFillBufferKHR");
+    auto cmd_copy = (clCommandCopyBufferKHR_fn) address("clCommandCopyBufferKHR");
+    auto cmd_copy_rect = (clCommandCopyBufferRectKHR_fn) address("clCommandCopyBufferRectKHR");
+    if (!create || !finalize || !release || !enqueue || !cmd_kernel || !cmd_fill || !cmd_copy ||
+        !cmd_copy_rect)
+        return;
+
+    cl_command_queue q = this->queue;
+    cl_int err;
+    auto cb = create(1, &q, nullptr, &err);
+    if (err != CL_SUCCESS)
+        return;
+    // commands in a command buffer are only ordered through sync points
+    cl_sync_point_khr prev = 0;
+    for (std::size_t i = 0; i < this->commands.size() && err == CL_SUCCESS; i++) {
+        auto & cmd = this->commands[i];
+        cl_uint n_deps = i > 0 ? 1 : 0;
+        cl_sync_point_khr sp;
+        switch (cmd.type) {
+        case Command::KERNEL:
+            // the command buffer captures argument values at the time a command is recorded
+            set_args(cmd);
+            err = cmd_kernel(cb,
+                             nullptr,
+                             nullptr,
+                             cmd.kernel,
+                             cmd.dims,
+                             cmd.offset.empty() ? nullptr : cmd.offset.data(),
+                             cmd.global.data(),
+                             cmd.local.empty() ? nullptr : cmd.local.data(),
+                             n_deps,
+                             &prev,
+                             &sp,
+                             nullptr);
+            break;
+        case Command::FILL:
+            err = cmd_fill(cb,
+                           nullptr,
+                           nullptr,
+                           cmd.dest,
+                           cmd.pattern.data(),
+                           cmd.pattern.size(),
+                           cmd.dest_offset,
+                           cmd.size,
+                           n_deps,
+                           &prev,
+                           &sp,
+                           nullptr);
+            break;
+        case Command::COPY:
+            err = cmd_copy(cb,
+                           nullptr,
+                           nullptr,
+                           cmd.src,
+                           cmd.dest,
+                           cmd.src_offset,
+                           cmd.dest_offset,
+                           cmd.size,
+                           n_deps,
+                           &prev,
+                           &sp,
+                           nullptr);
+            break;
+        case Command::COPY_RECT:
+            err = cmd_copy_rect(cb,
+                                nullptr,
+                                nullptr,
+                                cmd.src,
+                                cmd.dest,
+                                cmd.src_origin.data(),
+                                cmd.dest_origin.data(),
+                                cmd.region.data(),
+                                cmd.src_row_pitch,
+                                cmd.src_slice_pitch,
+                                cmd.dest_row_pitch,
+                                cmd.dest_slice_pitch,
+                                n_deps,
+                                &prev,
+                                &sp,
+                                nullptr);
+            break;
+        default:
+            break;
+        }
+        prev = sp;
+    }
+    if (err == CL_SUCCESS)
+        err = finalize(cb);
+    if (err != CL_SUCCESS) {
+        release(cb);
+        return;
+    }
+
+    this->cmd_buf = cb;
+    this->enqueue_cmd_buf = enqueue;
+    this->release_cmd_buf = release;
+#endif
+}
+
+CommandGraph::CommandGraph(const Queue & queue) : data_(std::make_shared<Data>(queue)) {}
+
+std::size_t
+CommandGraph::size() const
+{
+    return this->data_->commands.size();
+}
+
+bool
+CommandGraph::native() const
+{
+#ifdef OPENCLCPP_LITE_COMMAND_BUFFER
+    return this->data_->cmd_buf != nullptr;
+#else
+    return false;
+#endif
+}
+
+void
+CommandGraph::set_arg(std::size_t command, cl_uint index, size_t size, const void * value)
+{
+    auto & d = *this->data_;
+    if (command >= d.commands.size() || d.commands[command].type != Data::Command::KERNEL)
+        throw Exception(fmt::format("Command {} of the graph is not a kernel", command));
+
+    auto & cmd = d.commands[command];
+    auto it = std::find_if(cmd.args.begin(), cmd.args.end(), [&](auto & a) {
+        return a.index == index;
+    });
+    if (it == cmd.args.end())
+        it = cmd.args.insert(cmd.args.end(), Data::Arg { index, 0, {}, false, {}, {} });
+    it->size = size;
+    if (value != nullptr)
+        it->value.assign((const char *) value, (const char *) value + size);
+    else
+        it->value.clear();
+    it->svm = false;
+    it->mem = Memory();
+    it->sampler = Sampler();
+
+#ifdef OPENCLCPP_LITE_COMMAND_BUFFER
+    if (d.cmd_buf != nullptr) {
+        d.release_cmd_buf(d.cmd_buf);
+        d.cmd_buf = nullptr;
+    }
+#endif
+}
+
+void
+CommandGraph::set_arg(std::size_t command, cl_uint index, const Memory & mem)
+{
+    cl_mem m = mem;
+    set_arg(command, index, sizeof(cl_mem), &m);
+    for (auto & a : this->data_->commands[command].args)
+        if (a.index == index)
+            a.mem = mem;
+}
+
+Event
+CommandGraph::replay(WaitList wait_list) const
+{
+    auto & d = *this->data_;
+    WaitListStorage storage;
+    auto deps = d.queue.dependencies({}, {}, wait_list, storage);
+    auto n_deps = (cl_uint) deps.size();
+    auto * dep_events = deps.data();
+    cl_command_queue q = d.queue;
+
+    cl_event evt = nullptr;
+#ifdef OPENCLCPP_LITE_COMMAND_BUFFER
+    if (d.cmd_buf != nullptr) {
+        OPENCL_CHECK(d.enqueue_cmd_buf(0, nullptr, d.cmd_buf, n_deps, dep_events, &evt));
+        Event e(evt);
+        d.queue.record({}, {}, e);
+        return e;
+    }
+#endif
+
+    // kept local rather than in `data_`, which copies of the graph share
+    std::vector<cl_event> scratch;
+    cl_event prev = nullptr;
+    for (std::size_t i = 0; i < d.commands.size(); i++) {
+        auto & cmd = d.commands[i];
+        const cl_event * waits = WaitList(cmd.wait_list).data();
+        auto n_waits = (cl_uint) cmd.wait_list.size();
+        if (i == 0 || prev != nullptr) {
+            scratch.assign(cmd.wait_list.begin(), cmd.wait_list.end());
+            if (i == 0)
+                scratch.insert(scratch.end(), dep_events, dep_events + n_deps);
+            if (prev != nullptr)
+                scratch.push_back(prev);
+            waits = scratch.data();
+            n_waits = scratch.size();
+        }
+        if (n_waits == 0)
+            waits = nullptr;
+
+        // out-of-order queues need an event per command to keep the recorded order
+        cl_event next = nullptr;
+        Data::enqueue(q, cmd, n_waits, waits, d.in_order ? nullptr : &next);
+        if (prev != nullptr)
+            OPENCL_CHECK(clReleaseEvent(prev));
+        prev = next;
+    }
+
+    if (prev != nullptr) {
+        OPENCL_CHECK(clEnqueueMarkerWithWaitList(q, 1, &prev, &evt));
+        OPENCL_CHECK(clReleaseEvent(prev));
+    }
+    else if (d.commands.empty())
+        OPENCL_CHECK(clEnqueueMarkerWithWaitList(q, n_deps, dep_events, &evt));
+    else
+        OPENCL_CHECK(clEnqueueMarkerWithWaitList(q, 0, nullptr, &evt));
+    Event e(evt);
+    d.queue.record({}, {}, e);
+    return e;
+}
+
+void
+CommandGraph::begin()
+{
+    recording_ = this->data_.get();
+}
+
+void
+CommandGraph::end()
+{
+    recording_ = nullptr;
+
+    auto & d = *this->data_;
+    d.args.clear();
+    d.build_cmd_buf();
+}
+
+void
+CommandGraph::add_kernel(cl_kernel kernel,
+                         cl_uint dims,
+                         const size_t * offset,
+                         const size_t * global,
+                         const size_t * local,
+                         WaitList wait_list)
+{
+    auto & d = *this->data_;
+    Data::Command cmd(Data::Command::KERNEL);
+    cmd.kernel = Kernel(kernel, true);
+    cmd.dims = dims;
+    for (cl_uint i = 0; i < dims; i++)
+        cmd.global[i] = global[i];
+    if (offset != nullptr)
+        cmd.offset.assign(offset, offset + dims);
+    if (local != nullptr)
+        cmd.local.assign(local, local + dims);
+    for (auto & [idx, arg] : d.args[kernel])
+        cmd.args.push_back(arg);
+    for (auto & e : wait_list)
+        if (e != nullptr)
+            cmd.wait_list.push_back(e);
+    d.commands.push_back(std::move(cmd));
+}
+
+void
+CommandGraph::add_fill(cl_mem buffer,
+                       const void * pattern,
+                       size_t pattern_size,
+                       size_t offset,
+                       size_t size,
+                       WaitList wait_list)
+{
+    Data::Command cmd(Data::Command::FILL);
+    cmd.dest = Memory(buffer, true);
+    cmd.pattern.assign((const char *) pattern, (const char *) pattern + pattern_size);
+    cmd.dest_offset = offset;
+    cmd.size = size;
+    for (auto & e : wait_list)
+        if (e != nullptr)
+            cmd.wait_list.push_back(e);
+    this->data_->commands.push_back(std::move(cmd));
+}
+
+void
+CommandGraph::add_copy(cl_mem src,
+                       cl_mem dest,
+                       size_t src_offset,
+                       size_t dest_offset,
+                       size_t size,
+                       WaitList wait_list)
+{
+    Data::Command cmd(Data::Command::COPY);
+    cmd.src = Memory(src, true);
+    cmd.dest = Memory(dest, true);
+    cmd.src_offset = src_offset;
+    cmd.dest_offset = dest_offset;
+    cmd.size = size;
+    for (auto & e : wait_list)
+        if (e != nullptr)
+            cmd.wait_list.push_back(e);
+    this->data_->commands.push_back(std::move(cmd));
+}
+
+void
+CommandGraph::add_read(cl_mem buffer,
+                       size_t offset,
+                       size_t size,
+                       void * ptr,
+                       WaitList wait_list)
+{
+    Data::Command cmd(Data::Command::READ);
+    cmd.src = Memory(buffer, true);
+    cmd.src_offset = offset;
+    cmd.size = size;
+    cmd.ptr = ptr;
+    for (auto & e : wait_list)
+        if (e != nullptr)
+            cmd.wait_list.push_back(e);
+    this->data_->commands.push_back(std::move(cmd));
+}
+
+void
+CommandGraph::add_write(cl_mem buffer,
+                        size_t offset,
+                        size_t size,
+                        const void * ptr,
+                        WaitList wait_list)
+{
+    Data::Command cmd(Data::Command::WRITE);
+    cmd.dest = Memory(buffer, true);
+    cmd.dest_offset = offset;
+    cmd.size = size;
+    cmd.ptr = const_cast<void *>(ptr);
+    for (auto & e : wait_list)
+        if (e != nullptr)
+            cmd.wait_list.push_back(e);
+    this->data_->commands.push_back(std::move(cmd));
+}
+
+void
+CommandGraph::add_copy_rect(cl_mem src,
+                            cl_mem dest,
+                            const size_t * src_origin,
+                            const size_t * dest_origin,
+                            const size_t * region,
+                            size_t src_row_pitch,
+                            size_t src_slice_pitch,
+                            size_t dest_row_pitch,
+                            size_t dest_slice_pitch,
+                            WaitList wait_list)
+{
+    Data::Command cmd(Data::Command::COPY_RECT);
+    cmd.src = Memory(src, true);
+    cmd.dest = Memory(dest, true);
+    std::copy(src_origin, src_origin + 3, cmd.src_origin.begin());
+    std::copy(dest_origin, dest_origin + 3, cmd.dest_origin.begin());
+    std::copy(region, region + 3, cmd.region.begin());
+    cmd.src_row_pitch = src_row_pitch;
+    cmd.src_slice_pitch = src_slice_pitch;
+    cmd.dest_row_pitch = dest_row_pitch;
+    cmd.dest_slice_pitch = dest_slice_pitch;
+    for (auto & e : wait_list)
+        if (e != nullptr)
+            cmd.wait_list.push_back(e);
+    this->data_->commands.push_back(std::move(cmd));
+}
+
+void
+CommandGraph::add_read_rect(cl_mem buffer,
+                            const size_t * buffer_origin,
+                            const size_t * host_origin,
+                            const size_t * region,
+                            size_t buffer_row_pitch,
+                            size_t buffer_slice_pitch,
+                            size_t host_row_pitch,
+                            size_t host_slice_pitch,
+                            void * ptr,
+                            WaitList wait_list)
+{
+    Data::Command cmd(Data::Command::READ_RECT);
+    cmd.src = Memory(buffer, true);
+    std::copy(buffer_origin, buffer_origin + 3, cmd.src_origin.begin());
+    std::copy(host_origin, host_origin + 3, cmd.dest_origin.begin());
+    std::copy(region, region + 3, cmd.region.begin());
+    cmd.src_row_pitch = buffer_row_pitch;
+    cmd.src_slice_pitch = buffer_slice_pitch;
+    cmd.dest_row_pitch = host_row_pitch;
+    cmd.dest_slice_pitch = host_slice_pitch;
+    cmd.ptr = ptr;
+    for (auto & e : wait_list)
+        if (e != nullptr)
+            cmd.wait_list.push_back(e);
+    this->data_->commands.push_back(std::move(cmd));
+}
+
+void
+CommandGraph::add_write_rect(cl_mem buffer,
+                             const size_t * buffer_origin,
+                             const size_t * host_origin,
+                             const size_t * region,
+                             size_t buffer_row_pitch,
+                             size_t buffer_slice_pitch,
+                             size_t host_row_pitch,
+                             size_t host_slice_pitch,
+                             const void * ptr,
+                             WaitList wait_list)
+{
+    Data::Command cmd(Data::Command::WRITE_RECT);
+    cmd.dest = Memory(buffer, true);
+    std::copy(buffer_origin, buffer_origin + 3, cmd.dest_origin.begin());
+    std::copy(host_origin, host_origin + 3, cmd.src_origin.begin());
+    std::copy(region, region + 3, cmd.region.begin());
+    cmd.dest_row_pitch = buffer_row_pitch;
+    cmd.dest_slice_pitch = buffer_slice_pitch;
+    cmd.src_row_pitch = host_row_pitch;
+    cmd.src_slice_pitch = host_slice_pitch;
+    cmd.ptr = const_cast<void *>(ptr);
+    for (auto & e : wait_list)
+        if (e != nullptr)
+            cmd.wait_list.push_back(e);
+    this->data_->commands.push_back(std::move(cmd));
+}
+
+void
+CommandGraph::capture_arg(cl_kernel kernel, cl_uint index, size_t size, const void * value)
+{
+    if (recording_ == nullptr)
+        return;
+    auto & arg = recording_->args[kernel][index];
+    arg.index = index;
+    arg.size = size;
+    if (value != nullptr)
+        arg.value.assign((const char *) value, (const char *) value + size);
+    else
+        arg.value.clear();
+    arg.svm = false;
+    arg.mem = Memory();
+    arg.sampler = Sampler();
+}
+
+void
+CommandGraph::capture_mem_arg(cl_kernel kernel, cl_uint index, cl_mem mem)
+{
+    if (recording_ == nullptr)
+        return;
+    capture_arg(kernel, index, sizeof(mem), &mem);
+    if (mem != nullptr)
+        recording_->args[kernel][index].mem = Memory(mem, true);
+}
+
+void
+CommandGraph::capture_sampler_arg(cl_kernel kernel, cl_uint index, cl_sampler sampler)
+{
+    if (recording_ == nullptr)
+        return;
+    capture_arg(kernel, index, sizeof(sampler), &sampler);
+    if (sampler != nullptr)
+        recording_->args[kernel][index].sampler = Sampler(sampler, true);
+}
+
+#ifdef CL_VERSION_2_0
+void
+CommandGraph::capture_svm_arg(cl_kernel kernel, cl_uint index, const void * ptr)
+{
+    if (recording_ == nullptr)
+        return;
+    capture_arg(kernel, index, sizeof(ptr), &ptr);
+    recording_->args[kernel][index].svm = true;
+}
+#endif
+
+} // namespace openclcpp_lite
@@ -5,6 +5,8 @@
 #include "openclcpp-lite/context.h"
 #include "openclcpp-lite/buffer.h"
 #include "openclcpp-lite/platform.h"
+#include <algorithm>
+#include <utility>
 
 namespace openclcpp_lite {
 
@@ -32,7 +34,46 @@ Context::Context(const std::vector<Device> & devices)
     OPENCL_CHECK(err);
 }
 
-Context::Context(cl_context context) : ctx_(context) {}
+Context::Context(cl_context context, bool retain) : ctx_(context)
+{
+    if (retain && this->ctx_ != nullptr)
+        OPENCL_CHECK(clRetainContext(this->ctx_));
+}
+
+Context::Context(const Context & other) : ctx_(other.ctx_)
+{
+    if (this->ctx_ != nullptr)
+        OPENCL_CHECK(clRetainContext(this->ctx_));
+}
+
+Context::Context(Context && other) noexcept : ctx_(other.ctx_)
+{
+    other.ctx_ = nullptr;
+}
+
+Context::~Context()
+{
+    if (this->ctx_ != nullptr)
+        clReleaseContext(this->ctx_);
+}
+
+Context &
+Context::operator=(const Context & other)
+{
+    if (other.ctx_ != nullptr)
+        OPENCL_CHECK(clRetainContext(other.ctx_));
+    if (this->ctx_ != nullptr)
+        clReleaseContext(this->ctx_);
+    this->ctx_ = other.ctx_;
+    return *this;
+}
+
+Context &
+Context::operator=(Context && other) noexcept
+{
+    std::swap(this->ctx_, other.ctx_);
+    return *this;
+}
 
 void
 Context::retain() const
@@ -59,13 +100,31 @@ Context::num_of_devices() const
     return get_info<cl_uint>(CL_CONTEXT_NUM_DEVICES);
 }
 
+bool
+Context::host_unified_memory() const
+{
+    auto devs = devices();
+    return std::all_of(devs.begin(), devs.end(), [](const Device & d) {
+        return d.host_unified_memory();
+    });
+}
+
+std::size_t
+Context::alignment() const
+{
+    std::size_t align = 1;
+    for (auto & d : devices())
+        align = std::max<std::size_t>(align, d.mem_base_addr_align() / 8);
+    return align;
+}
+
 std::vector<Device>
 Context::devices() const
 {
     std::size_t sz;
     OPENCL_CHECK(clGetContextInfo(this->ctx_, CL_CONTEXT_DEVICES, 0, nullptr, &sz));
     std::vector<cl_device_id> ids;
-    ids.resize(sz);
+    ids.resize(sz / sizeof(cl_device_id));
     OPENCL_CHECK(clGetContextInfo(this->ctx_, CL_CONTEXT_DEVICES, sz, ids.data(), nullptr));
     std::vector<Device> devices;
     for (auto & id : ids)
@@ -104,6 +104,15 @@ Device::image_support() const
     return get_info<cl_bool>(CL_DEVICE_IMAGE_SUPPORT);
 }
 
+#ifdef CL_VERSION_2_0
+Flags<Device::SVMCapability>
+Device::svm_capabilities() const
+{
+    auto info = get_info<cl_device_svm_capabilities>(CL_DEVICE_SVM_CAPABILITIES);
+    return Flags<SVMCapability>((unsigned int) info);
+}
+#endif
+
 size_t
 Device::image2d_max_height() const
 {
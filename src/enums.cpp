@@ -35,4 +35,24 @@ operator cl_map_flags() const
     return this->mask_;
 }
 
+MigrationFlags::MigrationFlags(const MigrationFlag & flag) : Flags<MigrationFlag>(flag) {}
+
+MigrationFlags::MigrationFlags(const Flags<MigrationFlag> & flags) : Flags<MigrationFlag>(flags) {}
+
+MigrationFlags::
+operator cl_mem_migration_flags() const
+{
+    return this->mask_;
+}
+
+QueueProperties::QueueProperties(const QueueProperty & flag) : Flags<QueueProperty>(flag) {}
+
+QueueProperties::QueueProperties(const Flags<QueueProperty> & flags) : Flags<QueueProperty>(flags) {}
+
+QueueProperties::
+operator cl_command_queue_properties() const
+{
+    return this->mask_;
+}
+
 } // namespace openclcpp_lite
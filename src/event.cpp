@@ -5,10 +5,72 @@
 #include "openclcpp-lite/error.h"
 #include "openclcpp-lite/queue.h"
 #include "openclcpp-lite/context.h"
+#include "openclcpp-lite/exception.h"
+#include "fmt/format.h"
+#include <memory>
+#include <utility>
 
 namespace openclcpp_lite {
 
-Event::Event(cl_event evt) : evt_(evt) {}
+namespace {
+
+void CL_CALLBACK
+event_callback(cl_event, cl_int status, void * user_data)
+{
+    auto * fn = static_cast<std::function<void(cl_int)> *>(user_data);
+    try {
+        (*fn)(status);
+    }
+    catch (...) {
+        // exceptions must not propagate into the OpenCL implementation
+    }
+    delete fn;
+}
+
+} // namespace
+
+Event::Event() : evt_(nullptr) {}
+
+Event::Event(cl_event evt, bool retain) : evt_(evt)
+{
+    if (retain && this->evt_ != nullptr)
+        OPENCL_CHECK(clRetainEvent(this->evt_));
+}
+
+Event::Event(const Event & other) : evt_(other.evt_)
+{
+    if (this->evt_ != nullptr)
+        OPENCL_CHECK(clRetainEvent(this->evt_));
+}
+
+Event::Event(Event && other) noexcept : evt_(other.evt_)
+{
+    other.evt_ = nullptr;
+}
+
+Event::~Event()
+{
+    if (this->evt_ != nullptr)
+        clReleaseEvent(this->evt_);
+}
+
+Event &
+Event::operator=(const Event & other)
+{
+    if (other.evt_ != nullptr)
+        OPENCL_CHECK(clRetainEvent(other.evt_));
+    if (this->evt_ != nullptr)
+        clReleaseEvent(this->evt_);
+    this->evt_ = other.evt_;
+    return *this;
+}
+
+Event &
+Event::operator=(Event && other) noexcept
+{
+    std::swap(this->evt_, other.evt_);
+    return *this;
+}
 
 void
 Event::retain() const
@@ -26,14 +88,14 @@ Queue
 Event::command_queue() const
 {
     auto q = get_info<cl_command_queue>(CL_EVENT_COMMAND_QUEUE);
-    return Queue(q);
+    return Queue(q, true);
 }
 
 Context
 Event::context() const
 {
     auto ctx = get_info<cl_context>(CL_EVENT_CONTEXT);
-    return Context(ctx);
+    return Context(ctx, true);
 }
 
 CommandExecutionStatus
@@ -69,6 +131,45 @@ Event::profiling_info() const
     return info;
 }
 
+const Event &
+Event::then(std::function<void()> callback) const
+{
+    on_complete(this->evt_, [callback = std::move(callback)](cl_int) { callback(); });
+    return *this;
+}
+
+std::future<void>
+Event::get_future() const
+{
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    on_complete(this->evt_, [promise](cl_int status) {
+        if (status < 0)
+            promise->set_exception(std::make_exception_ptr(
+                Exception(fmt::format("Command failed: {}", internal::error_message(status)))));
+        else
+            promise->set_value();
+    });
+    return future;
+}
+
+Event::Awaiter
+Event::operator co_await() const
+{
+    return Awaiter(this->evt_);
+}
+
+void
+Event::on_complete(cl_event evt, std::function<void(cl_int)> callback)
+{
+    auto * fn = new std::function<void(cl_int)>(std::move(callback));
+    auto err = clSetEventCallback(evt, CL_COMPLETE, event_callback, fn);
+    if (err != CL_SUCCESS) {
+        delete fn;
+        OPENCL_CHECK(err);
+    }
+}
+
 Event::
 operator cl_event() const
 {
@@ -76,10 +177,52 @@ operator cl_event() const
 }
 
 void
-Event::wait(const std::vector<Event> & events)
+Event::wait(WaitList events)
+{
+    WaitListStorage storage;
+    auto waits = events.dense(storage);
+    if (waits.empty())
+        return;
+    OPENCL_CHECK(clWaitForEvents(waits.size(), waits.data()));
+}
+
+// Awaiter
+
+Event::Awaiter::Awaiter(cl_event evt) : evt_(evt), status_(CL_COMPLETE)
+{
+    if (this->evt_ != nullptr)
+        OPENCL_CHECK(clRetainEvent(this->evt_));
+}
+
+Event::Awaiter::~Awaiter()
+{
+    if (this->evt_ != nullptr)
+        clReleaseEvent(this->evt_);
+}
+
+bool
+Event::Awaiter::await_ready()
+{
+    if (this->evt_ == nullptr)
+        return true;
+    get_info_helper(clGetEventInfo, this->evt_, CL_EVENT_COMMAND_EXECUTION_STATUS, this->status_);
+    return this->status_ == CL_COMPLETE || this->status_ < 0;
+}
+
+void
+Event::Awaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    on_complete(this->evt_, [this, handle](cl_int status) {
+        this->status_ = status;
+        handle.resume();
+    });
+}
+
+void
+Event::Awaiter::await_resume() const
 {
-    OPENCL_CHECK(
-        clWaitForEvents(events.size(), events.empty() ? nullptr : (cl_event *) &events.front()));
+    if (this->status_ < 0)
+        throw Exception(fmt::format("Command failed: {}", internal::error_message(this->status_)));
 }
 
 } // namespace openclcpp_lite
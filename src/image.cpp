@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "openclcpp-lite/image.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/error.h"
+#include "openclcpp-lite/exception.h"
+#include "openclcpp-lite/memory_accounting.h"
+#include "fmt/format.h"
+#include <algorithm>
+
+namespace openclcpp_lite {
+
+namespace {
+
+/// Check that an image size fits into a device limit
+void
+check_limit(const Device & device, const char * what, size_t size, size_t limit)
+{
+    if (size > limit)
+        throw Exception(fmt::format("Image {} {} exceeds the limit {} of device '{}'",
+                                    what,
+                                    size,
+                                    limit,
+                                    device.name()));
+}
+
+} // namespace
+
+// ImageFormat
+
+size_t
+ImageFormat::num_of_channels() const
+{
+    switch (this->order) {
+    case RG:
+    case RA:
+        return 2;
+    case RGB:
+        return 3;
+    case RGBA:
+    case BGRA:
+    case ARGB:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+size_t
+ImageFormat::pixel_size() const
+{
+    switch (this->type) {
+    case UNORM_SHORT_565:
+    case UNORM_SHORT_555:
+        return 2;
+    case UNORM_INT_101010:
+        return 4;
+    case SNORM_INT8:
+    case UNORM_INT8:
+    case SIGNED_INT8:
+    case UNSIGNED_INT8:
+        return num_of_channels();
+    case SNORM_INT16:
+    case UNORM_INT16:
+    case SIGNED_INT16:
+    case UNSIGNED_INT16:
+    case HALF_FLOAT:
+        return 2 * num_of_channels();
+    default:
+        return 4 * num_of_channels();
+    }
+}
+
+ImageFormat::
+operator cl_image_format() const
+{
+    return { static_cast<cl_channel_order>(this->order),
+             static_cast<cl_channel_type>(this->type) };
+}
+
+// Image
+
+Image::Image() : Memory() {}
+
+Image::Image(cl_mem mem, bool retain) : Memory(mem, retain) {}
+
+ImageFormat
+Image::format() const
+{
+    auto img_fmt = get_image_info<cl_image_format>(CL_IMAGE_FORMAT);
+    return { static_cast<ChannelOrder>(img_fmt.image_channel_order),
+             static_cast<ChannelType>(img_fmt.image_channel_data_type) };
+}
+
+size_t
+Image::element_size() const
+{
+    return get_image_info<size_t>(CL_IMAGE_ELEMENT_SIZE);
+}
+
+size_t
+Image::row_pitch() const
+{
+    return get_image_info<size_t>(CL_IMAGE_ROW_PITCH);
+}
+
+size_t
+Image::slice_pitch() const
+{
+    return get_image_info<size_t>(CL_IMAGE_SLICE_PITCH);
+}
+
+size_t
+Image::width() const
+{
+    return get_image_info<size_t>(CL_IMAGE_WIDTH);
+}
+
+size_t
+Image::height() const
+{
+    return get_image_info<size_t>(CL_IMAGE_HEIGHT);
+}
+
+size_t
+Image::depth() const
+{
+    return get_image_info<size_t>(CL_IMAGE_DEPTH);
+}
+
+size_t
+Image::array_size() const
+{
+    return get_image_info<size_t>(CL_IMAGE_ARRAY_SIZE);
+}
+
+std::array<size_t, 3>
+Image::region() const
+{
+    auto n = array_size();
+    if (n > 0)
+        return { width(), height(), n };
+    else
+        return { width(), height(), std::max<size_t>(depth(), 1) };
+}
+
+cl_mem
+Image::create(const Context & context,
+              MemoryFlags mem_flags,
+              const ImageFormat & format,
+              cl_mem_object_type type,
+              size_t width,
+              size_t height,
+              size_t depth,
+              size_t array_size,
+              const std::source_location & loc)
+{
+    for (auto & dev : context.devices()) {
+        if (!dev.image_support())
+            throw Exception(fmt::format("Device '{}' does not support images", dev.name()));
+        if (type == CL_MEM_OBJECT_IMAGE3D) {
+            check_limit(dev, "width", width, dev.image3d_max_width());
+            check_limit(dev, "height", height, dev.image3d_max_height());
+            check_limit(dev, "depth", depth, dev.image3d_max_depth());
+        }
+        else {
+            check_limit(dev, "width", width, dev.image2d_max_width());
+            check_limit(dev, "height", height, dev.image2d_max_height());
+            if (type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
+                check_limit(dev, "array size", array_size, dev.image_max_array_size());
+        }
+    }
+
+    cl_image_format img_fmt = format;
+    cl_image_desc desc = {};
+    desc.image_type = type;
+    desc.image_width = width;
+    desc.image_height = height;
+    desc.image_depth = depth;
+    desc.image_array_size = array_size;
+    cl_int err;
+    auto mem = clCreateImage(context, mem_flags, &img_fmt, &desc, nullptr, &err);
+    OPENCL_CHECK(err);
+    size_t bytes;
+    OPENCL_CHECK(clGetMemObjectInfo(mem, CL_MEM_SIZE, sizeof(bytes), &bytes, nullptr));
+    MemoryAccounting::track(mem, context, bytes, loc);
+    return mem;
+}
+
+} // namespace openclcpp_lite
@@ -2,9 +2,12 @@
 // SPDX-License-Identifier: MIT
 
 #include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/command_graph.h"
 #include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
 #include "openclcpp-lite/program.h"
 #include "openclcpp-lite/utils.h"
+#include <utility>
 
 namespace openclcpp_lite {
 
@@ -17,7 +20,46 @@ Kernel::Kernel(const Program & program, const std::string & kernel_name)
     OPENCL_CHECK(err);
 }
 
-Kernel::Kernel(cl_kernel kernel) : kern_(kernel) {}
+Kernel::Kernel(cl_kernel kernel, bool retain) : kern_(kernel)
+{
+    if (retain && this->kern_ != nullptr)
+        OPENCL_CHECK(clRetainKernel(this->kern_));
+}
+
+Kernel::Kernel(const Kernel & other) : kern_(other.kern_)
+{
+    if (this->kern_ != nullptr)
+        OPENCL_CHECK(clRetainKernel(this->kern_));
+}
+
+Kernel::Kernel(Kernel && other) noexcept : kern_(other.kern_)
+{
+    other.kern_ = nullptr;
+}
+
+Kernel::~Kernel()
+{
+    if (this->kern_ != nullptr)
+        clReleaseKernel(this->kern_);
+}
+
+Kernel &
+Kernel::operator=(const Kernel & other)
+{
+    if (other.kern_ != nullptr)
+        OPENCL_CHECK(clRetainKernel(other.kern_));
+    if (this->kern_ != nullptr)
+        clReleaseKernel(this->kern_);
+    this->kern_ = other.kern_;
+    return *this;
+}
+
+Kernel &
+Kernel::operator=(Kernel && other) noexcept
+{
+    std::swap(this->kern_, other.kern_);
+    return *this;
+}
 
 void
 Kernel::retain() const
@@ -53,14 +95,14 @@ Context
 Kernel::context() const
 {
     auto ctx = get_info<cl_context>(CL_KERNEL_CONTEXT);
-    return Context(ctx);
+    return Context(ctx, true);
 }
 
 Program
 Kernel::program() const
 {
     auto prg = get_info<cl_program>(CL_KERNEL_PROGRAM);
-    return Program(prg);
+    return Program(prg, true);
 }
 
 std::vector<std::string>
@@ -70,12 +112,71 @@ Kernel::attributes() const
     return utils::split(str, " ");
 }
 
+size_t
+Kernel::work_group_size(const Device & device) const
+{
+    size_t val;
+    OPENCL_CHECK(clGetKernelWorkGroupInfo(this->kern_,
+                                          device,
+                                          CL_KERNEL_WORK_GROUP_SIZE,
+                                          sizeof(val),
+                                          &val,
+                                          nullptr));
+    return val;
+}
+
+size_t
+Kernel::preferred_work_group_size_multiple(const Device & device) const
+{
+    size_t val;
+    OPENCL_CHECK(clGetKernelWorkGroupInfo(this->kern_,
+                                          device,
+                                          CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
+                                          sizeof(val),
+                                          &val,
+                                          nullptr));
+    return val;
+}
+
 void
 Kernel::set_arg(cl_uint index, size_t size, const void * arg)
 {
+    CommandGraph::capture_arg(this->kern_, index, size, arg);
     OPENCL_CHECK(clSetKernelArg(this->kern_, index, size, arg));
 }
 
+void
+Kernel::set_mem_arg(cl_uint index, cl_mem mem)
+{
+    CommandGraph::capture_mem_arg(this->kern_, index, mem);
+    OPENCL_CHECK(clSetKernelArg(this->kern_, index, sizeof(cl_mem), &mem));
+}
+
+void
+Kernel::set_sampler_arg(cl_uint index, cl_sampler sampler)
+{
+    CommandGraph::capture_sampler_arg(this->kern_, index, sampler);
+    OPENCL_CHECK(clSetKernelArg(this->kern_, index, sizeof(cl_sampler), &sampler));
+}
+
+#ifdef CL_VERSION_2_0
+void
+Kernel::set_arg_svm(cl_uint index, const void * ptr)
+{
+    CommandGraph::capture_svm_arg(this->kern_, index, ptr);
+    OPENCL_CHECK(clSetKernelArgSVMPointer(this->kern_, index, ptr));
+}
+
+void
+Kernel::set_svm_pointers(std::span<void * const> ptrs)
+{
+    OPENCL_CHECK(clSetKernelExecInfo(this->kern_,
+                                     CL_KERNEL_EXEC_INFO_SVM_PTRS,
+                                     ptrs.size() * sizeof(void *),
+                                     ptrs.data()));
+}
+#endif
+
 Kernel::
 operator cl_kernel() const
 {
@@ -3,10 +3,65 @@
 
 #include "openclcpp-lite/memory.h"
 #include "openclcpp-lite/context.h"
+#include <utility>
 
 namespace openclcpp_lite {
 
-Memory::Memory(cl_mem mem) : mem_(mem) {}
+namespace {
+
+void CL_CALLBACK
+release_owner(cl_mem, void * user_data)
+{
+    delete static_cast<std::shared_ptr<void> *>(user_data);
+}
+
+} // namespace
+
+Memory::Memory() : mem_(nullptr), host_(nullptr) {}
+
+Memory::Memory(cl_mem mem, bool retain) : mem_(mem), host_(nullptr)
+{
+    if (retain && this->mem_ != nullptr)
+        OPENCL_CHECK(clRetainMemObject(this->mem_));
+}
+
+Memory::Memory(const Memory & other) : mem_(other.mem_), host_(other.host_)
+{
+    if (this->mem_ != nullptr)
+        OPENCL_CHECK(clRetainMemObject(this->mem_));
+}
+
+Memory::Memory(Memory && other) noexcept : mem_(other.mem_), host_(other.host_)
+{
+    other.mem_ = nullptr;
+    other.host_ = nullptr;
+}
+
+Memory::~Memory()
+{
+    if (this->mem_ != nullptr)
+        clReleaseMemObject(this->mem_);
+}
+
+Memory &
+Memory::operator=(const Memory & other)
+{
+    if (other.mem_ != nullptr)
+        OPENCL_CHECK(clRetainMemObject(other.mem_));
+    if (this->mem_ != nullptr)
+        clReleaseMemObject(this->mem_);
+    this->mem_ = other.mem_;
+    this->host_ = other.host_;
+    return *this;
+}
+
+Memory &
+Memory::operator=(Memory && other) noexcept
+{
+    std::swap(this->mem_, other.mem_);
+    std::swap(this->host_, other.host_);
+    return *this;
+}
 
 void
 Memory::retain() const
@@ -42,7 +97,7 @@ Context
 Memory::context() const
 {
     auto ctx_id = get_info<cl_context>(CL_MEM_CONTEXT);
-    return Context(ctx_id);
+    return Context(ctx_id, true);
 }
 
 size_t
@@ -51,6 +106,31 @@ Memory::offset() const
     return get_info<size_t>(CL_MEM_OFFSET);
 }
 
+void *
+Memory::host_ptr() const
+{
+    return get_info<void *>(CL_MEM_HOST_PTR);
+}
+
+void *
+Memory::host_storage() const
+{
+    return this->host_;
+}
+
+void
+Memory::keep_alive(std::shared_ptr<void> owner) const
+{
+    if (owner == nullptr)
+        return;
+    auto * user_data = new std::shared_ptr<void>(std::move(owner));
+    auto err = clSetMemObjectDestructorCallback(this->mem_, release_owner, user_data);
+    if (err != CL_SUCCESS) {
+        delete user_data;
+        OPENCL_CHECK(err);
+    }
+}
+
 Memory::
 operator cl_mem() const
 {
@@ -0,0 +1,345 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "openclcpp-lite/memory_accounting.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/error.h"
+#include "fmt/format.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace openclcpp_lite {
+
+namespace {
+
+using Usage = MemoryAccounting::Usage;
+
+void
+add(Usage & usage, std::size_t size)
+{
+    usage.live_bytes += size;
+    usage.peak_bytes = std::max(usage.peak_bytes, usage.live_bytes);
+    usage.live_allocations++;
+    usage.total_allocations++;
+}
+
+void
+remove(Usage & usage, std::size_t size)
+{
+    usage.live_bytes -= size;
+    usage.live_allocations--;
+}
+
+void
+reset_peak(Usage & usage)
+{
+    usage.peak_bytes = usage.live_bytes;
+}
+
+struct Registry {
+    /// Live memory object, passed into its destructor callback
+    struct Allocation {
+        cl_context context;
+        std::size_t site;
+        std::size_t size;
+    };
+
+    /// Called by the OpenCL implementation when a context with recorded memory objects is
+    /// destroyed
+    static void CL_CALLBACK
+    context_destroyed(cl_context context, void *)
+    {
+        get().forget(context);
+    }
+
+    /// Called by the OpenCL implementation when a recorded memory object is destroyed
+    static void CL_CALLBACK
+    destroyed(cl_mem, void * user_data)
+    {
+        auto * a = static_cast<Allocation *>(user_data);
+        get().free(*a);
+        delete a;
+    }
+
+    /// Registry of the process
+    ///
+    /// Never destroyed, memory objects can outlive static objects.
+    static Registry &
+    get()
+    {
+        static auto * registry = new Registry();
+        return *registry;
+    }
+
+    /// Record a new memory object
+    std::size_t
+    add(cl_context context, std::size_t size, const std::source_location & loc)
+    {
+        std::vector<cl_device_id> devs;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            auto it = this->context_devices.find(context);
+            if (it != this->context_devices.end())
+                devs = it->second;
+        }
+        bool watched = true;
+        if (devs.empty()) {
+            // first memory object of the context
+            Context ctx(context, true);
+            for (auto & d : ctx.devices())
+                devs.push_back(d);
+            watched = watch(context);
+        }
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->context_devices.emplace(context, devs);
+        if (!watched)
+            this->unwatched.insert(context);
+        openclcpp_lite::add(this->total, size);
+        openclcpp_lite::add(this->contexts[context], size);
+        for (auto & d : devs)
+            openclcpp_lite::add(this->devices[d], size);
+        auto site = find_site(loc);
+        openclcpp_lite::add(this->sites[site].usage, size);
+        return site;
+    }
+
+    /// Index of the site of a source location in `sites`, adding it if it is new
+    ///
+    /// Must be called with `mutex` held.
+    std::size_t
+    find_site(const std::source_location & loc)
+    {
+        // file names of source locations are static, so the address identifies the file. The same
+        // file can have several addresses (e.g. a header included into several translation units),
+        // so a new address is matched by name before a new site is added.
+        SiteKey key { loc.file_name(), loc.line() };
+        auto it = this->site_ids.find(key);
+        if (it != this->site_ids.end())
+            return it->second;
+
+        auto site = this->sites.size();
+        for (std::size_t i = 0; i < this->sites.size(); i++)
+            if (this->sites[i].line == loc.line() && this->sites[i].file == loc.file_name()) {
+                site = i;
+                break;
+            }
+        if (site == this->sites.size())
+            this->sites.push_back({ loc.file_name(), loc.line(), loc.function_name(), {} });
+        this->site_ids.emplace(key, site);
+        return site;
+    }
+
+    /// Get notified when a context is destroyed
+    ///
+    /// @return `true` if `forget` will be called for the context, `false` if its destruction cannot
+    ///         be observed
+    static bool
+    watch(cl_context context)
+    {
+#ifdef CL_VERSION_3_0
+        return clSetContextDestructorCallback(context, context_destroyed, nullptr) == CL_SUCCESS;
+#else
+        return false;
+#endif
+    }
+
+    /// Remove a destroyed context, its handle can be reused for another context
+    void
+    forget(cl_context context)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->contexts.erase(context);
+        this->context_devices.erase(context);
+        this->unwatched.erase(context);
+    }
+
+    /// Remove a destroyed memory object
+    void
+    free(const Allocation & a)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        remove(this->total, a.size);
+        auto it = this->context_devices.find(a.context);
+        if (it != this->context_devices.end()) {
+            for (auto & d : it->second)
+                remove(this->devices[d], a.size);
+        }
+        auto ctx_it = this->contexts.find(a.context);
+        if (ctx_it != this->contexts.end()) {
+            remove(ctx_it->second, a.size);
+            // without a destructor callback, the context may be gone as soon as it has no memory
+            // objects, and its handle reused for another context
+            if (ctx_it->second.live_allocations == 0 && this->unwatched.erase(a.context) > 0) {
+                this->contexts.erase(ctx_it);
+                this->context_devices.erase(a.context);
+            }
+        }
+        remove(this->sites[a.site].usage, a.size);
+    }
+
+    /// Source location of a site, by the address of its file name
+    using SiteKey = std::pair<const char *, std::uint_least32_t>;
+
+    struct SiteKeyHash {
+        std::size_t
+        operator()(const SiteKey & key) const
+        {
+            return std::hash<const void *>()(key.first) ^ key.second;
+        }
+    };
+
+    std::mutex mutex;
+    std::atomic<bool> enabled = true;
+    Usage total;
+    /// Contexts with recorded memory objects, kept until the context is destroyed
+    std::unordered_map<cl_context, Usage> contexts;
+    /// Devices of the contexts in `contexts`
+    std::unordered_map<cl_context, std::vector<cl_device_id>> context_devices;
+    /// Contexts without a destructor callback (before OpenCL 3.0), they are removed when they have
+    /// no live memory objects
+    std::unordered_set<cl_context> unwatched;
+    std::unordered_map<cl_device_id, Usage> devices;
+    std::vector<MemoryAccounting::Site> sites;
+    /// Index into `sites` by source location
+    std::unordered_map<SiteKey, std::size_t, SiteKeyHash> site_ids;
+};
+
+void
+dump_at_exit()
+{
+    MemoryAccounting::dump(std::cerr);
+}
+
+std::string
+format_usage(const Usage & u)
+{
+    return fmt::format("{} bytes live in {} objects, peak {} bytes, {} allocations",
+                       u.live_bytes,
+                       u.live_allocations,
+                       u.peak_bytes,
+                       u.total_allocations);
+}
+
+} // namespace
+
+Usage
+MemoryAccounting::Snapshot::context(const Context & context) const
+{
+    for (auto & [ctx, usage] : this->contexts)
+        if (ctx == static_cast<cl_context>(context))
+            return usage;
+    return {};
+}
+
+Usage
+MemoryAccounting::Snapshot::device(const Device & device) const
+{
+    for (auto & [dev, usage] : this->devices)
+        if (dev == static_cast<cl_device_id>(device))
+            return usage;
+    return {};
+}
+
+void
+MemoryAccounting::track(cl_mem mem,
+                        cl_context context,
+                        std::size_t size,
+                        const std::source_location & loc)
+{
+    auto & r = Registry::get();
+    if (mem == nullptr || !r.enabled)
+        return;
+    auto site = r.add(context, size, loc);
+    auto * a = new Registry::Allocation { context, site, size };
+    auto err = clSetMemObjectDestructorCallback(mem, Registry::destroyed, a);
+    if (err != CL_SUCCESS) {
+        r.free(*a);
+        delete a;
+        OPENCL_CHECK(err);
+    }
+}
+
+MemoryAccounting::Snapshot
+MemoryAccounting::snapshot()
+{
+    auto & r = Registry::get();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    Snapshot snap;
+    snap.total = r.total;
+    snap.contexts.assign(r.contexts.begin(), r.contexts.end());
+    snap.devices.assign(r.devices.begin(), r.devices.end());
+    snap.sites = r.sites;
+    std::stable_sort(snap.sites.begin(), snap.sites.end(), [](const Site & a, const Site & b) {
+        return a.usage.live_bytes > b.usage.live_bytes;
+    });
+    return snap;
+}
+
+void
+MemoryAccounting::dump(std::ostream & os)
+{
+    auto snap = snapshot();
+    os << "Device memory: " << format_usage(snap.total) << std::endl;
+    for (auto & [id, usage] : snap.devices) {
+        Device dev(id);
+        os << fmt::format("  device '{}' ({} bytes): {}",
+                          dev.name(),
+                          dev.global_mem_size(),
+                          format_usage(usage))
+           << std::endl;
+    }
+    for (auto & s : snap.sites)
+        os << fmt::format("  {}:{} ({}): {}", s.file, s.line, s.function, format_usage(s.usage))
+           << std::endl;
+}
+
+void
+MemoryAccounting::set_dump_at_exit(bool enable)
+{
+    static std::once_flag registered;
+    static std::atomic<bool> dump = false;
+    dump = enable;
+    std::call_once(registered, [] {
+        std::atexit([] {
+            if (dump)
+                dump_at_exit();
+        });
+    });
+}
+
+void
+MemoryAccounting::set_enabled(bool enable)
+{
+    Registry::get().enabled = enable;
+}
+
+bool
+MemoryAccounting::enabled()
+{
+    return Registry::get().enabled;
+}
+
+void
+MemoryAccounting::reset_peaks()
+{
+    auto & r = Registry::get();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    reset_peak(r.total);
+    for (auto & [ctx, usage] : r.contexts)
+        reset_peak(usage);
+    for (auto & [dev, usage] : r.devices)
+        reset_peak(usage);
+    for (auto & s : r.sites)
+        reset_peak(s.usage);
+}
+
+} // namespace openclcpp_lite
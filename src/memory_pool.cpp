@@ -0,0 +1,276 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "openclcpp-lite/memory_pool.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/error.h"
+#include "openclcpp-lite/exception.h"
+#include "openclcpp-lite/memory_accounting.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace openclcpp_lite {
+
+struct MemoryPool::Data {
+    /// Memory reserved from the OpenCL implementation, split into blocks of one size class
+    struct Slab {
+        Memory mem;
+        std::size_t block_size;
+        std::size_t n_blocks;
+        std::size_t n_free;
+    };
+
+    /// Block of a slab
+    struct Block {
+        std::size_t slab;
+        std::size_t offset;
+    };
+
+    /// Live allocation, passed into the destructor callback of its sub-buffer
+    struct Allocation {
+        std::shared_ptr<Data> pool;
+        /// Size of the block, 0 for allocations that bypass the pool
+        std::size_t block_size;
+        Block block;
+        /// Requested size
+        std::size_t size;
+    };
+
+    Data(const Context & ctx,
+         std::size_t slab_sz,
+         cl_mem_flags mem_flags,
+         const std::source_location & location) :
+        context(ctx),
+        alignment(ctx.alignment()),
+        slab_size(slab_sz),
+        flags(mem_flags),
+        loc(location),
+        next_slab(0),
+        bytes_reserved(0),
+        bytes_in_use(0),
+        bytes_requested(0),
+        hits(0),
+        misses(0)
+    {
+        for (auto & dev : ctx.devices())
+            this->slab_size = std::min<std::size_t>(this->slab_size, dev.max_mem_alloc_size());
+    }
+
+    /// Return a block (or a direct allocation) into the pool
+    void
+    free(const Allocation & a)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->bytes_requested -= a.size;
+        if (a.block_size == 0) {
+            this->bytes_in_use -= a.size;
+            this->bytes_reserved -= a.size;
+            return;
+        }
+        this->bytes_in_use -= a.block_size;
+        this->slabs[a.block.slab].n_free++;
+        this->free_blocks[a.block_size].push_back(a.block);
+    }
+
+    /// Called by the OpenCL implementation when the sub-buffer of an allocation is destroyed
+    static void CL_CALLBACK
+    destroyed(cl_mem, void * user_data)
+    {
+        auto * a = static_cast<Allocation *>(user_data);
+        a->pool->free(*a);
+        delete a;
+    }
+
+    Context context;
+    /// Alignment of the blocks in bytes
+    std::size_t alignment;
+    /// Size of the slabs in bytes
+    std::size_t slab_size;
+    /// Memory flags of the slabs
+    cl_mem_flags flags;
+    /// Source location of the pool, recorded for its slabs and direct allocations
+    std::source_location loc;
+
+    std::mutex mutex;
+    /// Slabs by their id
+    std::map<std::size_t, Slab> slabs;
+    /// Id of the next slab
+    std::size_t next_slab;
+    /// Free blocks by block size
+    std::map<std::size_t, std::vector<Block>> free_blocks;
+
+    std::size_t bytes_reserved;
+    std::size_t bytes_in_use;
+    std::size_t bytes_requested;
+    std::uint64_t hits;
+    std::uint64_t misses;
+};
+
+double
+MemoryPool::Stats::fragmentation() const
+{
+    if (this->bytes_in_use == 0)
+        return 0.;
+    return 1. - (double) this->bytes_requested / this->bytes_in_use;
+}
+
+double
+MemoryPool::Stats::hit_rate() const
+{
+    auto n = this->hits + this->misses;
+    if (n == 0)
+        return 0.;
+    return (double) this->hits / n;
+}
+
+MemoryPool::MemoryPool(const Context & context,
+                       std::size_t slab_size,
+                       MemoryFlags mem_flags,
+                       std::source_location loc) :
+    data_(std::make_shared<Data>(context, slab_size, mem_flags, loc))
+{
+}
+
+Memory
+MemoryPool::allocate(std::size_t size)
+{
+    if (size == 0)
+        throw Exception("Memory pool allocations must not be empty");
+
+    auto & d = *this->data_;
+    auto block_size = size_class(size);
+    cl_int err;
+    if (block_size == 0) {
+        Memory mem(clCreateBuffer(d.context, d.flags, size, nullptr, &err));
+        OPENCL_CHECK(err);
+        MemoryAccounting::track(mem, d.context, size, d.loc);
+        auto * a = new Data::Allocation { this->data_, 0, { 0, 0 }, size };
+        err = clSetMemObjectDestructorCallback(mem, Data::destroyed, a);
+        if (err != CL_SUCCESS) {
+            delete a;
+            OPENCL_CHECK(err);
+        }
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.misses++;
+        d.bytes_reserved += size;
+        d.bytes_in_use += size;
+        d.bytes_requested += size;
+        return mem;
+    }
+
+    Data::Block block;
+    cl_mem slab;
+    {
+        std::lock_guard<std::mutex> lock(d.mutex);
+        auto & free = d.free_blocks[block_size];
+        if (free.empty()) {
+            auto n_blocks = std::max<std::size_t>(d.slab_size / block_size, 1);
+            Memory mem(clCreateBuffer(d.context, d.flags, n_blocks * block_size, nullptr, &err));
+            OPENCL_CHECK(err);
+            MemoryAccounting::track(mem, d.context, n_blocks * block_size, d.loc);
+            auto id = d.next_slab++;
+            for (std::size_t i = n_blocks; i > 0; i--)
+                free.push_back({ id, (i - 1) * block_size });
+            d.slabs.emplace(id, Data::Slab { std::move(mem), block_size, n_blocks, n_blocks });
+            d.bytes_reserved += n_blocks * block_size;
+            d.misses++;
+        }
+        else
+            d.hits++;
+        block = free.back();
+        free.pop_back();
+        auto & s = d.slabs[block.slab];
+        s.n_free--;
+        slab = s.mem;
+        d.bytes_in_use += block_size;
+        d.bytes_requested += size;
+    }
+
+    auto * a = new Data::Allocation { this->data_, block_size, block, size };
+    cl_buffer_region region = { block.offset, size };
+    Memory mem(clCreateSubBuffer(slab, 0, CL_BUFFER_CREATE_TYPE_REGION, &region, &err));
+    if (err == CL_SUCCESS)
+        err = clSetMemObjectDestructorCallback(mem, Data::destroyed, a);
+    if (err != CL_SUCCESS) {
+        d.free(*a);
+        delete a;
+        OPENCL_CHECK(err);
+    }
+    return mem;
+}
+
+Context
+MemoryPool::context() const
+{
+    return this->data_->context;
+}
+
+std::size_t
+MemoryPool::alignment() const
+{
+    return this->data_->alignment;
+}
+
+std::size_t
+MemoryPool::slab_size() const
+{
+    return this->data_->slab_size;
+}
+
+std::size_t
+MemoryPool::size_class(std::size_t size) const
+{
+    auto & d = *this->data_;
+    // larger sizes would overflow the block size below
+    if (size > d.slab_size)
+        return 0;
+    std::size_t block_size = d.alignment;
+    while (block_size < size)
+        block_size <<= 1;
+    return block_size <= d.slab_size ? block_size : 0;
+}
+
+MemoryPool::Stats
+MemoryPool::stats() const
+{
+    auto & d = *this->data_;
+    std::lock_guard<std::mutex> lock(d.mutex);
+    return { d.bytes_reserved, d.bytes_in_use, d.bytes_requested, d.hits, d.misses };
+}
+
+void
+MemoryPool::trim()
+{
+    auto & d = *this->data_;
+    std::vector<Memory> unused;
+    {
+        std::lock_guard<std::mutex> lock(d.mutex);
+        for (auto it = d.slabs.begin(); it != d.slabs.end();) {
+            auto & s = it->second;
+            if (s.n_free == s.n_blocks) {
+                auto id = it->first;
+                std::erase_if(d.free_blocks[s.block_size], [id](const Data::Block & b) {
+                    return b.slab == id;
+                });
+                d.bytes_reserved -= s.n_blocks * s.block_size;
+                unused.push_back(std::move(s.mem));
+                it = d.slabs.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+    // slabs are released here, outside of the lock
+}
+
+MemoryPool
+MemoryPool::get_default()
+{
+    static MemoryPool pool(Context::get_default());
+    return pool;
+}
+
+} // namespace openclcpp_lite
@@ -7,12 +7,52 @@
 #include "openclcpp-lite/utils.h"
 #include "openclcpp-lite/exception.h"
 #include "fmt/format.h"
+#include <utility>
 
 namespace openclcpp_lite {
 
 Program::Program() : prg_(nullptr) {}
 
-Program::Program(cl_program prg) : prg_(prg) {}
+Program::Program(cl_program prg, bool retain) : prg_(prg)
+{
+    if (retain && this->prg_ != nullptr)
+        OPENCL_CHECK(clRetainProgram(this->prg_));
+}
+
+Program::Program(const Program & other) : prg_(other.prg_)
+{
+    if (this->prg_ != nullptr)
+        OPENCL_CHECK(clRetainProgram(this->prg_));
+}
+
+Program::Program(Program && other) noexcept : prg_(other.prg_)
+{
+    other.prg_ = nullptr;
+}
+
+Program::~Program()
+{
+    if (this->prg_ != nullptr)
+        clReleaseProgram(this->prg_);
+}
+
+Program &
+Program::operator=(const Program & other)
+{
+    if (other.prg_ != nullptr)
+        OPENCL_CHECK(clRetainProgram(other.prg_));
+    if (this->prg_ != nullptr)
+        clReleaseProgram(this->prg_);
+    this->prg_ = other.prg_;
+    return *this;
+}
+
+Program &
+Program::operator=(Program && other) noexcept
+{
+    std::swap(this->prg_, other.prg_);
+    return *this;
+}
 
 void
 Program::retain() const
@@ -36,7 +76,7 @@ Context
 Program::context() const
 {
     auto ctx_id = get_info<cl_context>(CL_PROGRAM_CONTEXT);
-    return Context(ctx_id);
+    return Context(ctx_id, true);
 }
 
 std::vector<Device>
@@ -63,6 +103,13 @@ Program::kernel_names() const
     return utils::split(names, ";");
 }
 
+std::string
+Program::source() const
+{
+    auto src = get_info<std::string>(CL_PROGRAM_SOURCE);
+    return utils::rtrim_null(src);
+}
+
 std::vector<size_t>
 Program::binary_sizes() const
 {
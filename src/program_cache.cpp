@@ -0,0 +1,220 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "openclcpp-lite/program_cache.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/exception.h"
+#include "openclcpp-lite/utils.h"
+#include "fmt/format.h"
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace openclcpp_lite {
+
+namespace {
+
+/// Magic bytes at the beginning of every cache entry. Bump the version when the layout changes.
+const char MAGIC[8] = { 'O', 'C', 'L', 'P', 'C', 'C', '0', '1' };
+
+/// Extension of the cache entry files
+const char * EXT = ".bin";
+
+void
+write_u64(std::ofstream & ofs, uint64_t val)
+{
+    ofs.write(reinterpret_cast<const char *>(&val), sizeof(val));
+}
+
+bool
+read_u64(std::ifstream & ifs, uint64_t & val)
+{
+    ifs.read(reinterpret_cast<char *>(&val), sizeof(val));
+    return ifs.good();
+}
+
+} // namespace
+
+ProgramCache::ProgramCache(const std::string & directory) : dir_(directory), hits_(0), misses_(0)
+{
+    std::error_code ec;
+    fs::create_directories(this->dir_, ec);
+    if (ec)
+        throw Exception(fmt::format("Failed to create program cache directory '{}': {}",
+                                    this->dir_,
+                                    ec.message()));
+}
+
+const std::string &
+ProgramCache::directory() const
+{
+    return this->dir_;
+}
+
+Program
+ProgramCache::build(const std::string & source, const std::vector<std::string> & options)
+{
+    auto context = Context::get_default();
+    return build(context, source, options);
+}
+
+Program
+ProgramCache::build(const Context & context,
+                    const std::string & source,
+                    const std::vector<std::string> & options)
+{
+    auto devices = context.devices();
+    std::vector<std::vector<char>> bins(devices.size());
+    bool all_cached = true;
+    for (std::size_t i = 0; i < devices.size() && all_cached; i++) {
+        auto descr = descriptor(source, options, devices[i]);
+        auto path = entry_path(utils::to_hex(utils::hash(descr)));
+        all_cached = load(path, descr, bins[i]);
+    }
+
+    if (all_cached) {
+        try {
+            auto prg = Program::from_binary(context, devices, bins);
+            prg.build(options);
+            this->hits_++;
+            return prg;
+        }
+        catch (Exception &) {
+            // The driver refused the cached binaries, rebuild them from source below
+        }
+    }
+
+    auto prg = Program::from_source(context, source);
+    prg.build(options);
+    this->misses_++;
+
+    auto prg_devices = prg.devices();
+    auto prg_bins = prg.binaries();
+    for (std::size_t i = 0; i < prg_devices.size(); i++) {
+        if (prg_bins[i].empty())
+            continue;
+        auto descr = descriptor(source, options, prg_devices[i]);
+        store(entry_path(utils::to_hex(utils::hash(descr))), descr, prg_bins[i]);
+    }
+    return prg;
+}
+
+std::string
+ProgramCache::key(const std::string & source,
+                  const std::vector<std::string> & options,
+                  const Device & device) const
+{
+    return utils::to_hex(utils::hash(descriptor(source, options, device)));
+}
+
+unsigned int
+ProgramCache::hits() const
+{
+    return this->hits_;
+}
+
+unsigned int
+ProgramCache::misses() const
+{
+    return this->misses_;
+}
+
+void
+ProgramCache::clear() const
+{
+    std::error_code ec;
+    for (auto & entry : fs::directory_iterator(this->dir_, ec))
+        if (entry.is_regular_file() && entry.path().extension() == EXT)
+            fs::remove(entry.path(), ec);
+}
+
+std::string
+ProgramCache::descriptor(const std::string & source,
+                         const std::vector<std::string> & options,
+                         const Device & device) const
+{
+    return fmt::format("source:{}\noptions:{}\ndevice:{}\ndriver:{}\n",
+                       utils::to_hex(utils::hash(source)),
+                       utils::join(" ", options),
+                       device.name(),
+                       device.driver_version());
+}
+
+std::string
+ProgramCache::entry_path(const std::string & key) const
+{
+    return (fs::path(this->dir_) / (key + EXT)).string();
+}
+
+bool
+ProgramCache::load(const std::string & path,
+                   const std::string & descr,
+                   std::vector<char> & binary) const
+{
+    std::ifstream ifs(path, std::ifstream::in | std::ifstream::binary);
+    if (!ifs.is_open())
+        return false;
+
+    char magic[sizeof(MAGIC)];
+    ifs.read(magic, sizeof(magic));
+    if (!ifs.good() || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        return false;
+
+    uint64_t descr_len;
+    if (!read_u64(ifs, descr_len) || descr_len != descr.size())
+        return false;
+    std::string stored_descr(descr_len, '\0');
+    ifs.read(stored_descr.data(), descr_len);
+    if (!ifs.good() || stored_descr != descr)
+        return false;
+
+    uint64_t bin_len, bin_hash;
+    if (!read_u64(ifs, bin_len) || !read_u64(ifs, bin_hash) || bin_len == 0)
+        return false;
+    std::vector<char> bin(bin_len);
+    ifs.read(bin.data(), bin_len);
+    if (!ifs.good() || utils::hash_bytes(bin.data(), bin.size()) != bin_hash)
+        return false;
+
+    binary = std::move(bin);
+    return true;
+}
+
+void
+ProgramCache::store(const std::string & path,
+                    const std::string & descr,
+                    const std::vector<char> & binary) const
+{
+    // Write into a uniquely named temporary file and rename it over the entry, so that readers in
+    // other processes never see a partially written entry
+    std::random_device rd;
+    auto tmp_path = fmt::format("{}.{:08x}.tmp", path, rd());
+    {
+        std::ofstream ofs(tmp_path, std::ofstream::out | std::ofstream::binary);
+        if (!ofs.is_open())
+            return;
+        ofs.write(MAGIC, sizeof(MAGIC));
+        write_u64(ofs, descr.size());
+        ofs.write(descr.data(), descr.size());
+        write_u64(ofs, binary.size());
+        write_u64(ofs, utils::hash_bytes(binary.data(), binary.size()));
+        ofs.write(binary.data(), binary.size());
+        ofs.close();
+        if (!ofs.good()) {
+            std::error_code ec;
+            fs::remove(tmp_path, ec);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    if (ec)
+        fs::remove(tmp_path, ec);
+}
+
+} // namespace openclcpp_lite
@@ -2,16 +2,154 @@
 // SPDX-License-Identifier: MIT
 
 #include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/command_graph.h"
 #include "openclcpp-lite/context.h"
 #include "openclcpp-lite/buffer.h"
 #include "openclcpp-lite/event.h"
 #include "openclcpp-lite/range.h"
 #include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/tuning_database.h"
+#include "openclcpp-lite/staging_pool.h"
+#include <cstring>
+#include <optional>
+#include <unordered_map>
+#include <utility>
 
 namespace openclcpp_lite {
 
+class Queue::DependencyTracker {
+public:
+    /// Add events of the commands that a new command depends on into `deps`
+    ///
+    /// @param reads Memory objects the new command reads from
+    /// @param writes Memory objects the new command writes into
+    /// @param deps Wait list of the new command
+    void
+    collect(std::span<const cl_mem> reads,
+            std::span<const cl_mem> writes,
+            WaitListStorage & deps)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        deps.push_back(this->barrier_);
+        if (reads.empty() && writes.empty()) {
+            for (auto & [mem, st] : this->state_) {
+                deps.push_back(st.writer);
+                deps.append(st.readers);
+            }
+        }
+        else {
+            // read-after-write
+            for (auto & mem : reads) {
+                auto it = this->state_.find(mem);
+                if (it != this->state_.end())
+                    deps.push_back(it->second.writer);
+            }
+            // write-after-write and write-after-read
+            for (auto & mem : writes) {
+                auto it = this->state_.find(mem);
+                if (it != this->state_.end()) {
+                    deps.push_back(it->second.writer);
+                    deps.append(it->second.readers);
+                }
+            }
+        }
+    }
+
+    /// Record an enqueued command
+    ///
+    /// @param reads Memory objects the command reads from
+    /// @param writes Memory objects the command writes into
+    /// @param evt Event of the command, null if the command has already completed
+    void
+    record(std::span<const cl_mem> reads, std::span<const cl_mem> writes, const Event & evt)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        if (reads.empty() && writes.empty()) {
+            // everything enqueued so far is a dependency of `evt`
+            this->state_.clear();
+            this->barrier_ = evt;
+            return;
+        }
+
+        if (evt != nullptr) {
+            for (auto & mem : reads) {
+                auto & readers = this->state_[mem].readers;
+                if (readers.size() >= MAX_READERS)
+                    prune(readers);
+                readers.push_back(evt);
+            }
+            for (auto & mem : writes) {
+                auto & st = this->state_[mem];
+                st.writer = evt;
+                st.readers.clear();
+            }
+        }
+        else {
+            for (auto & mem : writes)
+                this->state_.erase(mem);
+        }
+    }
+
+    /// Forget all recorded commands
+    void
+    clear()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->state_.clear();
+        this->barrier_ = Event();
+    }
+
+private:
+    /// Number of readers after which completed readers are dropped
+    static constexpr std::size_t MAX_READERS = 16;
+
+    /// Remove events of completed commands
+    static void
+    prune(std::vector<Event> & events)
+    {
+        std::erase_if(events, [](const Event & e) {
+            auto status = e.command_execution_status();
+            return status == COMPLETE || status == ERROR;
+        });
+    }
+
+    struct State {
+        /// Last command that wrote into the memory object
+        Event writer;
+        /// Commands that read from the memory object since the last write
+        std::vector<Event> readers;
+    };
+
+    std::mutex mutex_;
+    /// State of tracked memory objects
+    std::unordered_map<cl_mem, State> state_;
+    /// Last command with unknown memory accesses
+    Event barrier_;
+};
+
 std::once_flag Queue::have_default_;
 Queue Queue::default_queue_;
+std::atomic<DefaultQueuePolicy> Queue::default_policy_ = SHARED;
+
+namespace {
+
+/// Default queue of a thread. The queue is released when the thread exits.
+struct ThreadQueue {
+    ThreadQueue()
+    {
+        auto ctx = Context::get_default();
+        auto device = Device::get_default();
+        cl_int err;
+        this->q = clCreateCommandQueue(ctx, device, 0, &err);
+        OPENCL_CHECK(err);
+    }
+
+    ~ThreadQueue() { clReleaseCommandQueue(this->q); }
+
+    cl_command_queue q;
+};
+
+} // namespace
 
 Queue::Queue() : q_(nullptr) {}
 
@@ -38,7 +176,88 @@ Queue::Queue(const Context & context, const Device & device, bool enable_profili
     OPENCL_CHECK(err);
 }
 
-Queue::Queue(cl_command_queue q) : q_(q) {}
+Queue::Queue(const Context & context, QueueProperties properties) :
+    Queue(context, context.devices()[0], properties)
+{
+}
+
+Queue::Queue(const Context & context, QueueProperty property) :
+    Queue(context, QueueProperties(property))
+{
+}
+
+Queue::Queue(const Context & context, const Device & device, QueueProperties properties)
+{
+    cl_device_id device_id = device;
+    cl_command_queue_properties props = properties;
+    cl_int err;
+    this->q_ = clCreateCommandQueue(context, device_id, props, &err);
+    OPENCL_CHECK(err);
+    if (props & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)
+        this->deps_ = std::make_shared<DependencyTracker>();
+}
+
+Queue::Queue(const Context & context, const Device & device, QueueProperty property) :
+    Queue(context, device, QueueProperties(property))
+{
+}
+
+Queue::Queue(cl_command_queue q, bool retain) : q_(q)
+{
+    if (retain && this->q_ != nullptr)
+        OPENCL_CHECK(clRetainCommandQueue(this->q_));
+}
+
+Queue::Queue(const Queue & other) : q_(other.q_),
+    deps_(other.deps_),
+    tuning_(other.tuning_),
+    tuning_device_(other.tuning_device_),
+    staging_(other.staging_)
+{
+    if (this->q_ != nullptr)
+        OPENCL_CHECK(clRetainCommandQueue(this->q_));
+}
+
+Queue::Queue(Queue && other) noexcept : q_(other.q_),
+    deps_(std::move(other.deps_)),
+    tuning_(std::move(other.tuning_)),
+    tuning_device_(other.tuning_device_),
+    staging_(std::move(other.staging_))
+{
+    other.q_ = nullptr;
+}
+
+Queue::~Queue()
+{
+    if (this->q_ != nullptr)
+        clReleaseCommandQueue(this->q_);
+}
+
+Queue &
+Queue::operator=(const Queue & other)
+{
+    if (other.q_ != nullptr)
+        OPENCL_CHECK(clRetainCommandQueue(other.q_));
+    if (this->q_ != nullptr)
+        clReleaseCommandQueue(this->q_);
+    this->q_ = other.q_;
+    this->deps_ = other.deps_;
+    this->tuning_ = other.tuning_;
+    this->tuning_device_ = other.tuning_device_;
+    this->staging_ = other.staging_;
+    return *this;
+}
+
+Queue &
+Queue::operator=(Queue && other) noexcept
+{
+    std::swap(this->q_, other.q_);
+    std::swap(this->deps_, other.deps_);
+    std::swap(this->tuning_, other.tuning_);
+    std::swap(this->tuning_device_, other.tuning_device_);
+    std::swap(this->staging_, other.staging_);
+    return *this;
+}
 
 void
 Queue::retain() const
@@ -56,7 +275,7 @@ Context
 Queue::context() const
 {
     auto ctx_id = get_info<cl_context>(CL_QUEUE_CONTEXT);
-    return Context(ctx_id);
+    return Context(ctx_id, true);
 }
 
 Device
@@ -72,22 +291,70 @@ Queue::reference_count() const
     return get_info<cl_uint>(CL_QUEUE_REFERENCE_COUNT);
 }
 
+QueueProperties
+Queue::properties() const
+{
+    auto props = get_info<cl_command_queue_properties>(CL_QUEUE_PROPERTIES);
+    return QueueProperties(Flags<QueueProperty>(static_cast<unsigned int>(props)));
+}
+
+bool
+Queue::out_of_order() const
+{
+    auto props = get_info<cl_command_queue_properties>(CL_QUEUE_PROPERTIES);
+    return (props & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) != 0;
+}
+
+WaitList
+Queue::dependencies(std::span<const cl_mem> reads,
+                    std::span<const cl_mem> writes,
+                    WaitList wait_list,
+                    WaitListStorage & storage) const
+{
+    if (this->deps_ == nullptr)
+        return wait_list.dense(storage);
+    storage.append(wait_list);
+    this->deps_->collect(reads, writes, storage);
+    return storage;
+}
+
+void
+Queue::record(std::span<const cl_mem> reads,
+              std::span<const cl_mem> writes,
+              const Event & evt) const
+{
+    if (this->deps_ != nullptr)
+        this->deps_->record(reads, writes, evt);
+}
+
 void
 Queue::enqueue_read_raw(const Memory & buffer,
                         size_t offset,
                         size_t size,
                         void * ptr,
-                        const std::vector<Event> & wait_list) const
+                        WaitList wait_list) const
 {
+    cl_mem mem = buffer;
+    WaitListStorage storage;
+    auto deps = dependencies({ &mem, 1 }, {}, wait_list, storage);
+    if (aliases(buffer, offset, ptr)) {
+        enqueue_sync_host_raw(mem, READ, offset, size, deps).wait();
+        return;
+    }
+    std::optional<StagingBuffer> stage;
+    if (staged(size))
+        stage.emplace(this->staging_->acquire(size));
     OPENCL_CHECK(clEnqueueReadBuffer(this->q_,
-                                     buffer,
+                                     mem,
                                      CL_TRUE,
                                      offset,
                                      size,
-                                     ptr,
-                                     wait_list.size(),
-                                     wait_list.empty() ? nullptr : (cl_event *) &wait_list.front(),
+                                     stage ? stage->data() : ptr,
+                                     deps.size(),
+                                     deps.data(),
                                      nullptr));
+    if (stage)
+        std::memcpy(ptr, stage->data(), size);
 }
 
 Event
@@ -95,19 +362,31 @@ Queue::enqueue_iread_raw(const Memory & buffer,
                          size_t offset,
                          size_t size,
                          void * ptr,
-                         const std::vector<Event> & wait_list) const
+                         WaitList wait_list) const
 {
+    cl_mem mem = buffer;
+    WaitListStorage storage;
+    auto deps = dependencies({ &mem, 1 }, {}, wait_list, storage);
+    if (aliases(buffer, offset, ptr)) {
+        auto e = enqueue_sync_host_raw(mem, READ, offset, size, deps);
+        record({ &mem, 1 }, {}, e);
+        return e;
+    }
+    // not staged: a copy out of pinned memory would finish after the read command, and neither
+    // `wait()` nor the commands enqueued later could wait for it
     cl_event evt;
     OPENCL_CHECK(clEnqueueReadBuffer(this->q_,
-                                     buffer,
+                                     mem,
                                      CL_FALSE,
                                      offset,
                                      size,
                                      ptr,
-                                     wait_list.size(),
-                                     wait_list.empty() ? nullptr : (cl_event *) &wait_list.front(),
+                                     deps.size(),
+                                     deps.data(),
                                      &evt));
-    return Event(evt);
+    Event e(evt);
+    record({ &mem, 1 }, {}, e);
+    return e;
 }
 
 void
@@ -115,17 +394,32 @@ Queue::enqueue_write_raw(const Memory & buffer,
                          size_t offset,
                          size_t size,
                          const void * ptr,
-                         const std::vector<Event> & wait_list) const
+                         WaitList wait_list) const
 {
+    cl_mem mem = buffer;
+    WaitListStorage storage;
+    auto deps = dependencies({}, { &mem, 1 }, wait_list, storage);
+    if (aliases(buffer, offset, ptr)) {
+        enqueue_sync_host_raw(mem, WRITE_INVALIDATE_REGION, offset, size, deps).wait();
+        record({}, { &mem, 1 }, Event());
+        return;
+    }
+    std::optional<StagingBuffer> stage;
+    if (staged(size)) {
+        stage.emplace(this->staging_->acquire(size));
+        std::memcpy(stage->data(), ptr, size);
+        ptr = stage->data();
+    }
     OPENCL_CHECK(clEnqueueWriteBuffer(this->q_,
-                                      buffer,
+                                      mem,
                                       CL_TRUE,
                                       offset,
                                       size,
                                       ptr,
-                                      wait_list.size(),
-                                      wait_list.empty() ? nullptr : (cl_event *) &wait_list.front(),
+                                      deps.size(),
+                                      deps.data(),
                                       nullptr));
+    record({}, { &mem, 1 }, Event());
 }
 
 Event
@@ -133,19 +427,37 @@ Queue::enqueue_iwrite_raw(const Memory & buffer,
                           size_t offset,
                           size_t size,
                           const void * ptr,
-                          const std::vector<Event> & wait_list) const
+                          WaitList wait_list) const
 {
+    cl_mem mem = buffer;
+    WaitListStorage storage;
+    auto deps = dependencies({}, { &mem, 1 }, wait_list, storage);
+    if (aliases(buffer, offset, ptr)) {
+        auto e = enqueue_sync_host_raw(mem, WRITE_INVALIDATE_REGION, offset, size, deps);
+        record({}, { &mem, 1 }, e);
+        return e;
+    }
+    std::optional<StagingBuffer> stage;
+    if (staged(size)) {
+        stage.emplace(this->staging_->acquire(size));
+        std::memcpy(stage->data(), ptr, size);
+        ptr = stage->data();
+    }
     cl_event evt;
     OPENCL_CHECK(clEnqueueWriteBuffer(this->q_,
-                                      buffer,
+                                      mem,
                                       CL_FALSE,
                                       offset,
                                       size,
                                       ptr,
-                                      wait_list.size(),
-                                      wait_list.empty() ? nullptr : (cl_event *) &wait_list.front(),
+                                      deps.size(),
+                                      deps.data(),
                                       &evt));
-    return Event(evt);
+    Event e(evt);
+    record({}, { &mem, 1 }, e);
+    if (stage)
+        stage->in_use_until(e);
+    return e;
 }
 
 Event
@@ -154,19 +466,130 @@ Queue::enqueue_copy_raw(const Memory & src,
                         size_t src_offset,
                         size_t dest_offset,
                         size_t size,
-                        const std::vector<Event> & wait_list) const
+                        WaitList wait_list) const
 {
+    cl_mem src_mem = src;
+    cl_mem dest_mem = dest;
+    WaitListStorage storage;
+    auto deps = dependencies({ &src_mem, 1 }, { &dest_mem, 1 }, wait_list, storage);
     cl_event evt;
     OPENCL_CHECK(clEnqueueCopyBuffer(this->q_,
-                                     src,
-                                     dest,
+                                     src_mem,
+                                     dest_mem,
                                      src_offset,
                                      dest_offset,
                                      size,
-                                     wait_list.size(),
-                                     wait_list.empty() ? nullptr : (cl_event *) &wait_list.front(),
+                                     deps.size(),
+                                     deps.data(),
                                      &evt));
-    return Event(evt);
+    Event e(evt);
+    record({ &src_mem, 1 }, { &dest_mem, 1 }, e);
+    return e;
+}
+
+Event
+Queue::enqueue_iread_rect_raw(const Memory & buffer,
+                              const size_t * buffer_origin,
+                              const size_t * host_origin,
+                              const size_t * region,
+                              size_t buffer_row_pitch,
+                              size_t buffer_slice_pitch,
+                              size_t host_row_pitch,
+                              size_t host_slice_pitch,
+                              void * ptr,
+                              WaitList wait_list) const
+{
+    cl_mem mem = buffer;
+    WaitListStorage storage;
+    auto deps = dependencies({ &mem, 1 }, {}, wait_list, storage);
+    cl_event evt;
+    OPENCL_CHECK(clEnqueueReadBufferRect(this->q_,
+                                         mem,
+                                         CL_FALSE,
+                                         buffer_origin,
+                                         host_origin,
+                                         region,
+                                         buffer_row_pitch,
+                                         buffer_slice_pitch,
+                                         host_row_pitch,
+                                         host_slice_pitch,
+                                         ptr,
+                                         deps.size(),
+                                         deps.data(),
+                                         &evt));
+    Event e(evt);
+    record({ &mem, 1 }, {}, e);
+    return e;
+}
+
+Event
+Queue::enqueue_iwrite_rect_raw(const Memory & buffer,
+                               const size_t * buffer_origin,
+                               const size_t * host_origin,
+                               const size_t * region,
+                               size_t buffer_row_pitch,
+                               size_t buffer_slice_pitch,
+                               size_t host_row_pitch,
+                               size_t host_slice_pitch,
+                               const void * ptr,
+                               WaitList wait_list) const
+{
+    cl_mem mem = buffer;
+    WaitListStorage storage;
+    auto deps = dependencies({}, { &mem, 1 }, wait_list, storage);
+    cl_event evt;
+    OPENCL_CHECK(clEnqueueWriteBufferRect(this->q_,
+                                          mem,
+                                          CL_FALSE,
+                                          buffer_origin,
+                                          host_origin,
+                                          region,
+                                          buffer_row_pitch,
+                                          buffer_slice_pitch,
+                                          host_row_pitch,
+                                          host_slice_pitch,
+                                          ptr,
+                                          deps.size(),
+                                          deps.data(),
+                                          &evt));
+    Event e(evt);
+    record({}, { &mem, 1 }, e);
+    return e;
+}
+
+Event
+Queue::enqueue_copy_rect_raw(const Memory & src,
+                             const Memory & dest,
+                             const size_t * src_origin,
+                             const size_t * dest_origin,
+                             const size_t * region,
+                             size_t src_row_pitch,
+                             size_t src_slice_pitch,
+                             size_t dest_row_pitch,
+                             size_t dest_slice_pitch,
+                             WaitList wait_list) const
+{
+    cl_mem src_mem = src;
+    cl_mem dest_mem = dest;
+    WaitListStorage storage;
+    auto deps = dependencies({ &src_mem, 1 }, { &dest_mem, 1 }, wait_list, storage);
+    cl_event evt;
+    OPENCL_CHECK(clEnqueueCopyBufferRect(this->q_,
+                                         src_mem,
+                                         dest_mem,
+                                         src_origin,
+                                         dest_origin,
+                                         region,
+                                         src_row_pitch,
+                                         src_slice_pitch,
+                                         dest_row_pitch,
+                                         dest_slice_pitch,
+                                         deps.size(),
+                                         deps.data(),
+                                         &evt));
+    Event e(evt);
+    record({ &src_mem, 1 }, { &dest_mem, 1 }, e);
+    return e;
 }
 
 void *
@@ -176,18 +599,43 @@ Queue::enqueue_map_buffer_raw(const Memory & buffer,
                               size_t offset,
                               size_t size) const
 {
+    Event evt;
+    return enqueue_map_buffer_raw(buffer, blocking, flags, offset, size, evt);
+}
+
+void *
+Queue::enqueue_map_buffer_raw(const Memory & buffer,
+                              bool blocking,
+                              MapFlags flags,
+                              size_t offset,
+                              size_t size,
+                              Event & evt) const
+{
+    cl_mem mem = buffer;
+    cl_map_flags map_flags = flags;
+    std::span<const cl_mem> reads, writes;
+    if (map_flags & CL_MAP_READ)
+        reads = { &mem, 1 };
+    if (map_flags & (CL_MAP_WRITE | CL_MAP_WRITE_INVALIDATE_REGION))
+        writes = { &mem, 1 };
+    WaitList wait_list;
+    WaitListStorage storage;
+    auto deps = dependencies(reads, writes, wait_list, storage);
+    cl_event map_evt;
     cl_int err;
     auto ret = clEnqueueMapBuffer(this->q_,
-                                  buffer,
+                                  mem,
                                   blocking ? CL_TRUE : CL_FALSE,
-                                  flags,
+                                  map_flags,
                                   offset,
                                   size,
-                                  0,
-                                  nullptr,
-                                  nullptr,
+                                  deps.size(),
+                                  deps.data(),
+                                  &map_evt,
                                   &err);
     OPENCL_CHECK(err);
+    evt = Event(map_evt);
+    record(reads, writes, evt);
     return ret;
 }
 
@@ -197,50 +645,263 @@ Queue::enqueue_fill_buffer_raw(const Memory & buffer,
                                size_t pattern_size,
                                size_t offset,
                                size_t size,
-                               const std::vector<Event> & wait_list) const
+                               WaitList wait_list) const
 {
+    cl_mem mem = buffer;
+    WaitListStorage storage;
+    auto deps = dependencies({}, { &mem, 1 }, wait_list, storage);
     cl_event evt;
     OPENCL_CHECK(clEnqueueFillBuffer(this->q_,
-                                     buffer,
+                                     mem,
                                      pattern,
                                      pattern_size,
                                      offset,
                                      size,
-                                     wait_list.size(),
-                                     wait_list.empty() ? nullptr : (cl_event *) &wait_list.front(),
+                                     deps.size(),
+                                     deps.data(),
                                      &evt));
+    Event e(evt);
+    record({}, { &mem, 1 }, e);
+    return e;
+}
+
+Event
+Queue::enqueue_iread_image_raw(const Memory & image,
+                               const size_t * origin,
+                               const size_t * region,
+                               void * ptr,
+                               WaitList wait_list) const
+{
+    cl_mem mem = image;
+    WaitListStorage storage;
+    auto deps = dependencies({ &mem, 1 }, {}, wait_list, storage);
+    cl_event evt;
+    OPENCL_CHECK(clEnqueueReadImage(this->q_,
+                                    mem,
+                                    CL_FALSE,
+                                    origin,
+                                    region,
+                                    0,
+                                    0,
+                                    ptr,
+                                    deps.size(),
+                                    deps.data(),
+                                    &evt));
+    Event e(evt);
+    record({ &mem, 1 }, {}, e);
+    return e;
+}
+
+Event
+Queue::enqueue_iwrite_image_raw(const Memory & image,
+                                const size_t * origin,
+                                const size_t * region,
+                                const void * ptr,
+                                WaitList wait_list) const
+{
+    cl_mem mem = image;
+    WaitListStorage storage;
+    auto deps = dependencies({}, { &mem, 1 }, wait_list, storage);
+    cl_event evt;
+    OPENCL_CHECK(clEnqueueWriteImage(this->q_,
+                                     mem,
+                                     CL_FALSE,
+                                     origin,
+                                     region,
+                                     0,
+                                     0,
+                                     ptr,
+                                     deps.size(),
+                                     deps.data(),
+                                     &evt));
+    Event e(evt);
+    record({}, { &mem, 1 }, e);
+    return e;
+}
+
+Event
+Queue::enqueue_copy_image_raw(const Memory & src,
+                              const Memory & dest,
+                              const size_t * src_origin,
+                              const size_t * dest_origin,
+                              const size_t * region,
+                              WaitList wait_list) const
+{
+    cl_mem src_mem = src;
+    cl_mem dest_mem = dest;
+    WaitListStorage storage;
+    auto deps = dependencies({ &src_mem, 1 }, { &dest_mem, 1 }, wait_list, storage);
+    cl_event evt;
+    OPENCL_CHECK(clEnqueueCopyImage(this->q_,
+                                    src_mem,
+                                    dest_mem,
+                                    src_origin,
+                                    dest_origin,
+                                    region,
+                                    deps.size(),
+                                    deps.data(),
+                                    &evt));
+    Event e(evt);
+    record({ &src_mem, 1 }, { &dest_mem, 1 }, e);
+    return e;
+}
+
+Event
+Queue::enqueue_fill_image_raw(const Memory & image,
+                              const void * color,
+                              const size_t * origin,
+                              const size_t * region,
+                              WaitList wait_list) const
+{
+    cl_mem mem = image;
+    WaitListStorage storage;
+    auto deps = dependencies({}, { &mem, 1 }, wait_list, storage);
+    cl_event evt;
+    OPENCL_CHECK(clEnqueueFillImage(this->q_,
+                                    mem,
+                                    color,
+                                    origin,
+                                    region,
+                                    deps.size(),
+                                    deps.data(),
+                                    &evt));
+    Event e(evt);
+    record({}, { &mem, 1 }, e);
+    return e;
+}
+
+#ifdef CL_VERSION_2_0
+Event
+Queue::enqueue_svm_map_raw(void * ptr,
+                           size_t size,
+                           MapFlags flags,
+                           bool blocking,
+                           WaitList wait_list) const
+{
+    WaitListStorage storage;
+    auto deps = dependencies({}, {}, wait_list, storage);
+    cl_event evt;
+    OPENCL_CHECK(clEnqueueSVMMap(this->q_,
+                                 blocking ? CL_TRUE : CL_FALSE,
+                                 flags,
+                                 ptr,
+                                 size,
+                                 deps.size(),
+                                 deps.data(),
+                                 &evt));
+    Event e(evt);
+    record({}, {}, e);
+    return e;
+}
+
+Event
+Queue::svm_unmap(void * ptr, WaitList wait_list) const
+{
+    WaitListStorage storage;
+    auto deps = dependencies({}, {}, wait_list, storage);
+    cl_event evt;
+    OPENCL_CHECK(clEnqueueSVMUnmap(this->q_, ptr, deps.size(), deps.data(), &evt));
+    Event e(evt);
+    record({}, {}, e);
+    return e;
+}
+#endif
+
+Event
+Queue::migrate(std::span<const cl_mem> mems, MigrationFlags flags, WaitList wait_list) const
+{
+    WaitListStorage storage;
+    auto deps = dependencies({}, mems, wait_list, storage);
+    cl_event evt;
+    OPENCL_CHECK(clEnqueueMigrateMemObjects(this->q_,
+                                            mems.size(),
+                                            mems.data(),
+                                            flags,
+                                            deps.size(),
+                                            deps.data(),
+                                            &evt));
+    Event e(evt);
+    record({}, mems, e);
+    return e;
+}
+
+Event
+Queue::migrate(const Memory & mem, MigrationFlags flags, WaitList wait_list) const
+{
+    cl_mem m = mem;
+    return migrate({ &m, 1 }, flags, wait_list);
+}
+
+bool
+Queue::aliases(const Memory & buffer, size_t offset, const void * ptr)
+{
+    auto * host = static_cast<const char *>(buffer.host_storage());
+    return host != nullptr && host + offset == ptr;
+}
+
+Event
+Queue::enqueue_sync_host_raw(cl_mem mem,
+                             MapFlags flags,
+                             size_t offset,
+                             size_t size,
+                             WaitList wait_list) const
+{
+    cl_event map_evt;
+    cl_int err;
+    auto ptr = clEnqueueMapBuffer(this->q_,
+                                  mem,
+                                  CL_FALSE,
+                                  flags,
+                                  offset,
+                                  size,
+                                  wait_list.size(),
+                                  wait_list.data(),
+                                  &map_evt,
+                                  &err);
+    OPENCL_CHECK(err);
+    Event m(map_evt);
+    cl_event evt;
+    OPENCL_CHECK(clEnqueueUnmapMemObject(this->q_, mem, ptr, 1, &map_evt, &evt));
     return Event(evt);
 }
 
 Event
 Queue::enqueue_unmap_mem_object(const Memory & mem, void * mapped_ptr) const
 {
+    // The mapped region may have been written on the host, so unmapping is treated as a write
+    cl_mem m = mem;
+    WaitList wait_list;
+    WaitListStorage storage;
+    auto deps = dependencies({}, { &m, 1 }, wait_list, storage);
     cl_event evt;
-    OPENCL_CHECK(clEnqueueUnmapMemObject(this->q_, mem, mapped_ptr, 0, nullptr, &evt));
-    return Event { evt };
+    OPENCL_CHECK(clEnqueueUnmapMemObject(this->q_,
+                                         m,
+                                         mapped_ptr,
+                                         deps.size(),
+                                         deps.data(),
+                                         &evt));
+    Event e(evt);
+    record({}, { &m, 1 }, e);
+    return e;
 }
 
 Event
-Queue::enqueue_barrier(const std::vector<Event> & wait_list) const
+Queue::enqueue_barrier(WaitList wait_list) const
 {
+    WaitListStorage storage;
+    auto waits = wait_list.dense(storage);
     cl_event evt;
-    OPENCL_CHECK(
-        clEnqueueBarrierWithWaitList(this->q_,
-                                     wait_list.size(),
-                                     wait_list.empty() ? nullptr : (cl_event *) &wait_list.front(),
-                                     &evt));
+    OPENCL_CHECK(clEnqueueBarrierWithWaitList(this->q_, waits.size(), waits.data(), &evt));
     return Event(evt);
 }
 
 Event
-Queue::enqueue_marker(const std::vector<Event> & wait_list) const
+Queue::enqueue_marker(WaitList wait_list) const
 {
+    WaitListStorage storage;
+    auto waits = wait_list.dense(storage);
     cl_event evt;
-    OPENCL_CHECK(
-        clEnqueueMarkerWithWaitList(this->q_,
-                                    wait_list.size(),
-                                    wait_list.empty() ? nullptr : (cl_event *) &wait_list.front(),
-                                    &evt));
+    OPENCL_CHECK(clEnqueueMarkerWithWaitList(this->q_, waits.size(), waits.data(), &evt));
     return Event(evt);
 }
 
@@ -250,15 +911,83 @@ Queue::flush() const
     OPENCL_CHECK(clFlush(this->q_));
 }
 
+CommandGraph
+Queue::record(const std::function<void(Handler &)> & f)
+{
+    CommandGraph graph(*this);
+    Handler h(*this, &graph);
+    graph.begin();
+    try {
+        f(h);
+    }
+    catch (...) {
+        graph.end();
+        throw;
+    }
+    graph.end();
+    return graph;
+}
+
 void
 Queue::wait() const
 {
     OPENCL_CHECK(clFinish(this->q_));
+    if (this->deps_ != nullptr)
+        this->deps_->clear();
+}
+
+void
+Queue::set_tuning_database(std::shared_ptr<TuningDatabase> db)
+{
+    this->tuning_ = db;
+    // launches look up the database by device, resolve it once rather than on every launch
+    this->tuning_device_ = db != nullptr ? get_info<cl_device_id>(CL_QUEUE_DEVICE) : nullptr;
+}
+
+std::shared_ptr<TuningDatabase>
+Queue::tuning_database() const
+{
+    return this->tuning_;
+}
+
+void
+Queue::set_staging_pool(std::shared_ptr<StagingPool> pool)
+{
+    this->staging_ = pool;
+}
+
+std::shared_ptr<StagingPool>
+Queue::staging_pool() const
+{
+    return this->staging_;
+}
+
+bool
+Queue::staged(size_t size) const
+{
+    return this->staging_ != nullptr && size >= this->staging_->threshold();
+}
+
+bool
+Queue::tuned_local(const Kernel & kernel, cl_uint dims, const size_t * global, size_t * local) const
+{
+    return this->tuning_->lookup_raw(kernel, Device(this->tuning_device_), dims, global, local);
+}
+
+Queue::
+operator cl_command_queue() const
+{
+    return this->q_;
 }
 
 Queue
 Queue::get_default()
 {
+    if (default_policy_ == PER_THREAD) {
+        thread_local ThreadQueue thread_queue;
+        return Queue(thread_queue.q, true);
+    }
+
     std::call_once(Queue::have_default_, []() {
         auto ctx = Context::get_default();
         auto device = Device::get_default();
@@ -269,4 +998,182 @@ Queue::get_default()
     return default_queue_;
 }
 
+void
+Queue::set_default_policy(DefaultQueuePolicy policy)
+{
+    default_policy_ = policy;
+}
+
+DefaultQueuePolicy
+Queue::default_policy()
+{
+    return default_policy_;
+}
+
+// Handler
+
+void
+Handler::record_kernel(const Kernel & kernel,
+                       cl_uint dims,
+                       const size_t * offset,
+                       const size_t * global,
+                       const size_t * local,
+                       WaitList wait_list)
+{
+    this->graph_->add_kernel(kernel, dims, offset, global, local, wait_list);
+}
+
+void
+Handler::record_fill(const Memory & buffer,
+                     const void * pattern,
+                     size_t pattern_size,
+                     size_t offset,
+                     size_t size,
+                     WaitList wait_list)
+{
+    this->graph_->add_fill(buffer, pattern, pattern_size, offset, size, wait_list);
+}
+
+void
+Handler::record_copy(const Memory & src,
+                     const Memory & dest,
+                     size_t src_offset,
+                     size_t dest_offset,
+                     size_t size,
+                     WaitList wait_list)
+{
+    this->graph_->add_copy(src, dest, src_offset, dest_offset, size, wait_list);
+}
+
+void
+Handler::record_read(const Memory & buffer,
+                     size_t offset,
+                     size_t size,
+                     void * ptr,
+                     WaitList wait_list)
+{
+    this->graph_->add_read(buffer, offset, size, ptr, wait_list);
+}
+
+void
+Handler::record_write(const Memory & buffer,
+                      size_t offset,
+                      size_t size,
+                      const void * ptr,
+                      WaitList wait_list)
+{
+    this->graph_->add_write(buffer, offset, size, ptr, wait_list);
+}
+
+Event
+Handler::copy_rect(const Memory & src,
+                   const Memory & dest,
+                   const size_t * src_origin,
+                   const size_t * dest_origin,
+                   const size_t * region,
+                   size_t src_row_pitch,
+                   size_t src_slice_pitch,
+                   size_t dest_row_pitch,
+                   size_t dest_slice_pitch,
+                   WaitList wait_list)
+{
+    if (this->graph_ != nullptr) {
+        this->graph_->add_copy_rect(src,
+                                    dest,
+                                    src_origin,
+                                    dest_origin,
+                                    region,
+                                    src_row_pitch,
+                                    src_slice_pitch,
+                                    dest_row_pitch,
+                                    dest_slice_pitch,
+                                    wait_list);
+        return Event();
+    }
+    return add(this->q_.enqueue_copy_rect_raw(src,
+                                              dest,
+                                              src_origin,
+                                              dest_origin,
+                                              region,
+                                              src_row_pitch,
+                                              src_slice_pitch,
+                                              dest_row_pitch,
+                                              dest_slice_pitch,
+                                              wait_list));
+}
+
+Event
+Handler::read_rect(const Memory & buffer,
+                   const size_t * buffer_origin,
+                   const size_t * host_origin,
+                   const size_t * region,
+                   size_t buffer_row_pitch,
+                   size_t buffer_slice_pitch,
+                   size_t host_row_pitch,
+                   size_t host_slice_pitch,
+                   void * ptr,
+                   WaitList wait_list)
+{
+    if (this->graph_ != nullptr) {
+        this->graph_->add_read_rect(buffer,
+                                    buffer_origin,
+                                    host_origin,
+                                    region,
+                                    buffer_row_pitch,
+                                    buffer_slice_pitch,
+                                    host_row_pitch,
+                                    host_slice_pitch,
+                                    ptr,
+                                    wait_list);
+        return Event();
+    }
+    return add(this->q_.enqueue_iread_rect_raw(buffer,
+                                               buffer_origin,
+                                               host_origin,
+                                               region,
+                                               buffer_row_pitch,
+                                               buffer_slice_pitch,
+                                               host_row_pitch,
+                                               host_slice_pitch,
+                                               ptr,
+                                               wait_list));
+}
+
+Event
+Handler::write_rect(const Memory & buffer,
+                    const size_t * buffer_origin,
+                    const size_t * host_origin,
+                    const size_t * region,
+                    size_t buffer_row_pitch,
+                    size_t buffer_slice_pitch,
+                    size_t host_row_pitch,
+                    size_t host_slice_pitch,
+                    const void * ptr,
+                    WaitList wait_list)
+{
+    if (this->graph_ != nullptr) {
+        this->graph_->add_write_rect(buffer,
+                                     buffer_origin,
+                                     host_origin,
+                                     region,
+                                     buffer_row_pitch,
+                                     buffer_slice_pitch,
+                                     host_row_pitch,
+                                     host_slice_pitch,
+                                     ptr,
+                                     wait_list);
+        return Event();
+    }
+    return add(this->q_.enqueue_iwrite_rect_raw(buffer,
+                                                buffer_origin,
+                                                host_origin,
+                                                region,
+                                                buffer_row_pitch,
+                                                buffer_slice_pitch,
+                                                host_row_pitch,
+                                                host_slice_pitch,
+                                                ptr,
+                                                wait_list));
+}
+
 } // namespace openclcpp_lite
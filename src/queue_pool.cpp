@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "openclcpp-lite/queue_pool.h"
+#include <atomic>
+#include <vector>
+
+namespace openclcpp_lite {
+
+namespace {
+
+/// Source of pool ids
+std::atomic<std::uint64_t> next_pool_id = 0;
+
+/// Queue a thread got from a pool
+struct CachedQueue {
+    /// Id of the pool
+    std::uint64_t pool;
+    /// Queue of the thread, owned by the pool
+    const Queue * queue;
+};
+
+/// Queues of the calling thread. Pool ids are never reused, so entries of destroyed pools are never
+/// matched again.
+thread_local std::vector<CachedQueue> thread_queues;
+
+} // namespace
+
+QueuePool::QueuePool() : QueuePool(Context::get_default(), Device::get_default()) {}
+
+QueuePool::QueuePool(const Context & context, const Device & device) :
+    QueuePool(context, device, QueueProperties(Flags<QueueProperty>()))
+{
+}
+
+QueuePool::QueuePool(const Context & context, const Device & device, QueueProperties properties) :
+    context_(context),
+    device_(device),
+    properties_(properties),
+    id_(next_pool_id.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+Queue
+QueuePool::get()
+{
+    for (auto & c : thread_queues)
+        if (c.pool == this->id_)
+            return *c.queue;
+
+    const Queue * q;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        q = &this->queues_.emplace_back(this->context_, this->device_, this->properties_);
+    }
+    thread_queues.push_back({ this->id_, q });
+    return *q;
+}
+
+std::size_t
+QueuePool::size() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    return this->queues_.size();
+}
+
+void
+QueuePool::wait() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    for (auto & q : this->queues_)
+        q.wait();
+}
+
+} // namespace openclcpp_lite
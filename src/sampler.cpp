@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "openclcpp-lite/sampler.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/error.h"
+#include <utility>
+
+namespace openclcpp_lite {
+
+Sampler::Sampler() : sampler_(nullptr) {}
+
+Sampler::Sampler(cl_sampler sampler, bool retain) : sampler_(sampler)
+{
+    if (retain && this->sampler_ != nullptr)
+        OPENCL_CHECK(clRetainSampler(this->sampler_));
+}
+
+Sampler::Sampler(const Context & context,
+                 bool normalized_coords,
+                 AddressingMode addressing_mode,
+                 FilterMode filter_mode)
+{
+    cl_int err;
+    this->sampler_ = clCreateSampler(context,
+                                     normalized_coords ? CL_TRUE : CL_FALSE,
+                                     addressing_mode,
+                                     filter_mode,
+                                     &err);
+    OPENCL_CHECK(err);
+}
+
+Sampler::Sampler(const Sampler & other) : sampler_(other.sampler_)
+{
+    if (this->sampler_ != nullptr)
+        OPENCL_CHECK(clRetainSampler(this->sampler_));
+}
+
+Sampler::Sampler(Sampler && other) noexcept : sampler_(other.sampler_)
+{
+    other.sampler_ = nullptr;
+}
+
+Sampler::~Sampler()
+{
+    if (this->sampler_ != nullptr)
+        clReleaseSampler(this->sampler_);
+}
+
+Sampler &
+Sampler::operator=(const Sampler & other)
+{
+    if (other.sampler_ != nullptr)
+        OPENCL_CHECK(clRetainSampler(other.sampler_));
+    if (this->sampler_ != nullptr)
+        clReleaseSampler(this->sampler_);
+    this->sampler_ = other.sampler_;
+    return *this;
+}
+
+Sampler &
+Sampler::operator=(Sampler && other) noexcept
+{
+    std::swap(this->sampler_, other.sampler_);
+    return *this;
+}
+
+void
+Sampler::retain() const
+{
+    OPENCL_CHECK(clRetainSampler(this->sampler_));
+}
+
+void
+Sampler::release() const
+{
+    OPENCL_CHECK(clReleaseSampler(this->sampler_));
+}
+
+unsigned int
+Sampler::reference_count() const
+{
+    return get_info<cl_uint>(CL_SAMPLER_REFERENCE_COUNT);
+}
+
+Context
+Sampler::context() const
+{
+    auto ctx = get_info<cl_context>(CL_SAMPLER_CONTEXT);
+    return Context(ctx, true);
+}
+
+bool
+Sampler::normalized_coords() const
+{
+    return get_info<cl_bool>(CL_SAMPLER_NORMALIZED_COORDS) == CL_TRUE;
+}
+
+AddressingMode
+Sampler::addressing_mode() const
+{
+    return static_cast<AddressingMode>(get_info<cl_addressing_mode>(CL_SAMPLER_ADDRESSING_MODE));
+}
+
+FilterMode
+Sampler::filter_mode() const
+{
+    return static_cast<FilterMode>(get_info<cl_filter_mode>(CL_SAMPLER_FILTER_MODE));
+}
+
+Sampler::
+operator cl_sampler() const
+{
+    return this->sampler_;
+}
+
+} // namespace openclcpp_lite
@@ -0,0 +1,206 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "openclcpp-lite/staging_pool.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/memory.h"
+#include "openclcpp-lite/memory_accounting.h"
+#include "openclcpp-lite/error.h"
+#include <bit>
+#include <list>
+#include <mutex>
+
+namespace openclcpp_lite {
+
+/// Persistently mapped pinned buffer
+struct StagingBuffer::Block {
+    Memory mem;
+    /// Mapped host pointer
+    void * ptr;
+    std::size_t capacity;
+    /// Event of the last command using the block
+    Event busy;
+    /// `true` while the block is handed out
+    bool handed_out;
+};
+
+struct StagingPool::Data {
+    Data(const Queue & q, const std::source_location & location) :
+        queue(static_cast<cl_command_queue>(q), true),
+        loc(location)
+    {
+    }
+
+    ~Data()
+    {
+        for (auto & b : this->blocks)
+            unmap(b);
+    }
+
+    /// Check if a block can be handed out
+    static bool
+    available(const StagingBuffer::Block & b)
+    {
+        if (b.handed_out)
+            return false;
+        if (static_cast<cl_event>(b.busy) == nullptr)
+            return true;
+        auto status = b.busy.command_execution_status();
+        return status == COMPLETE || status == ERROR;
+    }
+
+    /// Unmap a block before it is released
+    ///
+    /// Does not block, the pool can be destroyed from an event callback.
+    void
+    unmap(StagingBuffer::Block & b)
+    {
+        WaitList busy(b.busy);
+        clEnqueueUnmapMemObject(this->queue, b.mem, b.ptr, busy.size(), busy.data(), nullptr);
+    }
+
+    /// Queue used for mapping, without any tracking attached
+    Queue queue;
+    /// Source location of the pool, recorded for its blocks
+    std::source_location loc;
+    std::mutex mutex;
+    /// Blocks, a list so they keep their address
+    std::list<StagingBuffer::Block> blocks;
+};
+
+// StagingBuffer
+
+StagingBuffer::StagingBuffer(std::shared_ptr<void> pool, Block * block, std::size_t size) :
+    pool_(std::move(pool)),
+    block_(block),
+    size_(size)
+{
+}
+
+StagingBuffer::StagingBuffer(StagingBuffer && other) noexcept :
+    pool_(std::move(other.pool_)),
+    block_(other.block_),
+    size_(other.size_)
+{
+    other.block_ = nullptr;
+}
+
+StagingBuffer::~StagingBuffer()
+{
+    if (this->block_ == nullptr)
+        return;
+    auto * pool = static_cast<StagingPool::Data *>(this->pool_.get());
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    this->block_->handed_out = false;
+}
+
+void *
+StagingBuffer::data() const
+{
+    return this->block_->ptr;
+}
+
+std::size_t
+StagingBuffer::size() const
+{
+    return this->size_;
+}
+
+std::span<std::byte>
+StagingBuffer::span() const
+{
+    return std::span<std::byte>(static_cast<std::byte *>(data()), this->size_);
+}
+
+void
+StagingBuffer::in_use_until(const Event & evt)
+{
+    auto * pool = static_cast<StagingPool::Data *>(this->pool_.get());
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    this->block_->busy = evt;
+}
+
+// StagingPool
+
+StagingPool::StagingPool(const Queue & queue, std::size_t threshold, std::source_location loc) :
+    data_(std::make_shared<Data>(queue, loc)),
+    threshold_(threshold)
+{
+}
+
+StagingBuffer
+StagingPool::acquire(std::size_t size)
+{
+    auto & d = *this->data_;
+    {
+        std::lock_guard<std::mutex> lock(d.mutex);
+        StagingBuffer::Block * best = nullptr;
+        for (auto & b : d.blocks)
+            if (b.capacity >= size && Data::available(b) &&
+                (best == nullptr || b.capacity < best->capacity))
+                best = &b;
+        if (best != nullptr) {
+            best->handed_out = true;
+            best->busy = Event();
+            return StagingBuffer(this->data_, best, size);
+        }
+    }
+
+    auto capacity = std::max(std::bit_ceil(size), MIN_BLOCK_SIZE);
+    auto ctx = d.queue.context();
+    cl_int err;
+    Memory mem(
+        clCreateBuffer(ctx, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, capacity, nullptr, &err));
+    OPENCL_CHECK(err);
+    MemoryAccounting::track(mem, ctx, capacity, d.loc);
+    auto * ptr = clEnqueueMapBuffer(d.queue,
+                                    mem,
+                                    CL_TRUE,
+                                    CL_MAP_READ | CL_MAP_WRITE,
+                                    0,
+                                    capacity,
+                                    0,
+                                    nullptr,
+                                    nullptr,
+                                    &err);
+    OPENCL_CHECK(err);
+
+    std::lock_guard<std::mutex> lock(d.mutex);
+    auto & b = d.blocks.emplace_back(std::move(mem), ptr, capacity, Event(), true);
+    return StagingBuffer(this->data_, &b, size);
+}
+
+std::size_t
+StagingPool::threshold() const
+{
+    return this->threshold_;
+}
+
+std::size_t
+StagingPool::capacity() const
+{
+    auto & d = *this->data_;
+    std::lock_guard<std::mutex> lock(d.mutex);
+    std::size_t n = 0;
+    for (auto & b : d.blocks)
+        n += b.capacity;
+    return n;
+}
+
+void
+StagingPool::trim()
+{
+    auto & d = *this->data_;
+    std::lock_guard<std::mutex> lock(d.mutex);
+    for (auto it = d.blocks.begin(); it != d.blocks.end();) {
+        if (Data::available(*it)) {
+            d.unmap(*it);
+            it = d.blocks.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+} // namespace openclcpp_lite
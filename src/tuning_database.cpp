@@ -0,0 +1,283 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "openclcpp-lite/tuning_database.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/exception.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/utils.h"
+#include "fmt/format.h"
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <tuple>
+
+namespace fs = std::filesystem;
+
+namespace openclcpp_lite {
+
+namespace {
+
+/// Magic bytes at the beginning of the database file. Bump the version when the layout changes.
+const char MAGIC[8] = { 'O', 'C', 'L', 'T', 'D', 'B', '0', '1' };
+
+void
+write_u64(std::ofstream & ofs, uint64_t val)
+{
+    ofs.write(reinterpret_cast<const char *>(&val), sizeof(val));
+}
+
+void
+write_str(std::ofstream & ofs, const std::string & str)
+{
+    write_u64(ofs, str.size());
+    ofs.write(str.data(), str.size());
+}
+
+bool
+read_u64(std::ifstream & ifs, uint64_t & val)
+{
+    ifs.read(reinterpret_cast<char *>(&val), sizeof(val));
+    return ifs.good();
+}
+
+bool
+read_str(std::ifstream & ifs, std::string & str)
+{
+    uint64_t len;
+    // guard against corrupted lengths
+    if (!read_u64(ifs, len) || len > 4096)
+        return false;
+    str.resize(len);
+    ifs.read(str.data(), len);
+    return ifs.good();
+}
+
+} // namespace
+
+bool
+TuningDatabase::Key::operator<(const Key & other) const
+{
+    return std::tie(this->function, this->device, this->dims, this->bucket) <
+           std::tie(other.function, other.device, other.dims, other.bucket);
+}
+
+TuningDatabase::TuningDatabase() {}
+
+TuningDatabase::TuningDatabase(const std::string & file_name) : file_name_(file_name)
+{
+    if (fs::exists(this->file_name_))
+        read(this->file_name_, this->entries_);
+}
+
+const std::string &
+TuningDatabase::file_name() const
+{
+    return this->file_name_;
+}
+
+std::size_t
+TuningDatabase::size() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    return this->entries_.size();
+}
+
+void
+TuningDatabase::clear()
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->entries_.clear();
+}
+
+void
+TuningDatabase::save() const
+{
+    if (this->file_name_.empty())
+        throw Exception("Tuning database has no file to be saved into");
+    write(this->file_name_);
+}
+
+void
+TuningDatabase::export_to(const std::string & file_name) const
+{
+    write(file_name);
+}
+
+void
+TuningDatabase::import_from(const std::string & file_name)
+{
+    std::map<Key, Entry> entries;
+    read(file_name, entries);
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    for (auto & [k, e] : entries)
+        this->entries_.insert_or_assign(k, e);
+}
+
+bool
+TuningDatabase::lookup_raw(const Kernel & kernel,
+                           const Device & device,
+                           cl_uint dims,
+                           const size_t * global,
+                           size_t * local)
+{
+    auto src = source_hash(kernel);
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    auto & dev = device_info(device);
+    auto it = this->entries_.find(key(kernel, dev, dims, global));
+    if (it == this->entries_.end())
+        return false;
+    auto & entry = it->second;
+    if (entry.source != src || entry.driver != dev.driver) {
+        this->entries_.erase(it);
+        return false;
+    }
+    // entries are shared by a whole size bucket, so the local size may not fit this global size
+    for (cl_uint i = 0; i < dims; i++)
+        if (entry.local[i] == 0 || global[i] % entry.local[i] != 0)
+            return false;
+    std::copy(entry.local.begin(), entry.local.begin() + dims, local);
+    return true;
+}
+
+void
+TuningDatabase::store_raw(const Kernel & kernel,
+                          const Device & device,
+                          cl_uint dims,
+                          const size_t * global,
+                          const size_t * local)
+{
+    auto src = source_hash(kernel);
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    auto & dev = device_info(device);
+    Entry entry { { 1, 1, 1 }, src, dev.driver };
+    std::copy(local, local + dims, entry.local.begin());
+    this->entries_.insert_or_assign(key(kernel, dev, dims, global), entry);
+}
+
+TuningDatabase::Key
+TuningDatabase::key(const Kernel & kernel,
+                    const DeviceInfo & dev,
+                    cl_uint dims,
+                    const size_t * global) const
+{
+    Key k { kernel.function_name(), dev.hash, dims, { 0, 0, 0 } };
+    for (cl_uint i = 0; i < dims; i++)
+        k.bucket[i] = global[i] == 0 ? 0 : std::bit_width(global[i]) - 1;
+    return k;
+}
+
+uint64_t
+TuningDatabase::source_hash(const Kernel & kernel)
+{
+    auto prg = kernel.program();
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        auto it = this->sources_.find(prg);
+        if (it != this->sources_.end())
+            return it->second.hash;
+    }
+    // programs created from binaries (e.g. by `ProgramCache`) have no source
+    auto src = prg.source();
+    uint64_t hash;
+    if (!src.empty())
+        hash = utils::hash(src);
+    else {
+        hash = utils::hash("binary");
+        for (auto & bin : prg.binaries())
+            hash = utils::hash_bytes(bin.data(), bin.size(), hash);
+    }
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->sources_.emplace(prg, SourceInfo { prg, hash });
+    return hash;
+}
+
+const TuningDatabase::DeviceInfo &
+TuningDatabase::device_info(const Device & device)
+{
+    auto it = this->devices_.find(device);
+    if (it == this->devices_.end()) {
+        auto id = fmt::format("{}\n{}\n{}", device.name(), device.vendor(), device.version());
+        DeviceInfo info { utils::hash(id), device.driver_version() };
+        it = this->devices_.emplace(device, info).first;
+    }
+    return it->second;
+}
+
+void
+TuningDatabase::read(const std::string & file_name, std::map<Key, Entry> & entries) const
+{
+    std::ifstream ifs(file_name, std::ifstream::in | std::ifstream::binary);
+    if (!ifs.is_open())
+        throw Exception(fmt::format("Unable to open tuning database '{}'", file_name));
+
+    char magic[sizeof(MAGIC)];
+    ifs.read(magic, sizeof(magic));
+    uint64_t n;
+    if (!ifs.good() || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !read_u64(ifs, n))
+        throw Exception(fmt::format("'{}' is not a tuning database", file_name));
+
+    for (uint64_t i = 0; i < n; i++) {
+        Key k;
+        Entry e;
+        uint64_t dims, bucket[3], local[3];
+        bool ok = read_str(ifs, k.function) && read_u64(ifs, k.device) && read_u64(ifs, dims);
+        for (int j = 0; j < 3; j++)
+            ok = ok && read_u64(ifs, bucket[j]) && read_u64(ifs, local[j]);
+        ok = ok && read_u64(ifs, e.source) && read_str(ifs, e.driver);
+        if (!ok || dims == 0 || dims > 3)
+            throw Exception(fmt::format("Tuning database '{}' is corrupted", file_name));
+        k.dims = dims;
+        for (int j = 0; j < 3; j++) {
+            k.bucket[j] = bucket[j];
+            e.local[j] = local[j];
+        }
+        entries.insert_or_assign(k, e);
+    }
+}
+
+void
+TuningDatabase::write(const std::string & file_name) const
+{
+    // Write into a uniquely named temporary file and rename it over the database, so that readers
+    // never see a partially written file
+    std::random_device rd;
+    auto tmp_name = fmt::format("{}.{:08x}.tmp", file_name, rd());
+    {
+        std::ofstream ofs(tmp_name, std::ofstream::out | std::ofstream::binary);
+        if (!ofs.is_open())
+            throw Exception(fmt::format("Unable to write tuning database '{}'", file_name));
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        ofs.write(MAGIC, sizeof(MAGIC));
+        write_u64(ofs, this->entries_.size());
+        for (auto & [k, e] : this->entries_) {
+            write_str(ofs, k.function);
+            write_u64(ofs, k.device);
+            write_u64(ofs, k.dims);
+            for (int j = 0; j < 3; j++) {
+                write_u64(ofs, k.bucket[j]);
+                write_u64(ofs, e.local[j]);
+            }
+            write_u64(ofs, e.source);
+            write_str(ofs, e.driver);
+        }
+        ofs.close();
+        if (!ofs.good()) {
+            std::error_code ec;
+            fs::remove(tmp_name, ec);
+            throw Exception(fmt::format("Unable to write tuning database '{}'", file_name));
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp_name, file_name, ec);
+    if (ec) {
+        fs::remove(tmp_name, ec);
+        throw Exception(fmt::format("Unable to write tuning database '{}'", file_name));
+    }
+}
+
+} // namespace openclcpp_lite
@@ -134,5 +134,30 @@ write_file_bin(const std::string & file_name, const std::vector<char> & bin)
     }
 }
 
+uint64_t
+hash_bytes(const void * data, size_t size, uint64_t seed)
+{
+    const uint64_t prime = 1099511628211ULL;
+    auto bytes = static_cast<const unsigned char *>(data);
+    uint64_t h = seed;
+    for (size_t i = 0; i < size; i++) {
+        h ^= bytes[i];
+        h *= prime;
+    }
+    return h;
+}
+
+uint64_t
+hash(const std::string & str, uint64_t seed)
+{
+    return hash_bytes(str.data(), str.size(), seed);
+}
+
+std::string
+to_hex(uint64_t value)
+{
+    return fmt::format("{:016x}", value);
+}
+
 } // namespace utils
 } // namespace openclcpp_lite
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "openclcpp-lite/work_distributor.h"
+#include <algorithm>
+#include <numeric>
+
+namespace openclcpp_lite {
+
+WorkDistributor::WorkDistributor(const Context & context) :
+    context_(context),
+    alignment_(context.alignment())
+{
+    for (auto & dev : context.devices()) {
+        this->queues_.emplace_back(context, dev);
+        this->weights_.push_back(std::max<std::size_t>(dev.max_compute_units(), 1));
+    }
+}
+
+const Context &
+WorkDistributor::context() const
+{
+    return this->context_;
+}
+
+std::size_t
+WorkDistributor::num_of_devices() const
+{
+    return this->queues_.size();
+}
+
+Queue
+WorkDistributor::queue(std::size_t device) const
+{
+    return this->queues_.at(device);
+}
+
+std::vector<WorkDistributor::Part>
+WorkDistributor::partition(std::size_t n, std::size_t granularity) const
+{
+    auto total = std::accumulate(this->weights_.begin(), this->weights_.end(), std::size_t(0));
+    std::vector<Part> parts;
+    std::size_t begin = 0;
+    std::size_t weight = 0;
+    for (std::size_t i = 0; i < this->weights_.size(); i++) {
+        weight += this->weights_[i];
+        std::size_t end = n;
+        if (i + 1 < this->weights_.size())
+            end = std::max(begin, n * weight / total / granularity * granularity);
+        if (end > begin)
+            parts.push_back({ i, begin, end - begin });
+        begin = end;
+    }
+    return parts;
+}
+
+std::size_t
+WorkDistributor::granularity(std::size_t elem_size) const
+{
+    return this->alignment_ / std::gcd(this->alignment_, elem_size);
+}
+
+void
+WorkDistributor::flush() const
+{
+    for (auto & q : this->queues_)
+        q.flush();
+}
+
+void
+WorkDistributor::wait() const
+{
+    for (auto & q : this->queues_)
+        q.wait();
+}
+
+} // namespace openclcpp_lite
@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2024 David Andrs <andrsd@gmail.com>
+// SPDX-License-Identifier: MIT
+
+#include "openclcpp-lite/work_group_tuner.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/event.h"
+#include "openclcpp-lite/tuning_database.h"
+#include <algorithm>
+#include <limits>
+
+namespace openclcpp_lite {
+
+WorkGroupTuner::WorkGroupTuner() : WorkGroupTuner(Context::get_default(), Device::get_default()) {}
+
+WorkGroupTuner::WorkGroupTuner(const Context & context, const Device & device) :
+    device_(device),
+    queue_(context, device, PROFILING_ENABLE),
+    reps_(3)
+{
+}
+
+unsigned int
+WorkGroupTuner::repetitions() const
+{
+    return this->reps_;
+}
+
+void
+WorkGroupTuner::set_repetitions(unsigned int n)
+{
+    this->reps_ = std::max(n, 1u);
+}
+
+void
+WorkGroupTuner::set_database(std::shared_ptr<TuningDatabase> db)
+{
+    this->db_ = db;
+}
+
+std::shared_ptr<TuningDatabase>
+WorkGroupTuner::database() const
+{
+    return this->db_;
+}
+
+std::size_t
+WorkGroupTuner::size() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    return this->cache_.size();
+}
+
+void
+WorkGroupTuner::clear()
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->cache_.clear();
+}
+
+std::array<size_t, 3>
+WorkGroupTuner::tune_raw(const Kernel & kernel, cl_uint dims, const size_t * global)
+{
+    Key key { kernel, dims, { 1, 1, 1 } };
+    std::copy(global, global + dims, std::get<2>(key).begin());
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        auto it = this->cache_.find(key);
+        if (it != this->cache_.end())
+            return it->second;
+    }
+
+    std::array<size_t, 3> best = { 1, 1, 1 };
+    if (this->db_ != nullptr &&
+        this->db_->lookup_raw(kernel, this->device_, dims, global, best.data())) {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->cache_[key] = best;
+        return best;
+    }
+
+    uint64_t best_time = std::numeric_limits<uint64_t>::max();
+    for (auto & local : candidates(kernel, dims, global)) {
+        auto t = time(kernel, dims, global, local.data());
+        if (t > 0 && t < best_time) {
+            best_time = t;
+            best = local;
+        }
+    }
+
+    if (this->db_ != nullptr)
+        this->db_->store_raw(kernel, this->device_, dims, global, best.data());
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->cache_[key] = best;
+    return best;
+}
+
+std::vector<std::array<size_t, 3>>
+WorkGroupTuner::candidates(const Kernel & kernel, cl_uint dims, const size_t * global) const
+{
+    auto max_item_sizes = this->device_.max_work_item_sizes();
+    auto max_wg_size = std::min(this->device_.max_work_group_size(),
+                                kernel.work_group_size(this->device_));
+
+    // powers of two that divide the global size in each dimension
+    std::array<std::vector<size_t>, 3> sizes;
+    for (cl_uint d = 0; d < 3; d++) {
+        if (d >= dims) {
+            sizes[d] = { 1 };
+            continue;
+        }
+        auto limit = std::min({ global[d], max_item_sizes[d], max_wg_size });
+        for (size_t s = 1; s <= limit; s *= 2)
+            if (global[d] % s == 0)
+                sizes[d].push_back(s);
+    }
+
+    std::vector<std::array<size_t, 3>> cands;
+    for (auto x : sizes[0])
+        for (auto y : sizes[1])
+            for (auto z : sizes[2])
+                if (x * y * z <= max_wg_size)
+                    cands.push_back({ x, y, z });
+    return cands;
+}
+
+uint64_t
+WorkGroupTuner::time(const Kernel & kernel,
+                     cl_uint dims,
+                     const size_t * global,
+                     const size_t * local) const
+{
+    cl_command_queue q = this->queue_;
+    uint64_t best = 0;
+    // the first launch is a warm-up
+    for (unsigned int i = 0; i <= this->reps_; i++) {
+        cl_event evt;
+        auto err =
+            clEnqueueNDRangeKernel(q, kernel, dims, nullptr, global, local, 0, nullptr, &evt);
+        if (err != CL_SUCCESS)
+            return 0;
+        Event e(evt);
+        e.wait();
+        auto info = e.profiling_info();
+        auto t = std::max<uint64_t>(info.end - info.start, 1);
+        if (i > 0 && (best == 0 || t < best))
+            best = t;
+    }
+    return best;
+}
+
+} // namespace openclcpp_lite
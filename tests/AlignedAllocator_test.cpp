@@ -0,0 +1,28 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/aligned_allocator.h"
+#include "openclcpp-lite/context.h"
+#include <cstdint>
+
+namespace ocl = openclcpp_lite;
+
+TEST(AlignedAllocatorTest, alignment)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::AlignedAllocator<float> alloc;
+    EXPECT_EQ(alloc.alignment(), std::max(ctx.alignment(), alignof(float)));
+    EXPECT_EQ(ocl::AlignedAllocator<float>(ctx), alloc);
+
+    ocl::AlignedAllocator<double> rebound(alloc);
+    EXPECT_EQ(rebound.alignment(), std::max(alloc.alignment(), alignof(double)));
+}
+
+TEST(AlignedAllocatorTest, vector)
+{
+    ocl::AlignedVector<int> v(1000, 1);
+    auto align = v.get_allocator().alignment();
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(v.data()) % align, 0);
+    v.resize(5000, 2);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(v.data()) % align, 0);
+    EXPECT_EQ(v[999], 1);
+    EXPECT_EQ(v[1000], 2);
+}
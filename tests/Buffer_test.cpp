@@ -3,6 +3,8 @@
 #include "openclcpp-lite/buffer.h"
 #include "openclcpp-lite/queue.h"
 #include "openclcpp-lite/platform.h"
+#include "openclcpp-lite/aligned_allocator.h"
+#include <vector>
 
 namespace ocl = openclcpp_lite;
 
@@ -26,3 +28,104 @@ TEST(BufferTest, test)
     EXPECT_EQ(b_f.map_count(), 0);
     EXPECT_EQ(b_f.offset(), 0);
 }
+
+TEST(BufferTest, init_from_host)
+{
+    const int N = 10;
+    ocl::Range<1> rng { N };
+    std::vector<float> h_a(N);
+    for (int i = 0; i < N; i++)
+        h_a[i] = i;
+
+    auto ctx = ocl::Context::get_default();
+    ocl::Buffer<float> d_a { ctx, h_a.data(), rng };
+    EXPECT_EQ(d_a.context(), ctx);
+
+    auto q = ocl::Queue::get_default();
+    std::vector<float> res(N);
+    q.copy(d_a, res.data(), rng).wait();
+    EXPECT_THAT(res, testing::ElementsAreArray(h_a));
+}
+
+TEST(BufferTest, upload)
+{
+    const int N = 10;
+    ocl::Range<1> rng { N };
+    std::vector<float> h_a(N);
+    for (int i = 0; i < N; i++)
+        h_a[i] = 2 * i;
+
+    auto q = ocl::Queue::get_default();
+    for (auto flags : { ocl::MemoryFlags(ocl::READ_WRITE),
+                        ocl::MemoryFlags(ocl::READ_WRITE | ocl::ALLOC_HOST_PTR) }) {
+        auto [d_a, upload] = ocl::Buffer<float>::from_host(q, h_a.data(), rng, flags);
+        EXPECT_EQ(d_a.context(), q.context());
+
+        std::vector<float> res(N);
+        q.copy(d_a, res.data(), rng, upload).wait();
+        EXPECT_THAT(res, testing::ElementsAreArray(h_a));
+    }
+}
+
+TEST(BufferTest, host_memory)
+{
+    const int N = 100;
+    ocl::Range<1> rng { N };
+    auto h_a = std::make_shared<ocl::AlignedVector<int>>(N, 3);
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+
+    ocl::Buffer<int> d_a { ctx, std::span<int>(*h_a), h_a };
+    EXPECT_EQ(d_a.byte_size(), N * sizeof(int));
+    if (ctx.host_unified_memory())
+        EXPECT_EQ(d_a.host_ptr(), h_a->data());
+    else
+        EXPECT_EQ(d_a.host_ptr(), nullptr);
+    EXPECT_EQ(d_a.host_storage(), d_a.host_ptr());
+
+    q.fill(d_a, 5, rng);
+    q.copy(d_a, h_a->data(), rng).wait();
+    EXPECT_THAT(*h_a, testing::Each(5));
+
+    (*h_a)[0] = 7;
+    q.copy(h_a->data(), d_a, rng).wait();
+    std::vector<int> res(N);
+    q.copy(d_a, res.data(), rng).wait();
+    EXPECT_EQ(res[0], 7);
+    EXPECT_EQ(res[1], 5);
+}
+
+TEST(BufferTest, host_memory_2d)
+{
+    const int N = 5;
+    const int M = 4;
+    ocl::Range<2> rng { N, M };
+    ocl::AlignedVector<int> h_a(N * M);
+    for (int i = 0; i < N * M; i++)
+        h_a[i] = i;
+    auto q = ocl::Queue::get_default();
+
+    ocl::Buffer<int, 2> d_a { std::span<int>(h_a) };
+    EXPECT_EQ(d_a.byte_size(), N * M * sizeof(int));
+    EXPECT_FALSE(d_a.padded());
+
+    ocl::Buffer<int, 2> d_b { rng };
+    q.copy(d_a, d_b, rng);
+    std::vector<int> res(N * M);
+    q.copy(d_b, res.data(), rng).wait();
+    EXPECT_THAT(res, testing::ElementsAreArray(h_a));
+}
+
+TEST(BufferTest, use_host_ptr)
+{
+    const int N = 100;
+    ocl::Range<1> rng { N };
+    ocl::AlignedVector<int> h_a(N, 3);
+    ocl::Buffer<int> d_a { std::span<int>(h_a), nullptr, ocl::READ_WRITE | ocl::USE_HOST_PTR };
+    EXPECT_EQ(d_a.host_ptr(), h_a.data());
+
+    auto q = ocl::Queue::get_default();
+    q.fill(d_a, 4, rng);
+    q.copy(d_a, h_a.data(), rng).wait();
+    EXPECT_THAT(h_a, testing::Each(4));
+}
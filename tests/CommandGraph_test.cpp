@@ -0,0 +1,166 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/kernel_functor.h"
+#include "openclcpp-lite/command_graph.h"
+#include "openclcpp-lite/range.h"
+#include "openclcpp-lite/buffer.h"
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+// clang-format off
+std::string src = R"(
+__kernel void
+axpy(const float a, __global const float *X, __global float *Y)
+{
+    int i = get_global_id(0);
+    Y[i] += a * X[i];
+}
+)";
+// clang-format on
+
+} // namespace
+
+TEST(CommandGraphTest, replay)
+{
+    const int N = 8;
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+    using FloatBuffer = ocl::Buffer<float>;
+    auto axpy = ocl::Kernel::create<float, FloatBuffer, FloatBuffer>(prg, "axpy");
+
+    ocl::Range<1> rng { N };
+    std::vector<float> h_x(N, 1.f);
+    std::vector<float> h_y(N);
+    FloatBuffer d_x { h_x.data(), rng };
+    FloatBuffer d_y { rng };
+
+    auto graph = q.record([&](ocl::Handler & h) {
+        h.fill(d_y, 0.f, rng);
+        h.kernel(axpy(2.f, d_x, d_y), rng);
+        h.copy(d_y, h_y.data(), rng);
+    });
+    EXPECT_EQ(graph.size(), 3);
+    EXPECT_FALSE(graph.native());
+
+    graph.replay().wait();
+    for (auto & v : h_y)
+        EXPECT_FLOAT_EQ(v, 2.f);
+
+    graph.set_arg(1, 0, 3.f);
+    graph.replay().wait();
+    for (auto & v : h_y)
+        EXPECT_FLOAT_EQ(v, 3.f);
+
+    EXPECT_THROW(graph.set_arg(0, 0, 1.f), ocl::Exception);
+}
+
+TEST(CommandGraphTest, shared_kernel)
+{
+    const int N = 8;
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+    using FloatBuffer = ocl::Buffer<float>;
+    auto axpy = ocl::Kernel::create<float, FloatBuffer, FloatBuffer>(prg, "axpy");
+
+    ocl::Range<1> rng { N };
+    std::vector<float> h_x(N, 1.f);
+    std::vector<float> h_y(N);
+    FloatBuffer d_x { h_x.data(), rng };
+    FloatBuffer d_y { rng };
+    FloatBuffer d_z { rng };
+
+    auto graph = q.record([&](ocl::Handler & h) {
+        h.fill(d_y, 0.f, rng);
+        h.fill(d_z, 0.f, rng);
+        h.kernel(axpy(2.f, d_x, d_y), rng);
+        h.kernel(axpy(5.f, d_y, d_z), rng);
+    });
+    EXPECT_EQ(graph.size(), 4);
+
+    // argument set outside of the graph must not leak into the replay
+    axpy(100.f, d_x, d_x);
+    for (int i = 0; i < 2; i++) {
+        graph.replay().wait();
+        q.copy(d_z, h_y.data(), rng).wait();
+        for (auto & v : h_y)
+            EXPECT_FLOAT_EQ(v, 10.f);
+    }
+}
+
+TEST(CommandGraphTest, rebound_kernel)
+{
+    const int N = 8;
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+    using FloatBuffer = ocl::Buffer<float>;
+    auto axpy = ocl::Kernel::create<float, FloatBuffer, FloatBuffer>(prg, "axpy");
+
+    ocl::Range<1> rng { N };
+    std::vector<float> h_x(N, 1.f);
+    std::vector<float> h_y(N);
+    FloatBuffer d_x { h_x.data(), rng };
+    FloatBuffer d_y { rng };
+
+    auto graph = q.record([&](ocl::Handler & h) {
+        h.fill(d_y, 0.f, rng);
+        h.kernel(axpy(2.f, d_x, d_y), rng);
+    });
+
+    for (int i = 0; i < 2; i++) {
+        // kernel recorded once, re-bound outside of the graph between replays
+        q.submit([&](ocl::Handler & h) { h.kernel(axpy(100.f, d_y, d_x), rng); }).wait();
+        q.fill(d_x, 1.f, rng).wait();
+        graph.replay().wait();
+        q.copy(d_y, h_y.data(), rng).wait();
+        for (auto & v : h_y)
+            EXPECT_FLOAT_EQ(v, 2.f);
+    }
+}
+
+TEST(CommandGraphTest, keeps_buffers_alive)
+{
+    const int N = 8;
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+    using FloatBuffer = ocl::Buffer<float>;
+    auto axpy = ocl::Kernel::create<float, FloatBuffer, FloatBuffer>(prg, "axpy");
+
+    ocl::Range<1> rng { N };
+    std::vector<float> h_x(N, 1.f);
+    std::vector<float> h_y(N);
+    // the buffers are only referenced by the graph once recorded
+    auto graph = [&] {
+        FloatBuffer d_x { h_x.data(), rng };
+        FloatBuffer d_y { rng };
+        return q.record([&](ocl::Handler & h) {
+            h.fill(d_y, 0.f, rng);
+            h.kernel(axpy(2.f, d_x, d_y), rng);
+            h.copy(d_y, h_y.data(), rng);
+        });
+    }();
+
+    graph.replay().wait();
+    for (auto & v : h_y)
+        EXPECT_FLOAT_EQ(v, 2.f);
+
+    {
+        std::vector<float> h_z(N, 2.f);
+        FloatBuffer d_z { h_z.data(), rng };
+        graph.set_arg(1, 1, d_z);
+    }
+    graph.replay().wait();
+    for (auto & v : h_y)
+        EXPECT_FLOAT_EQ(v, 4.f);
+}
@@ -1,5 +1,7 @@
 #include "gmock/gmock.h"
 #include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include <algorithm>
 
 namespace ocl = openclcpp_lite;
 
@@ -9,6 +11,24 @@ TEST(ContextTest, num_devices)
     auto devices = ctx.devices();
     auto n_devs = ctx.num_of_devices();
     EXPECT_GE(n_devs, 1);
+    EXPECT_EQ(devices.size(), n_devs);
+}
+
+TEST(ContextTest, memory)
+{
+    auto ctx = ocl::Context::get_default();
+    bool unified = true;
+    std::size_t align = 1;
+    for (auto & d : ctx.devices()) {
+        cl_bool dev_unified;
+        clGetDeviceInfo(d, CL_DEVICE_HOST_UNIFIED_MEMORY, sizeof(cl_bool), &dev_unified, nullptr);
+        unified = unified && dev_unified == CL_TRUE;
+        cl_uint base_align;
+        clGetDeviceInfo(d, CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(cl_uint), &base_align, nullptr);
+        align = std::max<std::size_t>(align, base_align / 8);
+    }
+    EXPECT_EQ(ctx.host_unified_memory(), unified);
+    EXPECT_EQ(ctx.alignment(), align);
 }
 
 TEST(ContextTest, ref_cnt)
@@ -4,9 +4,70 @@
 #include "openclcpp-lite/event.h"
 #include "openclcpp-lite/range.h"
 #include "openclcpp-lite/buffer.h"
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <thread>
 
 namespace ocl = openclcpp_lite;
 
+namespace {
+
+/// Minimal eagerly started coroutine used to test `co_await` on events
+struct Task {
+    struct promise_type {
+        Task
+        get_return_object()
+        {
+            return Task { std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+
+        std::suspend_never
+        initial_suspend()
+        {
+            return {};
+        }
+
+        std::suspend_always
+        final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void
+        return_void()
+        {
+            this->done = true;
+        }
+
+        void
+        unhandled_exception()
+        {
+            this->error = std::current_exception();
+            this->done = true;
+        }
+
+        std::atomic<bool> done = false;
+        std::exception_ptr error;
+    };
+
+    ~Task()
+    {
+        if (this->handle)
+            this->handle.destroy();
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+Task
+upload(ocl::Queue & q, const int * src, ocl::Buffer<int> & dest, ocl::Range<1> rng)
+{
+    co_await q.copy(src, dest, rng);
+}
+
+} // namespace
+
 TEST(EventTest, wait_for_event)
 {
     const int N = 5;
@@ -65,3 +126,95 @@ TEST(EventTest, profiling_info)
     EXPECT_GT(info.start, 0);
     EXPECT_GT(info.end, 0);
 }
+
+TEST(EventTest, then)
+{
+    const int N = 5;
+    std::vector<int> h_a(N, 1);
+    ocl::Range<1> rng { N };
+    ocl::Buffer<int> d_a { rng };
+    auto q = ocl::Queue::get_default();
+    std::atomic<bool> called = false;
+    auto evt = q.copy(h_a.data(), d_a, rng);
+    evt.then([&] { called = true; });
+    q.wait();
+    while (!called)
+        std::this_thread::yield();
+    EXPECT_TRUE(called);
+}
+
+TEST(EventTest, get_future)
+{
+    const int N = 5;
+    std::vector<int> h_a(N, 1);
+    ocl::Range<1> rng { N };
+    ocl::Buffer<int> d_a { rng };
+    auto q = ocl::Queue::get_default();
+    auto fut = q.copy(h_a.data(), d_a, rng).get_future();
+    q.flush();
+    EXPECT_NO_THROW(fut.get());
+}
+
+TEST(EventTest, co_await)
+{
+    const int N = 5;
+    std::vector<int> h_a(N, 7);
+    ocl::Range<1> rng { N };
+    ocl::Buffer<int> d_a { rng };
+    auto q = ocl::Queue::get_default();
+    auto task = upload(q, h_a.data(), d_a, rng);
+    q.wait();
+    while (!task.handle.promise().done)
+        std::this_thread::yield();
+    EXPECT_EQ(task.handle.promise().error, nullptr);
+
+    std::vector<int> h_b(N);
+    q.copy(d_a, h_b.data(), rng).wait();
+    EXPECT_THAT(h_b, testing::Each(7));
+}
+
+TEST(EventTest, wait_list)
+{
+    ocl::WaitList empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.data(), nullptr);
+
+    ocl::Event null_evt;
+    ocl::WaitList from_null(null_evt);
+    EXPECT_TRUE(from_null.empty());
+
+    const int N = 5;
+    std::vector<int> h_a(N, 1);
+    ocl::Range<1> rng { N };
+    ocl::Buffer<int> d_a { rng };
+    auto q = ocl::Queue::get_default();
+    std::vector<ocl::Event> events;
+    for (int i = 0; i < 6; i++)
+        events.push_back(q.fill(d_a, i, rng));
+    ocl::WaitList from_vec(events);
+    EXPECT_EQ(from_vec.size(), 6);
+    EXPECT_EQ(from_vec.data(), (const cl_event *) events.data());
+
+    ocl::WaitListStorage storage;
+    storage.push_back(null_evt);
+    EXPECT_EQ(storage.size(), 0);
+    storage.append(events);
+    EXPECT_EQ(storage.size(), 6);
+    ocl::WaitList merged = storage;
+    for (std::size_t i = 0; i < merged.size(); i++)
+        EXPECT_EQ(merged.data()[i], (cl_event) events[i]);
+    ocl::Event::wait(merged);
+
+    // null events in a list are dropped before the list reaches OpenCL
+    EXPECT_FALSE(from_vec.sparse());
+    std::vector<ocl::Event> with_null { events[0], null_evt, events[1] };
+    ocl::WaitList sparse(with_null);
+    EXPECT_TRUE(sparse.sparse());
+    ocl::WaitListStorage dense_storage;
+    auto dense = sparse.dense(dense_storage);
+    EXPECT_EQ(dense.size(), 2);
+    EXPECT_EQ(dense.data()[1], (cl_event) events[1]);
+    q.fill(d_a, 7, rng, { null_evt, events[5] }).wait();
+    q.fill(d_a, 8, rng, with_null).wait();
+    ocl::Event::wait({ null_evt });
+}
@@ -0,0 +1,172 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/exception.h"
+#include "openclcpp-lite/image.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/kernel_functor.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/range.h"
+#include "openclcpp-lite/sampler.h"
+#include "openclcpp-lite/buffer.h"
+#include <numeric>
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+// clang-format off
+std::string src = R"(
+__kernel void
+interpolate(__read_only image2d_t img,
+            sampler_t smp,
+            __global float *out)
+{
+    int i = get_global_id(0);
+    out[i] = read_imagef(img, smp, (float2)(i + 1.0f, 0.5f)).x;
+}
+)";
+// clang-format on
+
+bool
+have_images()
+{
+    for (auto & dev : ocl::Context::get_default().devices())
+        if (!dev.image_support())
+            return false;
+    return true;
+}
+
+} // namespace
+
+TEST(ImageTest, format)
+{
+    ocl::ImageFormat rgba8 = { ocl::RGBA, ocl::UNORM_INT8 };
+    EXPECT_EQ(rgba8.num_of_channels(), 4);
+    EXPECT_EQ(rgba8.pixel_size(), 4);
+    ocl::ImageFormat rg16 = { ocl::RG, ocl::HALF_FLOAT };
+    EXPECT_EQ(rg16.pixel_size(), 4);
+    EXPECT_EQ(ocl::PixelFormat<cl_float4>::value.pixel_size(), sizeof(cl_float4));
+    EXPECT_EQ(ocl::PixelFormat<cl_uint>::value.pixel_size(), sizeof(cl_uint));
+
+    cl_image_format fmt = rgba8;
+    EXPECT_EQ(fmt.image_channel_order, CL_RGBA);
+    EXPECT_EQ(fmt.image_channel_data_type, CL_UNORM_INT8);
+}
+
+TEST(ImageTest, image2d)
+{
+    if (!have_images())
+        GTEST_SKIP();
+
+    const int W = 16, H = 8;
+    ocl::Image2D<cl_float4> img(ocl::Range<2> { W, H });
+    EXPECT_EQ(img.width(), W);
+    EXPECT_EQ(img.height(), H);
+    EXPECT_EQ(img.depth(), 0);
+    EXPECT_EQ(img.element_size(), sizeof(cl_float4));
+    EXPECT_EQ(img.format(), ocl::PixelFormat<cl_float4>::value);
+    EXPECT_THAT(img.region(), testing::ElementsAre(W, H, 1));
+
+    std::vector<cl_float4> h_a(W * H);
+    for (int i = 0; i < W * H; i++)
+        h_a[i] = { { (float) i, 0.f, 0.f, 1.f } };
+    auto q = ocl::Queue::get_default();
+    q.copy(h_a.data(), img);
+
+    ocl::Image2D<cl_float4> other(ocl::Range<2> { W, H });
+    q.copy(img, other);
+    std::vector<cl_float4> h_b(W * H);
+    q.copy(other, h_b.data()).wait();
+    for (int i = 0; i < W * H; i++)
+        EXPECT_EQ(h_b[i].s[0], i);
+
+    std::vector<cl_float4> h_row(W);
+    q.copy(img, h_row.data(), ocl::Range<3> { 0, 2, 0 }, ocl::Range<3> { W, 1, 1 }).wait();
+    EXPECT_EQ(h_row[0].s[0], 2 * W);
+    EXPECT_EQ(h_row[W - 1].s[0], 3 * W - 1);
+}
+
+TEST(ImageTest, fill)
+{
+    if (!have_images())
+        GTEST_SKIP();
+
+    const int W = 4, H = 4, D = 3;
+    ocl::Image3D<cl_uint4> img(ocl::Range<3> { W, H, D });
+    EXPECT_EQ(img.depth(), D);
+    EXPECT_EQ(img.range().size(), W * H * D);
+
+    auto q = ocl::Queue::get_default();
+    q.fill(img, cl_uint4 { { 1, 2, 3, 4 } });
+    q.fill(img, cl_uint4 { { 5, 6, 7, 8 } }, ocl::Range<3> { 0, 0, 2 }, ocl::Range<3> { W, H, 1 });
+
+    std::vector<cl_uint4> h_a(W * H * D);
+    q.copy(img, h_a.data()).wait();
+    EXPECT_EQ(h_a[0].s[0], 1);
+    EXPECT_EQ(h_a[0].s[3], 4);
+    EXPECT_EQ(h_a[2 * W * H].s[0], 5);
+    EXPECT_EQ(h_a[W * H * D - 1].s[3], 8);
+}
+
+TEST(ImageTest, image2d_array)
+{
+    if (!have_images())
+        GTEST_SKIP();
+
+    const int W = 8, H = 8, N = 3;
+    ocl::Image2DArray<cl_int4> img(ocl::Range<2> { W, H }, N);
+    EXPECT_EQ(img.array_size(), N);
+    EXPECT_THAT(img.region(), testing::ElementsAre(W, H, N));
+
+    auto q = ocl::Queue::get_default();
+    q.fill(img, cl_int4 { { -1, 0, 0, 0 } });
+    std::vector<cl_int4> h_a(W * H);
+    q.copy(img, h_a.data(), ocl::Range<3> { 0, 0, 1 }, ocl::Range<3> { W, H, 1 }).wait();
+    for (auto & px : h_a)
+        EXPECT_EQ(px.s[0], -1);
+}
+
+TEST(ImageTest, limits)
+{
+    if (!have_images())
+        GTEST_SKIP();
+
+    auto dev = ocl::Context::get_default().devices()[0];
+    ocl::Range<2> too_wide { dev.image2d_max_width() + 1, 1 };
+    EXPECT_THROW(ocl::Image2D<cl_float4> img(too_wide), ocl::Exception);
+    ocl::Range<3> too_deep { 1, 1, dev.image3d_max_depth() + 1 };
+    EXPECT_THROW(ocl::Image3D<cl_float4> img(too_deep), ocl::Exception);
+}
+
+TEST(ImageTest, sample)
+{
+    if (!have_images())
+        GTEST_SKIP();
+
+    const int W = 4;
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+
+    ocl::Image2D<cl_float4> img(ocl::Range<2> { W, 1 });
+    std::vector<cl_float4> h_img(W);
+    for (int i = 0; i < W; i++)
+        h_img[i] = { { 2.f * i, 0.f, 0.f, 1.f } };
+    q.copy(h_img.data(), img);
+
+    ocl::Sampler smp(ctx, false, ocl::ADDRESS_CLAMP_TO_EDGE, ocl::FILTER_LINEAR);
+    ocl::Range<1> rng { W - 1 };
+    ocl::Buffer<float> d_out(rng);
+    using Image = ocl::Image2D<cl_float4>;
+    auto interpolate =
+        ocl::Kernel::create<Image, ocl::Sampler, ocl::Buffer<float>>(prg, "interpolate");
+    std::vector<float> h_out(W - 1);
+    q.submit([&](auto & h) {
+        h.kernel(interpolate(img, smp, d_out), rng);
+        h.copy(d_out, h_out.data(), rng);
+    });
+    EXPECT_THAT(h_out, testing::ElementsAre(1.f, 3.f, 5.f));
+}
@@ -107,3 +107,87 @@ TEST(KernelFunctorTest, execute2)
         EXPECT_FLOAT_EQ(h_c[i], 2. * (i + 1));
     }
 }
+
+TEST(KernelFunctorTest, execute_out_of_order)
+{
+    const int N = 10;
+    std::vector<float> h_a(N);
+    std::vector<float> h_b(N);
+    std::vector<float> h_c(N);
+
+    auto ctx = ocl::Context::get_default();
+    ocl::Queue q(ctx, ocl::OUT_OF_ORDER_EXEC_MODE_ENABLE);
+
+    auto prg = ocl::Program::from_source(ctx, src1);
+    prg.build();
+
+    for (int i = 0; i < N; i++) {
+        h_a[i] = i + 1;
+        h_b[i] = 100 - i;
+    }
+
+    ocl::Range<1> rng { N };
+    using FloatBuffer = ocl::Buffer<float>;
+
+    FloatBuffer d_a { rng };
+    FloatBuffer d_b { rng };
+    FloatBuffer d_c { rng };
+
+    auto vec_add = ocl::Kernel::create<FloatBuffer, FloatBuffer, FloatBuffer>(prg, "vec_add");
+
+    q.submit([&](auto & h) {
+        h.copy(h_a.data(), d_a, rng);
+        h.copy(h_b.data(), d_b, rng);
+        h.reads(d_a, d_b).writes(d_c);
+        h.kernel(vec_add(d_a, d_b, d_c), rng);
+        h.copy(d_c, h_c.data(), rng);
+    });
+    for (auto & i : h_c) {
+        EXPECT_FLOAT_EQ(i, 101);
+    }
+}
+
+TEST(KernelFunctorTest, execute_non_blocking)
+{
+    const int N = 10;
+    std::vector<float> h_a(N);
+    std::vector<float> h_b(N);
+    std::vector<float> h_c(N);
+
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+
+    auto prg = ocl::Program::from_source(ctx, src1);
+    prg.build();
+
+    for (int i = 0; i < N; i++) {
+        h_a[i] = i + 1;
+        h_b[i] = 100 - i;
+    }
+
+    ocl::Range<1> rng { N };
+    using FloatBuffer = ocl::Buffer<float>;
+
+    FloatBuffer d_a { rng };
+    FloatBuffer d_b { rng };
+    FloatBuffer d_c { rng };
+
+    auto vec_add = ocl::Kernel::create<FloatBuffer, FloatBuffer, FloatBuffer>(prg, "vec_add");
+
+    auto upload = q.submit([&](auto & h) {
+        h.icopy(h_a.data(), d_a, rng);
+        h.icopy(h_b.data(), d_b, rng);
+    });
+    ocl::Event k_evt;
+    auto done = q.submit([&](auto & h) {
+        h.depends_on(upload);
+        k_evt = h.kernel(vec_add(d_a, d_b, d_c), rng);
+        h.icopy(d_c, h_c.data(), rng, { k_evt });
+    });
+    done.wait();
+
+    EXPECT_EQ(k_evt.command_execution_status(), ocl::COMPLETE);
+    for (auto & i : h_c) {
+        EXPECT_FLOAT_EQ(i, 101);
+    }
+}
@@ -78,3 +78,48 @@ TEST(KernelTest, execute)
         EXPECT_FLOAT_EQ(i, 101);
     }
 }
+
+TEST(KernelTest, work_group_size)
+{
+    auto ctx = ocl::Context::get_default();
+    auto dev = ctx.devices()[0];
+    auto prg = ocl::Program::from_source(ctx, src1);
+    prg.build();
+
+    ocl::Kernel k(prg, "vec_add");
+    EXPECT_GE(k.work_group_size(dev), 1);
+    EXPECT_LE(k.work_group_size(dev), dev.max_work_group_size());
+    EXPECT_GE(k.preferred_work_group_size_multiple(dev), 1);
+}
+
+TEST(KernelTest, execute_nd_range)
+{
+    const int N = 16;
+    std::vector<float> h_a(N, 1.f);
+    std::vector<float> h_b(N, 2.f);
+    std::vector<float> h_c(N, 0.f);
+
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    auto prg = ocl::Program::from_source(ctx, src1);
+    prg.build();
+
+    ocl::Range<1> rng { N };
+    ocl::Buffer<float> d_a { h_a.data(), rng };
+    ocl::Buffer<float> d_b { h_b.data(), rng };
+    ocl::Buffer<float> d_c { h_c.data(), rng };
+
+    ocl::Kernel k(prg, "vec_add");
+    k.set_arg(0, d_a);
+    k.set_arg(1, d_b);
+    k.set_arg(2, d_c);
+
+    // only the second half of the buffer is computed
+    ocl::NDRange<1> half(ocl::Range<1> { N / 2 }, ocl::Range<1> { 4 }, ocl::Range<1> { N / 2 });
+    q.submit([&](auto & h) {
+        h.kernel(k, half);
+        h.copy(d_c, h_c.data(), rng);
+    });
+    for (int i = 0; i < N; i++)
+        EXPECT_FLOAT_EQ(h_c[i], i < N / 2 ? 0.f : 3.f);
+}
@@ -0,0 +1,57 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/event.h"
+
+namespace ocl = openclcpp_lite;
+
+TEST(LeakTest, copies)
+{
+    ocl::Buffer<float> d_a { ocl::Range<1> { 10 } };
+    EXPECT_EQ(d_a.reference_count(), 1);
+    {
+        auto d_b = d_a;
+        EXPECT_EQ(d_a.reference_count(), 2);
+        auto d_c = std::move(d_b);
+        EXPECT_EQ(d_a.reference_count(), 2);
+        EXPECT_EQ(static_cast<cl_mem>(d_b), nullptr);
+    }
+    EXPECT_EQ(d_a.reference_count(), 1);
+
+    ocl::Buffer<float> d_d { ocl::Range<1> { 10 } };
+    d_d = d_a;
+    EXPECT_EQ(d_a.reference_count(), 2);
+    d_d = ocl::Buffer<float> { ocl::Range<1> { 10 } };
+    EXPECT_EQ(d_a.reference_count(), 1);
+}
+
+TEST(LeakTest, enqueue)
+{
+    const int N = 1000000;
+    const int N_BATCH = 1000;
+
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    ocl::Range<1> rng { 16 };
+    ocl::Buffer<float> d_a { rng };
+    ocl::Buffer<float> d_b { rng };
+
+    auto n_mem_refs = d_a.reference_count();
+    auto n_q_refs = q.reference_count();
+    auto n_ctx_refs = ctx.reference_count();
+    for (int i = 0; i < N; i += N_BATCH) {
+        ocl::Event evt;
+        for (int j = 0; j < N_BATCH; j++) {
+            if (j % 2 == 0)
+                evt = q.fill(d_a, (float) j, rng, evt);
+            else
+                evt = q.copy(d_a, d_b, rng, evt);
+        }
+        q.wait();
+    }
+    EXPECT_EQ(d_a.reference_count(), n_mem_refs);
+    EXPECT_EQ(d_b.reference_count(), n_mem_refs);
+    EXPECT_EQ(q.reference_count(), n_q_refs);
+    EXPECT_EQ(ctx.reference_count(), n_ctx_refs);
+}
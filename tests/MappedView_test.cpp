@@ -0,0 +1,83 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/mapped_view.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/range.h"
+#include <algorithm>
+#include <numeric>
+
+namespace ocl = openclcpp_lite;
+
+TEST(MappedViewTest, read)
+{
+    const int N = 10;
+    ocl::Range<1> rng { N };
+    std::vector<int> h_a(N);
+    std::iota(h_a.begin(), h_a.end(), 0);
+    ocl::Buffer<int> d_a(h_a.data(), rng);
+
+    auto q = ocl::Queue::get_default();
+    auto view = q.map(d_a, ocl::READ);
+    EXPECT_EQ(view.size(), N);
+    EXPECT_THAT(view.span(), testing::ElementsAreArray(h_a));
+}
+
+TEST(MappedViewTest, window)
+{
+    const int N = 10;
+    ocl::Range<1> rng { N };
+    ocl::Buffer<int> d_a(rng);
+    auto q = ocl::Queue::get_default();
+    q.fill(d_a, 0, rng);
+    {
+        auto view =
+            q.map(d_a, ocl::WRITE_INVALIDATE_REGION, ocl::Range<1> { 3 }, ocl::Range<1> { 4 });
+        EXPECT_EQ(view.size(), 4);
+        std::fill(view.begin(), view.end(), 7);
+    }
+
+    std::vector<int> h_a(N);
+    q.copy(d_a, h_a.data(), rng).wait();
+    EXPECT_THAT(h_a, testing::ElementsAre(0, 0, 0, 7, 7, 7, 7, 0, 0, 0));
+}
+
+TEST(MappedViewTest, async)
+{
+    const int N = 100;
+    ocl::Range<1> rng { N };
+    ocl::Buffer<float> d_a(rng);
+    auto q = ocl::Queue::get_default();
+    auto fill = q.fill(d_a, 2.f, rng);
+
+    auto view = q.map(d_a, ocl::WRITE, false);
+    view.wait();
+    EXPECT_EQ(view.event().command_execution_status(), ocl::COMPLETE);
+    EXPECT_THAT(view.span(), testing::Each(2.f));
+    view[0] = 3.f;
+
+    auto unmap = view.unmap();
+    EXPECT_TRUE(view.empty());
+    EXPECT_EQ(view.data(), nullptr);
+
+    std::vector<float> h_a(N);
+    q.copy(d_a, h_a.data(), rng, { unmap }).wait();
+    EXPECT_EQ(h_a[0], 3.f);
+    EXPECT_EQ(h_a[1], 2.f);
+}
+
+TEST(MappedViewTest, move)
+{
+    ocl::Range<1> rng { 8 };
+    ocl::Buffer<int> d_a(rng);
+    auto q = ocl::Queue::get_default();
+    q.fill(d_a, 1, rng);
+
+    ocl::MappedView<int> view;
+    EXPECT_TRUE(view.empty());
+    view = q.map(d_a, ocl::READ);
+    EXPECT_EQ(view.size(), 8);
+    ocl::MappedView<int> other(std::move(view));
+    EXPECT_EQ(view.data(), nullptr);
+    EXPECT_EQ(other[7], 1);
+    other.unmap().wait();
+}
@@ -0,0 +1,136 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/memory_accounting.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+/// Wait until `pred` holds. Memory objects are removed from the accounting in destructor
+/// callbacks, which the OpenCL implementation may run asynchronously.
+template <typename P>
+bool
+eventually(P && pred)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(MemoryAccountingTest, live_bytes)
+{
+    auto ctx = ocl::Context::get_default();
+    auto before = ocl::MemoryAccounting::snapshot();
+    {
+        ocl::Buffer<float> d_a(ctx, ocl::Range<1> { 1000 });
+
+        auto snap = ocl::MemoryAccounting::snapshot();
+        EXPECT_EQ(snap.total.live_bytes, before.total.live_bytes + 1000 * sizeof(float));
+        EXPECT_EQ(snap.total.live_allocations, before.total.live_allocations + 1);
+        EXPECT_EQ(snap.total.total_allocations, before.total.total_allocations + 1);
+        EXPECT_GE(snap.total.peak_bytes, snap.total.live_bytes);
+        EXPECT_EQ(snap.context(ctx).live_bytes,
+                  before.context(ctx).live_bytes + 1000 * sizeof(float));
+        for (auto & dev : ctx.devices())
+            EXPECT_EQ(snap.device(dev).live_bytes,
+                      before.device(dev).live_bytes + 1000 * sizeof(float));
+    }
+    EXPECT_TRUE(eventually([&] {
+        auto after = ocl::MemoryAccounting::snapshot();
+        return after.total.live_allocations == before.total.live_allocations;
+    }));
+    auto after = ocl::MemoryAccounting::snapshot();
+    EXPECT_EQ(after.total.live_bytes, before.total.live_bytes);
+    EXPECT_GE(after.total.peak_bytes, before.total.live_bytes + 1000 * sizeof(float));
+}
+
+TEST(MemoryAccountingTest, context_peak)
+{
+    auto ctx = ocl::Context::get_default();
+    for (auto & dev : ctx.devices())
+        if (!dev.version().starts_with("OpenCL 3"))
+            GTEST_SKIP();
+
+    {
+        ocl::Buffer<float> d_a(ctx, ocl::Range<1> { 1000 });
+    }
+    EXPECT_TRUE(eventually([&] {
+        return ocl::MemoryAccounting::snapshot().context(ctx).live_allocations == 0;
+    }));
+    // the context outlives its memory objects, so its peak is kept
+    auto usage = ocl::MemoryAccounting::snapshot().context(ctx);
+    EXPECT_GE(usage.peak_bytes, 1000 * sizeof(float));
+    EXPECT_GE(usage.total_allocations, 1);
+}
+
+TEST(MemoryAccountingTest, sites)
+{
+    auto ctx = ocl::Context::get_default();
+    std::uint_least32_t line = 0;
+    auto site = [&] {
+        auto snap = ocl::MemoryAccounting::snapshot();
+        auto it = std::find_if(snap.sites.begin(), snap.sites.end(), [&](const auto & s) {
+            return s.line == line && s.file.ends_with("MemoryAccounting_test.cpp");
+        });
+        return it != snap.sites.end() ? it->usage : ocl::MemoryAccounting::Usage();
+    };
+    // the second allocation is recorded at the same site
+    for (int i = 0; i < 2; i++) {
+        {
+            ocl::Buffer<int> d_a(ctx, ocl::Range<1> { 4096 });
+            line = __LINE__ - 1;
+
+            auto usage = site();
+            EXPECT_EQ(usage.live_bytes, 4096 * sizeof(int));
+            EXPECT_EQ(usage.live_allocations, 1);
+            EXPECT_EQ(usage.total_allocations, i + 1);
+
+            std::ostringstream oss;
+            ocl::MemoryAccounting::dump(oss);
+            EXPECT_THAT(oss.str(), testing::HasSubstr("MemoryAccounting_test.cpp"));
+        }
+        EXPECT_TRUE(eventually([&] { return site().live_allocations == 0; }));
+    }
+}
+
+TEST(MemoryAccountingTest, reset_peaks)
+{
+    auto ctx = ocl::Context::get_default();
+    auto before = ocl::MemoryAccounting::snapshot();
+    {
+        ocl::Buffer<float> d_a(ctx, ocl::Range<1> { 1000 });
+    }
+    EXPECT_TRUE(eventually([&] {
+        auto snap = ocl::MemoryAccounting::snapshot();
+        return snap.total.live_allocations == before.total.live_allocations;
+    }));
+    ocl::MemoryAccounting::reset_peaks();
+    auto snap = ocl::MemoryAccounting::snapshot();
+    EXPECT_EQ(snap.total.peak_bytes, snap.total.live_bytes);
+}
+
+TEST(MemoryAccountingTest, disabled)
+{
+    auto ctx = ocl::Context::get_default();
+    ASSERT_TRUE(ocl::MemoryAccounting::enabled());
+    ocl::MemoryAccounting::set_enabled(false);
+    auto before = ocl::MemoryAccounting::snapshot();
+    {
+        ocl::Buffer<float> d_a(ctx, ocl::Range<1> { 1000 });
+        auto snap = ocl::MemoryAccounting::snapshot();
+        EXPECT_EQ(snap.total.live_bytes, before.total.live_bytes);
+    }
+    ocl::MemoryAccounting::set_enabled(true);
+}
@@ -0,0 +1,113 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/memory_pool.h"
+#include "openclcpp-lite/queue.h"
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+/// Wait until `pred` holds. Blocks go back into the pool from destructor callbacks, which the
+/// OpenCL implementation may run asynchronously.
+template <typename P>
+bool
+eventually(P && pred)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(MemoryPoolTest, size_class)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::MemoryPool pool(ctx, 1024 * 1024);
+    auto align = pool.alignment();
+    EXPECT_GE(align, 1);
+    EXPECT_EQ(pool.size_class(1), align);
+    EXPECT_EQ(pool.size_class(align), align);
+    EXPECT_EQ(pool.size_class(align + 1), 2 * align);
+    EXPECT_EQ(pool.size_class(pool.slab_size() + 1), 0);
+    EXPECT_EQ(pool.size_class(std::numeric_limits<std::size_t>::max()), 0);
+}
+
+TEST(MemoryPoolTest, reuse)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::MemoryPool pool(ctx, 1024 * 1024);
+    ocl::Range<1> rng { 100 };
+
+    cl_mem first;
+    {
+        ocl::Buffer<float> d_a { pool, rng };
+        first = d_a;
+        EXPECT_EQ(d_a.byte_size(), 100 * sizeof(float));
+        EXPECT_EQ(d_a.context(), ctx);
+        EXPECT_EQ(d_a.offset() % pool.alignment(), 0);
+
+        auto stats = pool.stats();
+        EXPECT_EQ(stats.misses, 1);
+        EXPECT_EQ(stats.hits, 0);
+        EXPECT_EQ(stats.bytes_in_use, pool.size_class(100 * sizeof(float)));
+        EXPECT_EQ(stats.bytes_requested, 100 * sizeof(float));
+        EXPECT_GE(stats.bytes_reserved, stats.bytes_in_use);
+    }
+    EXPECT_NE(first, nullptr);
+    EXPECT_TRUE(eventually([&]() { return pool.stats().bytes_in_use == 0; }));
+
+    for (int i = 0; i < 10; i++) {
+        ocl::Buffer<float> d_a { pool, rng };
+        ocl::Buffer<float> d_b { pool, rng };
+        EXPECT_NE(d_a.offset(), d_b.offset());
+    }
+    EXPECT_TRUE(eventually([&]() { return pool.stats().bytes_in_use == 0; }));
+    auto stats = pool.stats();
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.hits, 20);
+    EXPECT_DOUBLE_EQ(stats.hit_rate(), 20. / 21.);
+    EXPECT_EQ(stats.fragmentation(), 0.);
+
+    pool.trim();
+    EXPECT_EQ(pool.stats().bytes_reserved, 0);
+}
+
+TEST(MemoryPoolTest, data)
+{
+    const int N = 100;
+    ocl::Range<1> rng { N };
+    auto q = ocl::Queue::get_default();
+    auto pool = ocl::MemoryPool::get_default();
+
+    ocl::Buffer<int> d_a { pool, rng };
+    ocl::Buffer<int> d_b { pool, rng };
+    q.fill(d_a, 1, rng);
+    q.fill(d_b, 2, rng);
+    std::vector<int> h_a(N), h_b(N);
+    q.copy(d_a, h_a.data(), rng);
+    q.copy(d_b, h_b.data(), rng).wait();
+    EXPECT_THAT(h_a, testing::Each(1));
+    EXPECT_THAT(h_b, testing::Each(2));
+}
+
+TEST(MemoryPoolTest, large)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::MemoryPool pool(ctx, 4096);
+    {
+        ocl::Buffer<char> d_a { pool, ocl::Range<1> { 8192 } };
+        EXPECT_EQ(d_a.byte_size(), 8192);
+        EXPECT_EQ(pool.stats().bytes_reserved, 8192);
+    }
+    EXPECT_TRUE(eventually([&]() { return pool.stats().bytes_reserved == 0; }));
+}
@@ -0,0 +1,59 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/kernel_functor.h"
+#include "openclcpp-lite/pipeline.h"
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+// clang-format off
+std::string src = R"(
+__kernel void
+twice(__global const int *A, __global int *B)
+{
+    int i = get_global_id(0);
+    B[i] = 2 * A[i];
+}
+)";
+// clang-format on
+
+} // namespace
+
+TEST(PipelineTest, ctor)
+{
+    ocl::Pipeline<int> pipe(16, 3);
+    EXPECT_EQ(pipe.chunk_size(), 16);
+    EXPECT_EQ(pipe.depth(), 3);
+    EXPECT_EQ(pipe.transfer_queue().device().name(), pipe.compute_queue().device().name());
+
+    EXPECT_THROW(ocl::Pipeline<int>(0), ocl::Exception);
+    EXPECT_THROW(ocl::Pipeline<int>(16, 0), ocl::Exception);
+}
+
+TEST(PipelineTest, run)
+{
+    auto ctx = ocl::Context::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+    using IntBuffer = ocl::Buffer<int>;
+    auto twice = ocl::Kernel::create<IntBuffer, IntBuffer>(prg, "twice");
+
+    // not a multiple of the chunk size, so the last chunk is partial
+    const int N = 1000;
+    std::vector<int> h_in(N);
+    for (int i = 0; i < N; i++)
+        h_in[i] = i;
+
+    for (unsigned int depth = 1; depth <= 3; depth++) {
+        std::vector<int> h_out(N, -1);
+        ocl::Pipeline<int> pipe(ctx, ctx.devices()[0], 64, depth);
+        pipe.run(h_in.data(), h_out.data(), N, [&](auto & in, auto & out, size_t) {
+            return twice(in, out);
+        });
+        for (int i = 0; i < N; i++)
+            EXPECT_EQ(h_out[i], 2 * i);
+    }
+}
@@ -0,0 +1,126 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/kernel_functor.h"
+#include "openclcpp-lite/range.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/command_graph.h"
+#include <vector>
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+// clang-format off
+std::string src = R"(
+__kernel void
+scale(__global float * a, uint a_pitch, const float alpha)
+{
+    size_t x = get_global_id(0);
+    size_t y = get_global_id(1);
+    a[x + y * a_pitch] *= alpha;
+}
+)";
+// clang-format on
+
+} // namespace
+
+TEST(PitchedBufferTest, layout)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::Range<2> rng { 13, 7 };
+    ocl::PitchedBuffer<float, 2> d_a(ctx, rng);
+
+    EXPECT_EQ(d_a.range().size(0), 13);
+    EXPECT_EQ(d_a.range().size(1), 7);
+    EXPECT_GE(d_a.row_pitch(), 13 * sizeof(float));
+    EXPECT_EQ(d_a.row_pitch(), d_a.aligned_pitch(ctx, 13) * sizeof(float));
+    EXPECT_EQ(d_a.slice_pitch(), 0);
+    EXPECT_EQ(d_a.byte_size(), d_a.row_pitch() * 7);
+    for (auto & dev : ctx.devices())
+        EXPECT_EQ(d_a.row_pitch() % dev.global_mem_cache_line_size(), 0);
+
+    ocl::Buffer<float, 2> d_b(ctx, rng);
+    EXPECT_FALSE(d_b.padded());
+    EXPECT_EQ(d_b.row_pitch(), 13 * sizeof(float));
+}
+
+TEST(PitchedBufferTest, copy)
+{
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    ocl::Range<2> rng { 13, 7 };
+    std::vector<float> h_a(rng.size());
+    for (size_t i = 0; i < h_a.size(); i++)
+        h_a[i] = i;
+
+    ocl::PitchedBuffer<float, 2> d_a(ctx, rng);
+    ocl::Buffer<float, 2> d_b(ctx, rng);
+    q.copy(h_a.data(), d_a, rng);
+    q.copy(d_a, d_b, rng);
+
+    std::vector<float> h_b(rng.size());
+    q.copy(d_b, h_b.data(), rng).wait();
+    EXPECT_EQ(h_b, h_a);
+
+    std::vector<float> h_c(rng.size());
+    q.copy(d_a, h_c.data(), rng).wait();
+    EXPECT_EQ(h_c, h_a);
+
+    std::vector<float> h_d(2 * 3);
+    q.copy_rect(d_a,
+                ocl::Range<2> { 4, 2 },
+                h_d.data(),
+                ocl::Range<2> { 2, 3 },
+                ocl::Range<2> { 0, 0 },
+                ocl::Range<2> { 2, 3 })
+        .wait();
+    for (size_t y = 0; y < 3; y++)
+        for (size_t x = 0; x < 2; x++)
+            EXPECT_EQ(h_d[x + 2 * y], h_a[(4 + x) + 13 * (2 + y)]);
+
+    // handlers copy padded buffers as rectangular regions
+    ocl::PitchedBuffer<float, 2> d_e(ctx, rng);
+    std::vector<float> h_e(rng.size());
+    std::vector<float> h_f(rng.size());
+    q.fill(d_b, 0.f, rng);
+    auto evt = q.submit([&](ocl::Handler & h) {
+        h.copy(d_a, d_b, rng);
+        h.copy(d_b, d_e, rng);
+        h.copy(d_e, h_e.data(), rng);
+        h.copy(d_a, h_f.data(), rng);
+    });
+    evt.wait();
+    EXPECT_EQ(h_e, h_a);
+    EXPECT_EQ(h_f, h_a);
+
+    std::vector<float> h_g(rng.size());
+    auto graph = q.record([&](ocl::Handler & h) {
+        h.fill(d_e, 0.f, rng);
+        h.copy(d_a, d_e, rng);
+        h.copy(d_e, h_g.data(), rng);
+    });
+    graph.replay().wait();
+    EXPECT_EQ(h_g, h_a);
+}
+
+TEST(PitchedBufferTest, kernel_args)
+{
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+
+    ocl::Range<2> rng { 13, 7 };
+    std::vector<float> h_a(rng.size(), 1.f);
+    ocl::PitchedBuffer<float, 2> d_a(ctx, rng);
+    q.copy(h_a.data(), d_a, rng);
+
+    auto scale = ocl::Kernel::create<ocl::PitchedBuffer<float, 2>, float>(prg, "scale");
+    q.submit([&](auto & h) { h.kernel(scale(d_a, 3.f), rng); });
+    q.copy(d_a, h_a.data(), rng).wait();
+    for (auto & v : h_a)
+        EXPECT_FLOAT_EQ(v, 3.f);
+}
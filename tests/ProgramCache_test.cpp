@@ -0,0 +1,96 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/program_cache.h"
+#include <filesystem>
+#include <fstream>
+
+namespace ocl = openclcpp_lite;
+namespace fs = std::filesystem;
+
+namespace {
+
+// clang-format off
+std::string src = R"(
+__kernel void vec_add(__global const int *A, __global const int *B, __global int *C) {
+    int i = get_global_id(0);
+    C[i] = A[i] + B[i];
+}
+)";
+// clang-format on
+
+fs::path
+cache_dir(const std::string & name)
+{
+    auto dir = fs::temp_directory_path() / "openclcpp-lite-test" / name;
+    fs::remove_all(dir);
+    return dir;
+}
+
+} // namespace
+
+TEST(ProgramCacheTest, hit_and_miss)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::ProgramCache cache(cache_dir("hit_and_miss").string());
+
+    auto prg1 = cache.build(ctx, src);
+    EXPECT_EQ(cache.misses(), 1);
+    EXPECT_EQ(cache.hits(), 0);
+    EXPECT_THAT(prg1.kernel_names(), testing::UnorderedElementsAre("vec_add"));
+
+    auto prg2 = cache.build(ctx, src);
+    EXPECT_EQ(cache.misses(), 1);
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_THAT(prg2.kernel_names(), testing::UnorderedElementsAre("vec_add"));
+
+    // different options must not reuse the entry
+    cache.build(ctx, src, { "-cl-fast-relaxed-math" });
+    EXPECT_EQ(cache.misses(), 2);
+    EXPECT_EQ(cache.hits(), 1);
+}
+
+TEST(ProgramCacheTest, key)
+{
+    auto dev = ocl::Device::get_default();
+    ocl::ProgramCache cache(cache_dir("key").string());
+    EXPECT_EQ(cache.key(src, {}, dev), cache.key(src, {}, dev));
+    EXPECT_NE(cache.key(src, {}, dev), cache.key(src, { "-DN=1" }, dev));
+    EXPECT_NE(cache.key(src, {}, dev), cache.key(src + "\n", {}, dev));
+    EXPECT_EQ(cache.key(src, {}, dev).size(), 16);
+}
+
+TEST(ProgramCacheTest, stale_entry)
+{
+    auto ctx = ocl::Context::get_default();
+    auto dev = ctx.devices()[0];
+    auto dir = cache_dir("stale_entry");
+    ocl::ProgramCache cache(dir.string());
+    cache.build(ctx, src);
+
+    // truncate the entry to simulate a corrupted file
+    auto path = dir / (cache.key(src, {}, dev) + ".bin");
+    ASSERT_TRUE(fs::exists(path));
+    fs::resize_file(path, fs::file_size(path) / 2);
+
+    auto prg = cache.build(ctx, src);
+    EXPECT_EQ(cache.misses(), 2);
+    EXPECT_EQ(cache.hits(), 0);
+    EXPECT_THAT(prg.kernel_names(), testing::UnorderedElementsAre("vec_add"));
+
+    // the entry was rewritten
+    cache.build(ctx, src);
+    EXPECT_EQ(cache.hits(), 1);
+}
+
+TEST(ProgramCacheTest, clear)
+{
+    auto ctx = ocl::Context::get_default();
+    auto dir = cache_dir("clear");
+    ocl::ProgramCache cache(dir.string());
+    cache.build(ctx, src);
+    EXPECT_FALSE(fs::is_empty(dir));
+    cache.clear();
+    EXPECT_TRUE(fs::is_empty(dir));
+}
@@ -70,6 +70,7 @@ TEST(ProgramTest, from_single_line)
     prg.build();
     EXPECT_EQ(prg.num_of_kernels(), 1);
     EXPECT_THAT(prg.kernel_names(), testing::UnorderedElementsAre("vector_add"));
+    EXPECT_EQ(prg.source(), src1);
 }
 
 TEST(ProgramTest, from_lines)
@@ -0,0 +1,60 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/queue_pool.h"
+#include "openclcpp-lite/range.h"
+#include "openclcpp-lite/buffer.h"
+#include <thread>
+
+namespace ocl = openclcpp_lite;
+
+TEST(QueuePoolTest, per_thread)
+{
+    ocl::QueuePool pool;
+    EXPECT_EQ(pool.size(), 0);
+
+    cl_command_queue q0 = pool.get();
+    EXPECT_EQ((cl_command_queue) pool.get(), q0);
+    EXPECT_EQ(pool.size(), 1);
+
+    cl_command_queue worker_q = nullptr;
+    cl_command_queue worker_q2 = nullptr;
+    std::thread worker([&]() {
+        worker_q = pool.get();
+        worker_q2 = pool.get();
+    });
+    worker.join();
+    EXPECT_NE(worker_q, q0);
+    EXPECT_EQ(worker_q2, worker_q);
+    EXPECT_EQ(pool.size(), 2);
+
+    // a thread gets separate queues from separate pools
+    ocl::QueuePool other;
+    EXPECT_NE((cl_command_queue) other.get(), q0);
+    EXPECT_EQ((cl_command_queue) pool.get(), q0);
+}
+
+TEST(QueuePoolTest, enqueue)
+{
+    const int N = 16;
+    const int N_THREADS = 4;
+    ocl::QueuePool pool;
+    ocl::Range<1> rng { N };
+    std::vector<std::vector<int>> results(N_THREADS, std::vector<int>(N));
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < N_THREADS; t++)
+        workers.emplace_back([&, t]() {
+            auto q = pool.get();
+            ocl::Buffer<int> d_a { rng };
+            q.fill(d_a, t, rng);
+            q.copy(d_a, results[t].data(), rng);
+        });
+    for (auto & w : workers)
+        w.join();
+    pool.wait();
+
+    for (int t = 0; t < N_THREADS; t++)
+        for (auto & v : results[t])
+            EXPECT_EQ(v, t);
+}
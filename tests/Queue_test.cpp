@@ -5,6 +5,7 @@
 #include "openclcpp-lite/enums.h"
 #include "openclcpp-lite/range.h"
 #include "openclcpp-lite/buffer.h"
+#include <thread>
 
 namespace ocl = openclcpp_lite;
 
@@ -179,6 +180,119 @@ TEST(QueueTest, async_copy_buffer)
     EXPECT_EQ(h_b[4], 104);
 }
 
+TEST(QueueTest, copy_rect_2d)
+{
+    // 4x3 field, copy the 2x2 block at (1, 1) into the origin of a 3x2 field
+    const int NX = 4, NY = 3;
+    std::vector<int> h_a(NX * NY);
+    for (int i = 0; i < NX * NY; i++)
+        h_a[i] = i;
+    ocl::Range<2> shape_a { NX, NY };
+    ocl::Range<2> shape_b { 3, 2 };
+    ocl::Buffer<int, 2> d_a { shape_a };
+    ocl::Buffer<int, 2> d_b { shape_b };
+    auto q = ocl::Queue::get_default();
+    auto wr_evt = q.copy(h_a.data(), d_a, shape_a);
+    auto fl_evt = q.fill(d_b, -1, shape_b);
+    auto cp_evt = q.copy_rect(d_a,
+                              shape_a,
+                              ocl::Range<2> { 1, 1 },
+                              d_b,
+                              shape_b,
+                              ocl::Range<2> { 0, 0 },
+                              ocl::Range<2> { 2, 2 },
+                              { wr_evt, fl_evt });
+    std::vector<int> h_b(3 * 2);
+    q.copy(d_b, h_b.data(), shape_b, cp_evt).wait();
+    EXPECT_THAT(h_b, testing::ElementsAre(5, 6, -1, 9, 10, -1));
+
+    // read the block back into the middle of a host array
+    std::vector<int> h_c(4 * 4, 0);
+    q.copy_rect(d_b,
+                shape_b,
+                ocl::Range<2> { 0, 0 },
+                h_c.data(),
+                ocl::Range<2> { 4, 4 },
+                ocl::Range<2> { 1, 2 },
+                ocl::Range<2> { 2, 2 })
+        .wait();
+    EXPECT_EQ(h_c[2 * 4 + 1], 5);
+    EXPECT_EQ(h_c[2 * 4 + 2], 6);
+    EXPECT_EQ(h_c[3 * 4 + 1], 9);
+    EXPECT_EQ(h_c[3 * 4 + 2], 10);
+    EXPECT_EQ(h_c[0], 0);
+}
+
+TEST(QueueTest, copy_rect_3d)
+{
+    // write a single column of a 2x2x3 field from host memory
+    ocl::Range<3> shape { 2, 2, 3 };
+    ocl::Buffer<float, 3> d_a { shape };
+    auto q = ocl::Queue::get_default();
+    q.fill(d_a, 0.f, shape).wait();
+    std::vector<float> col = { 1.f, 2.f, 3.f };
+    q.copy_rect(col.data(),
+                ocl::Range<3> { 1, 1, 3 },
+                ocl::Range<3> { 0, 0, 0 },
+                d_a,
+                shape,
+                ocl::Range<3> { 1, 0, 0 },
+                ocl::Range<3> { 1, 1, 3 })
+        .wait();
+    std::vector<float> h_a(shape.size());
+    q.copy(d_a, h_a.data(), shape).wait();
+    EXPECT_THAT(h_a, testing::ElementsAre(0, 1, 0, 0, 0, 2, 0, 0, 0, 3, 0, 0));
+}
+
+TEST(QueueTest, copy_window)
+{
+    const int N = 8;
+    std::vector<int> h_a(N);
+    for (int i = 0; i < N; i++)
+        h_a[i] = i;
+    ocl::Range<1> rng { N };
+    ocl::Buffer<int> d_a { rng };
+    ocl::Buffer<int> d_b { rng };
+    auto q = ocl::Queue::get_default();
+    q.copy(h_a.data(), d_a, rng).wait();
+    q.fill(d_b, 0, rng).wait();
+
+    // update elements 2..4 of `d_a` and move elements 1..5 into the front of `d_b`
+    std::vector<int> upd = { 20, 30, 40 };
+    auto wr_evt = q.copy(upd.data(), d_a, ocl::Range<1> { 2 }, ocl::Range<1> { 3 });
+    auto cp_evt =
+        q.copy(d_a, d_b, ocl::Range<1> { 1 }, ocl::Range<1> { 0 }, ocl::Range<1> { 5 }, { wr_evt });
+    auto fl_evt = q.fill(d_b, -1, ocl::Range<1> { 6 }, ocl::Range<1> { 2 }, { cp_evt });
+
+    std::vector<int> h_b(3);
+    q.copy(d_b, h_b.data(), ocl::Range<1> { 4 }, ocl::Range<1> { 3 }, { fl_evt }).wait();
+    EXPECT_THAT(h_b, testing::ElementsAre(5, 0, -1));
+
+    auto * ptr =
+        q.enqueue_map_buffer(d_b, true, ocl::READ, ocl::Range<1> { 1 }, ocl::Range<1> { 3 });
+    EXPECT_EQ(ptr[0], 20);
+    EXPECT_EQ(ptr[1], 30);
+    EXPECT_EQ(ptr[2], 40);
+    q.enqueue_unmap_mem_object(d_b, ptr).wait();
+}
+
+TEST(QueueTest, copy_window_w_submit)
+{
+    const int N = 6;
+    std::vector<int> h_a = { 1, 2, 3, 4, 5, 6 };
+    ocl::Range<1> rng { N };
+    ocl::Buffer<int> d_a { rng };
+    auto q = ocl::Queue::get_default();
+    q.fill(d_a, 0, rng).wait();
+    std::vector<int> h_b(N, 0);
+    q.submit([&](ocl::Handler & h) {
+        h.copy(h_a.data(), d_a, ocl::Range<1> { 3 }, ocl::Range<1> { 3 });
+        h.copy(d_a, h_b.data(), ocl::Range<1> { 2 }, ocl::Range<1> { 4 });
+    });
+    q.wait();
+    EXPECT_THAT(h_b, testing::ElementsAre(0, 1, 2, 3, 0, 0));
+}
+
 TEST(QueueTest, marker)
 {
     const int N = 5;
@@ -243,3 +357,80 @@ TEST(QueueTest, fill_buffer_pattern)
     EXPECT_EQ(vals[3].a, 0.);
     EXPECT_EQ(vals[3].b, 0.);
 }
+
+TEST(QueueTest, migrate)
+{
+    const int N = 100;
+    std::vector<int> h_a(N);
+    for (int i = 0; i < N; i++)
+        h_a[i] = i;
+    std::vector<int> h_b(N, 0);
+    ocl::Range<1> rng { N };
+    ocl::Buffer<int> d_a { h_a.data(), rng };
+    ocl::Buffer<int> d_b { rng };
+
+    auto q = ocl::Queue::get_default();
+    q.migrate(d_a);
+    cl_mem mems[] = { d_a, d_b };
+    q.migrate(mems, ocl::MIGRATE_TO_HOST);
+    q.migrate(d_b, ocl::MIGRATE_CONTENT_UNDEFINED);
+    q.copy(d_a, d_b, rng);
+    q.copy(d_b, h_b.data(), rng).wait();
+    EXPECT_EQ(h_b, h_a);
+}
+
+TEST(QueueTest, out_of_order)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::Queue q(ctx, ocl::OUT_OF_ORDER_EXEC_MODE_ENABLE);
+    EXPECT_TRUE(q.out_of_order());
+
+    ocl::Queue q_in_order(ctx);
+    EXPECT_FALSE(q_in_order.out_of_order());
+}
+
+TEST(QueueTest, out_of_order_dependencies)
+{
+    const int N = 1000;
+    std::vector<int> h_a(N);
+    for (int i = 0; i < N; i++)
+        h_a[i] = 100 + i;
+    std::vector<int> h_b(N, 0);
+    std::vector<int> h_c(N, 0);
+    ocl::Range<1> rng { N };
+    ocl::Buffer<int> d_a { rng };
+    ocl::Buffer<int> d_b { rng };
+
+    auto ctx = ocl::Context::get_default();
+    ocl::Queue q(ctx, ocl::OUT_OF_ORDER_EXEC_MODE_ENABLE);
+    // no explicit events: write -> copy -> read are chained by the queue
+    q.copy(h_a.data(), d_a, rng);
+    q.copy(d_a, d_b, rng);
+    q.fill(d_a, 0, rng);
+    q.copy(d_b, h_b.data(), rng);
+    q.copy(d_a, h_c.data(), rng);
+    q.wait();
+
+    for (int i = 0; i < N; i++) {
+        EXPECT_EQ(h_b[i], 100 + i);
+        EXPECT_EQ(h_c[i], 0);
+    }
+}
+
+TEST(QueueTest, default_per_thread)
+{
+    cl_command_queue shared_q = ocl::Queue::get_default();
+
+    ocl::Queue::set_default_policy(ocl::PER_THREAD);
+    EXPECT_EQ(ocl::Queue::default_policy(), ocl::PER_THREAD);
+    cl_command_queue main_q = ocl::Queue::get_default();
+    EXPECT_EQ((cl_command_queue) ocl::Queue::get_default(), main_q);
+    EXPECT_NE(main_q, shared_q);
+    cl_command_queue worker_q = nullptr;
+    std::thread worker([&]() { worker_q = ocl::Queue::get_default(); });
+    worker.join();
+    EXPECT_NE(worker_q, main_q);
+
+    ocl::Queue::set_default_policy(ocl::SHARED);
+    EXPECT_EQ((cl_command_queue) ocl::Queue::get_default(), shared_q);
+}
@@ -30,3 +30,18 @@ TEST(RangeTest, three_d)
     EXPECT_EQ(rng.dimensions(), 3);
     EXPECT_EQ(rng.size(), 6000);
 }
+
+TEST(RangeTest, nd_range)
+{
+    ocl::NDRange<2> global_only(ocl::Range<2> { 8, 4 });
+    EXPECT_EQ(global_only.dimensions(), 2);
+    EXPECT_EQ(global_only.local_ptr(), nullptr);
+    EXPECT_EQ(global_only.offset_ptr(), nullptr);
+
+    ocl::NDRange<2> rng(ocl::Range<2> { 8, 4 }, ocl::Range<2> { 4, 2 }, ocl::Range<2> { 1, 0 });
+    EXPECT_EQ(rng.global().size(), 32);
+    EXPECT_EQ(rng.local_ptr()[0], 4);
+    EXPECT_EQ(rng.local_ptr()[1], 2);
+    EXPECT_EQ(rng.offset_ptr()[0], 1);
+    EXPECT_EQ(rng.offset_ptr()[1], 0);
+}
@@ -0,0 +1,106 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/svm.h"
+
+#ifdef CL_VERSION_2_0
+
+    #include "openclcpp-lite/context.h"
+    #include "openclcpp-lite/device.h"
+    #include "openclcpp-lite/kernel.h"
+    #include "openclcpp-lite/kernel_functor.h"
+    #include "openclcpp-lite/program.h"
+    #include "openclcpp-lite/queue.h"
+    #include "openclcpp-lite/range.h"
+    #include "openclcpp-lite/buffer.h"
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+struct Node {
+    int value;
+    Node * next;
+};
+
+// clang-format off
+std::string src = R"(
+typedef struct Node {
+    int value;
+    __global struct Node *next;
+} Node;
+
+__kernel void
+sum_list(__global Node *head, __global int *out)
+{
+    int s = 0;
+    for (__global Node *n = head; n != 0; n = n->next)
+        s += n->value;
+    out[0] = s;
+}
+)";
+// clang-format on
+
+bool
+have_svm()
+{
+    for (auto & dev : ocl::Context::get_default().devices())
+        if (!(dev.svm_capabilities() & ocl::Device::SVM_COARSE_GRAIN_BUFFER))
+            return false;
+    return true;
+}
+
+} // namespace
+
+TEST(SVMTest, allocator)
+{
+    if (!have_svm())
+        GTEST_SKIP();
+
+    auto ctx = ocl::Context::get_default();
+    ocl::SVMAllocator<int> alloc(ctx);
+    EXPECT_FALSE(alloc.fine_grained());
+    EXPECT_EQ(ocl::SVMAllocator<float>(alloc), alloc);
+
+    auto q = ocl::Queue::get_default();
+    // coarse-grained memory is constructed into only while mapped
+    ocl::SVMVector<int> v(alloc);
+    v.reserve(100);
+    q.svm_map(v.data(), 100, ocl::WRITE);
+    v.assign(100, 3);
+    q.svm_unmap(v.data());
+
+    q.svm_map(v.data(), v.size(), ocl::READ);
+    EXPECT_THAT(v, testing::Each(3));
+    q.svm_unmap(v.data()).wait();
+}
+
+TEST(SVMTest, linked_list)
+{
+    if (!have_svm())
+        GTEST_SKIP();
+
+    const int N = 10;
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build({ "-cl-std=CL2.0" });
+
+    // nodes live in one allocation and point to each other
+    ocl::SVMVector<Node> nodes;
+    nodes.reserve(N);
+    q.svm_map(nodes.data(), N, ocl::WRITE);
+    for (int i = 0; i < N; i++)
+        nodes.push_back({ i + 1, i + 1 < N ? nodes.data() + i + 1 : nullptr });
+    q.svm_unmap(nodes.data());
+
+    ocl::Range<1> rng { 1 };
+    ocl::Buffer<int> d_out(rng);
+    auto sum_list = ocl::Kernel::create<ocl::SVMPointer<Node>, ocl::Buffer<int>>(prg, "sum_list");
+    int sum = 0;
+    q.submit([&](auto & h) {
+        h.kernel(sum_list(ocl::svm_ptr(nodes.data()), d_out), ocl::Range<1> { 1 });
+        h.copy(d_out, &sum, rng);
+    });
+    EXPECT_EQ(sum, N * (N + 1) / 2);
+}
+
+#endif
@@ -0,0 +1,29 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/sampler.h"
+
+namespace ocl = openclcpp_lite;
+
+TEST(SamplerTest, create)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::Sampler smp(ctx, true, ocl::ADDRESS_REPEAT, ocl::FILTER_LINEAR);
+    EXPECT_EQ(smp.context(), ctx);
+    EXPECT_TRUE(smp.normalized_coords());
+    EXPECT_EQ(smp.addressing_mode(), ocl::ADDRESS_REPEAT);
+    EXPECT_EQ(smp.filter_mode(), ocl::FILTER_LINEAR);
+}
+
+TEST(SamplerTest, ref_cnt)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::Sampler smp(ctx, false);
+    EXPECT_EQ(smp.reference_count(), 1);
+    {
+        auto copy = smp;
+        EXPECT_EQ(smp.reference_count(), 2);
+        EXPECT_EQ(copy.addressing_mode(), ocl::ADDRESS_CLAMP_TO_EDGE);
+        EXPECT_EQ(copy.filter_mode(), ocl::FILTER_NEAREST);
+    }
+    EXPECT_EQ(smp.reference_count(), 1);
+}
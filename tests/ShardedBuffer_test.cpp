@@ -0,0 +1,88 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/kernel_functor.h"
+#include "openclcpp-lite/sharded_buffer.h"
+#include <vector>
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+// clang-format off
+std::string src = R"(
+__kernel void
+index(__global int * a)
+{
+    a[get_global_id(0) - get_global_offset(0)] = get_global_id(0);
+}
+)";
+// clang-format on
+
+} // namespace
+
+TEST(ShardedBufferTest, shards)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::ShardedBuffer<int> d_a(ctx, 10, ocl::READ_WRITE, 4);
+    EXPECT_EQ(d_a.size(), 10);
+    EXPECT_EQ(d_a.shard_size(), 4);
+    ASSERT_EQ(d_a.num_of_shards(), 3);
+    EXPECT_EQ(d_a.shard(0).byte_size(), 4 * sizeof(int));
+    EXPECT_EQ(d_a.shard(2).byte_size(), 2 * sizeof(int));
+    EXPECT_EQ(d_a.shard_offset(2), 8);
+
+    ocl::ShardedBuffer<int> d_b(ctx, 10);
+    EXPECT_EQ(d_b.num_of_shards(), 1);
+    for (auto & dev : ctx.devices())
+        EXPECT_LE(d_b.shard_size() * sizeof(int), dev.max_mem_alloc_size());
+}
+
+TEST(ShardedBufferTest, upload_download)
+{
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    const std::size_t N = 10;
+    std::vector<int> h_a(N);
+    for (std::size_t i = 0; i < N; i++)
+        h_a[i] = i;
+
+    ocl::ShardedBuffer<int> d_a(ctx, N, ocl::READ_WRITE, 4);
+    auto events = d_a.upload(q, h_a);
+    EXPECT_EQ(events.size(), 3);
+    ocl::Event::wait(events);
+
+    std::vector<int> h_b(N);
+    ocl::Event::wait(d_a.download(q, h_b));
+    EXPECT_EQ(h_b, h_a);
+
+    std::vector<int> h_c(5);
+    ocl::Event::wait(d_a.download(q, h_c, 3));
+    EXPECT_THAT(h_c, testing::ElementsAre(3, 4, 5, 6, 7));
+
+    ocl::Event::wait(d_a.fill(q, -1, 2, 5));
+    ocl::Event::wait(d_a.download(q, h_b));
+    EXPECT_THAT(h_b, testing::ElementsAre(0, 1, -1, -1, -1, -1, -1, 7, 8, 9));
+}
+
+TEST(ShardedBufferTest, launch)
+{
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+
+    const std::size_t N = 10;
+    ocl::ShardedBuffer<int> d_a(ctx, N, ocl::READ_WRITE, 4);
+    d_a.fill(q, 0);
+    auto index = ocl::Kernel::create<ocl::Buffer<int>>(prg, "index");
+    d_a.launch(q, [&](std::size_t i) -> const ocl::Kernel & { return index(d_a.shard(i)); });
+
+    std::vector<int> h_a(N);
+    ocl::Event::wait(d_a.download(q, h_a));
+    for (std::size_t i = 0; i < N; i++)
+        EXPECT_EQ(h_a[i], i);
+}
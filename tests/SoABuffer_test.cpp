@@ -0,0 +1,99 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/kernel_functor.h"
+#include "openclcpp-lite/soa_buffer.h"
+#include <vector>
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+struct Particle {
+    cl_float x;
+    cl_float v;
+    cl_int id;
+};
+
+using Particles = ocl::SoABuffer<&Particle::x, &Particle::v>;
+
+// clang-format off
+std::string src = R"(
+__kernel void
+move(__global float * x, __global const float * v, const float dt)
+{
+    size_t i = get_global_id(0);
+    x[i] += v[i] * dt;
+}
+)";
+// clang-format on
+
+} // namespace
+
+TEST(SoABufferTest, fields)
+{
+    auto ctx = ocl::Context::get_default();
+    Particles d_p(ctx, 10);
+    EXPECT_EQ(d_p.size(), 10);
+    EXPECT_EQ(Particles::NUM_KERNEL_ARGS, 2);
+    EXPECT_TRUE((std::is_same_v<Particles::record_type, Particle>));
+    EXPECT_TRUE((std::is_same_v<Particles::field_type<1>, cl_float>));
+    EXPECT_EQ(d_p.field<0>().byte_size(), 10 * sizeof(cl_float));
+    EXPECT_EQ(d_p.field<1>().byte_size(), 10 * sizeof(cl_float));
+}
+
+TEST(SoABufferTest, upload_download)
+{
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    const int N = 10;
+    std::vector<Particle> h_p(N);
+    for (int i = 0; i < N; i++)
+        h_p[i] = { (cl_float) i, (cl_float) (2 * i), i };
+
+    Particles d_p(ctx, N);
+    auto events = d_p.upload(q, h_p);
+    EXPECT_EQ(events.size(), 2);
+    ocl::Event::wait(events);
+
+    std::vector<float> h_v(N);
+    q.copy(d_p.field<1>(), h_v.data(), ocl::Range<1> { N }).wait();
+    for (int i = 0; i < N; i++)
+        EXPECT_FLOAT_EQ(h_v[i], 2 * i);
+
+    std::vector<Particle> h_r(N, Particle { 0.f, 0.f, -1 });
+    d_p.download(q, h_r);
+    for (int i = 0; i < N; i++) {
+        EXPECT_FLOAT_EQ(h_r[i].x, i);
+        EXPECT_FLOAT_EQ(h_r[i].v, 2 * i);
+        EXPECT_EQ(h_r[i].id, -1);
+    }
+}
+
+TEST(SoABufferTest, kernel_args)
+{
+    auto ctx = ocl::Context::get_default();
+    auto q = ocl::Queue::get_default();
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+
+    const int N = 10;
+    std::vector<Particle> h_p(N);
+    for (int i = 0; i < N; i++)
+        h_p[i] = { (cl_float) i, 1.f, i };
+
+    Particles d_p(ctx, N);
+    auto uploaded = d_p.upload(q, h_p);
+    auto move = ocl::Kernel::create<Particles, float>(prg, "move");
+    q.submit([&](auto & h) {
+        h.depends_on(uploaded);
+        h.kernel(move(d_p, 0.5f), ocl::Range<1> { N });
+    });
+    d_p.download(q, h_p);
+    for (int i = 0; i < N; i++) {
+        EXPECT_FLOAT_EQ(h_p[i].x, i + 0.5f);
+        EXPECT_EQ(h_p[i].id, i);
+    }
+}
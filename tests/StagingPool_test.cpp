@@ -0,0 +1,73 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/staging_pool.h"
+#include <numeric>
+#include <vector>
+
+namespace ocl = openclcpp_lite;
+
+TEST(StagingPoolTest, acquire)
+{
+    auto q = ocl::Queue::get_default();
+    ocl::StagingPool pool(q);
+    EXPECT_EQ(pool.capacity(), 0);
+
+    void * ptr;
+    {
+        auto stage = pool.acquire(1000);
+        EXPECT_EQ(stage.size(), 1000);
+        EXPECT_EQ(stage.span().size(), 1000);
+        EXPECT_EQ(stage.as<int>().size(), 250);
+        ptr = stage.data();
+        EXPECT_NE(ptr, nullptr);
+    }
+    auto cap = pool.capacity();
+    EXPECT_GE(cap, 1000);
+
+    {
+        // released memory is reused
+        auto a = pool.acquire(500);
+        EXPECT_EQ(a.data(), ptr);
+        // memory handed out is not
+        auto b = pool.acquire(500);
+        EXPECT_NE(b.data(), ptr);
+    }
+    EXPECT_EQ(pool.capacity(), 2 * cap);
+
+    pool.trim();
+    EXPECT_EQ(pool.capacity(), 0);
+}
+
+TEST(StagingPoolTest, copy)
+{
+    const int N = 1000;
+    ocl::Range<1> rng { N };
+    auto q = ocl::Queue::get_default();
+    q.set_staging_pool(std::make_shared<ocl::StagingPool>(q, 0));
+    EXPECT_NE(q.staging_pool(), nullptr);
+
+    std::vector<int> h_a(N);
+    std::iota(h_a.begin(), h_a.end(), 0);
+    ocl::Buffer<int> d_a { rng };
+    ocl::Buffer<int> d_b { rng };
+    auto evt = q.copy(h_a.data(), d_a, rng);
+    // written data is staged, the host memory can be reused right away
+    std::fill(h_a.begin(), h_a.end(), -1);
+    q.copy(d_a, d_b, rng, evt);
+
+    std::vector<int> res(N);
+    q.copy(d_b, res.data(), rng).wait();
+    for (int i = 0; i < N; i++)
+        EXPECT_EQ(res[i], i);
+
+    q.submit([&](ocl::Handler & h) { h.copy(d_a, res.data(), rng); });
+    EXPECT_EQ(res[N - 1], N - 1);
+
+    // waiting for the queue covers non-blocking reads
+    std::vector<int> res2(N);
+    q.copy(d_b, res2.data(), rng);
+    q.wait();
+    for (int i = 0; i < N; i++)
+        EXPECT_EQ(res2[i], i);
+}
@@ -0,0 +1,162 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/queue.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/tuning_database.h"
+#include <filesystem>
+
+namespace ocl = openclcpp_lite;
+namespace fs = std::filesystem;
+
+namespace {
+
+// clang-format off
+std::string src1 = R"(
+__kernel void
+fill(__global int *A)
+{
+    A[get_global_id(0)] = 1;
+}
+)";
+
+std::string src2 = R"(
+__kernel void
+fill(__global int *A)
+{
+    A[get_global_id(0)] = 2;
+}
+)";
+// clang-format on
+
+fs::path
+db_file(const std::string & name)
+{
+    auto dir = fs::temp_directory_path() / "openclcpp-lite-test";
+    fs::create_directories(dir);
+    auto path = dir / name;
+    fs::remove(path);
+    return path;
+}
+
+} // namespace
+
+TEST(TuningDatabaseTest, lookup)
+{
+    auto ctx = ocl::Context::get_default();
+    auto dev = ctx.devices()[0];
+    auto prg1 = ocl::Program::from_source(ctx, src1);
+    prg1.build();
+    auto prg2 = ocl::Program::from_source(ctx, src2);
+    prg2.build();
+    ocl::Kernel k1(prg1, "fill");
+    ocl::Kernel k2(prg2, "fill");
+
+    ocl::TuningDatabase db;
+    ocl::Range<1> local;
+    EXPECT_FALSE(db.lookup(k1, dev, ocl::Range<1> { 256 }, local));
+
+    db.store(k1, dev, ocl::Range<1> { 256 }, ocl::Range<1> { 16 });
+    EXPECT_EQ(db.size(), 1);
+    // same size bucket
+    EXPECT_TRUE(db.lookup(k1, dev, ocl::Range<1> { 384 }, local));
+    EXPECT_EQ(local.size(), 16);
+    // different size bucket
+    EXPECT_FALSE(db.lookup(k1, dev, ocl::Range<1> { 1024 }, local));
+    // same bucket, but the tuned size does not divide the global size
+    EXPECT_FALSE(db.lookup(k1, dev, ocl::Range<1> { 260 }, local));
+
+    // program source changed, entry is dropped
+    EXPECT_FALSE(db.lookup(k2, dev, ocl::Range<1> { 256 }, local));
+    EXPECT_EQ(db.size(), 0);
+}
+
+TEST(TuningDatabaseTest, lookup_binary)
+{
+    auto ctx = ocl::Context::get_default();
+    auto dev = ctx.devices()[0];
+    auto from_binary = [&](const std::string & src) {
+        auto prg = ocl::Program::from_source(ctx, src);
+        prg.build();
+        auto bin = ocl::Program::from_binary(ctx, { dev }, { prg.binaries()[0] });
+        bin.build();
+        return bin;
+    };
+    auto prg1 = from_binary(src1);
+    auto prg2 = from_binary(src2);
+    ocl::Kernel k1(prg1, "fill");
+    ocl::Kernel k2(prg2, "fill");
+
+    ocl::TuningDatabase db;
+    ocl::Range<1> local;
+    db.store(k1, dev, ocl::Range<1> { 256 }, ocl::Range<1> { 16 });
+    EXPECT_TRUE(db.lookup(k1, dev, ocl::Range<1> { 256 }, local));
+
+    // programs without source are told apart by their binaries
+    EXPECT_FALSE(db.lookup(k2, dev, ocl::Range<1> { 256 }, local));
+    EXPECT_EQ(db.size(), 0);
+}
+
+TEST(TuningDatabaseTest, save_load)
+{
+    auto ctx = ocl::Context::get_default();
+    auto dev = ctx.devices()[0];
+    auto prg = ocl::Program::from_source(ctx, src1);
+    prg.build();
+    ocl::Kernel k(prg, "fill");
+    auto path = db_file("tuning.db");
+    auto exported = db_file("exported.db");
+
+    {
+        ocl::TuningDatabase db(path.string());
+        EXPECT_EQ(db.file_name(), path.string());
+        EXPECT_EQ(db.size(), 0);
+        db.store(k, dev, ocl::Range<2> { 64, 64 }, ocl::Range<2> { 8, 4 });
+        db.save();
+        db.export_to(exported.string());
+    }
+
+    ocl::TuningDatabase db(path.string());
+    EXPECT_EQ(db.size(), 1);
+    ocl::Range<2> local;
+    EXPECT_TRUE(db.lookup(k, dev, ocl::Range<2> { 64, 64 }, local));
+    EXPECT_EQ(local.size(0), 8);
+    EXPECT_EQ(local.size(1), 4);
+
+    ocl::TuningDatabase imported;
+    imported.import_from(exported.string());
+    EXPECT_EQ(imported.size(), 1);
+
+    EXPECT_THROW(imported.save(), ocl::Exception);
+    EXPECT_THROW(imported.import_from(db_file("missing.db").string()), ocl::Exception);
+}
+
+TEST(TuningDatabaseTest, queue)
+{
+    const int N = 64;
+    auto ctx = ocl::Context::get_default();
+    auto dev = ctx.devices()[0];
+    auto prg = ocl::Program::from_source(ctx, src1);
+    prg.build();
+    ocl::Kernel k(prg, "fill");
+
+    auto db = std::make_shared<ocl::TuningDatabase>();
+    db->store(k, dev, ocl::Range<1> { N }, ocl::Range<1> { 8 });
+
+    ocl::Queue q(ctx, dev);
+    q.set_tuning_database(db);
+    EXPECT_EQ(q.tuning_database(), db);
+
+    ocl::Range<1> rng { N };
+    ocl::Buffer<int> d_a { rng };
+    std::vector<int> h_a(N);
+    k.set_arg(0, d_a);
+    q.submit([&](auto & h) {
+        h.kernel(k, rng);
+        h.copy(d_a, h_a.data(), rng);
+    });
+    for (auto & v : h_a)
+        EXPECT_EQ(v, 1);
+}
@@ -27,3 +27,20 @@ TEST(Utils, join)
     EXPECT_EQ(ocl::utils::join(", ", { "one" }), "one");
     EXPECT_EQ(ocl::utils::join(", ", { "one", "two" }), "one, two");
 }
+
+TEST(Utils, hash)
+{
+    EXPECT_EQ(ocl::utils::hash(""), 14695981039346656037ULL);
+    EXPECT_EQ(ocl::utils::hash("a"), 0xaf63dc4c8601ec8cULL);
+    EXPECT_NE(ocl::utils::hash("ab"), ocl::utils::hash("ba"));
+    EXPECT_EQ(ocl::utils::hash("b", ocl::utils::hash("a")), ocl::utils::hash("ab"));
+    EXPECT_EQ(ocl::utils::hash_bytes("ab", 2), ocl::utils::hash("ab"));
+    EXPECT_EQ(ocl::utils::hash_bytes("b", 1, ocl::utils::hash_bytes("a", 1)),
+              ocl::utils::hash("ab"));
+}
+
+TEST(Utils, to_hex)
+{
+    EXPECT_EQ(ocl::utils::to_hex(0), "0000000000000000");
+    EXPECT_EQ(ocl::utils::to_hex(0xaf63dc4c8601ec8cULL), "af63dc4c8601ec8c");
+}
@@ -0,0 +1,93 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/kernel_functor.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/work_distributor.h"
+#include <vector>
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+// clang-format off
+std::string src = R"(
+__kernel void
+square(__global const float * a, __global float * b)
+{
+    size_t i = get_global_id(0);
+    b[i] = a[i] * a[i];
+}
+)";
+// clang-format on
+
+} // namespace
+
+TEST(WorkDistributorTest, partition)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::WorkDistributor dist(ctx);
+    EXPECT_EQ(dist.num_of_devices(), ctx.num_of_devices());
+    EXPECT_EQ(dist.context(), ctx);
+
+    auto gran = dist.granularity(sizeof(float));
+    EXPECT_EQ(gran * sizeof(float) % ctx.alignment(), 0);
+
+    const std::size_t N = 10000;
+    auto parts = dist.partition<float>(N);
+    ASSERT_FALSE(parts.empty());
+    std::size_t next = 0;
+    for (auto & p : parts) {
+        EXPECT_EQ(p.offset, next);
+        EXPECT_EQ(p.offset % gran, 0);
+        EXPECT_GT(p.size, 0);
+        EXPECT_LT(p.device, dist.num_of_devices());
+        next += p.size;
+    }
+    EXPECT_EQ(next, N);
+
+    EXPECT_TRUE(dist.partition(0).empty());
+}
+
+TEST(WorkDistributorTest, scatter)
+{
+    auto ctx = ocl::Context::get_default();
+    ocl::WorkDistributor dist(ctx);
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+
+    const std::size_t N = 10000;
+    std::vector<float> h_a(N);
+    for (std::size_t i = 0; i < N; i++)
+        h_a[i] = i % 100;
+    ocl::Range<1> rng { N };
+    auto [d_a, upload] = ocl::Buffer<float>::from_host(dist.queue(0), h_a.data(), rng);
+    ocl::Buffer<float> d_b(ctx, rng);
+
+    auto parts = dist.partition<float>(N);
+    auto [a, a_migrated] = dist.scatter(d_a, parts, ocl::Flags<ocl::MigrationFlag>(), upload);
+    auto [b, b_migrated] = dist.scatter(d_b, parts, ocl::MIGRATE_CONTENT_UNDEFINED);
+    ASSERT_EQ(a.size(), parts.size());
+    ASSERT_EQ(b.size(), parts.size());
+    ASSERT_EQ(a_migrated.size(), parts.size());
+    ASSERT_EQ(b_migrated.size(), parts.size());
+
+    using FloatBuffer = ocl::Buffer<float>;
+    auto square = ocl::Kernel::create<FloatBuffer, FloatBuffer>(prg, "square");
+    for (std::size_t i = 0; i < parts.size(); i++) {
+        EXPECT_EQ(a[i].offset(), parts[i].offset * sizeof(float));
+        EXPECT_EQ(a[i].byte_size(), parts[i].size * sizeof(float));
+        dist.queue(parts[i].device).submit([&](auto & h) {
+            h.depends_on({ a_migrated[i], b_migrated[i] });
+            h.kernel(square(a[i], b[i]), ocl::Range<1> { parts[i].size });
+        });
+    }
+    dist.wait();
+
+    std::vector<float> h_b(N);
+    dist.queue(0).copy(d_b, h_b.data(), rng).wait();
+    for (std::size_t i = 0; i < N; i++)
+        EXPECT_FLOAT_EQ(h_b[i], h_a[i] * h_a[i]);
+}
@@ -0,0 +1,57 @@
+#include "gmock/gmock.h"
+#include "openclcpp-lite/context.h"
+#include "openclcpp-lite/device.h"
+#include "openclcpp-lite/program.h"
+#include "openclcpp-lite/kernel.h"
+#include "openclcpp-lite/buffer.h"
+#include "openclcpp-lite/work_group_tuner.h"
+
+namespace ocl = openclcpp_lite;
+
+namespace {
+
+// clang-format off
+std::string src = R"(
+__kernel void
+scale(__global float *A)
+{
+    int i = get_global_id(0) + get_global_id(1) * get_global_size(0);
+    A[i] = 2.f * A[i];
+}
+)";
+// clang-format on
+
+} // namespace
+
+TEST(WorkGroupTunerTest, tune)
+{
+    auto ctx = ocl::Context::get_default();
+    auto dev = ctx.devices()[0];
+    auto prg = ocl::Program::from_source(ctx, src);
+    prg.build();
+
+    ocl::Range<2> global { 64, 48 };
+    ocl::Buffer<float, 2> d_a { global };
+    ocl::Kernel k(prg, "scale");
+    k.set_arg(0, d_a);
+
+    ocl::WorkGroupTuner tuner(ctx, dev);
+    tuner.set_repetitions(1);
+    EXPECT_EQ(tuner.repetitions(), 1);
+
+    auto local = tuner.tune(k, global);
+    EXPECT_EQ(local.dimensions(), 2);
+    EXPECT_EQ(global.size(0) % local.size(0), 0);
+    EXPECT_EQ(global.size(1) % local.size(1), 0);
+    EXPECT_LE(local.size(), k.work_group_size(dev));
+    EXPECT_EQ(tuner.size(), 1);
+
+    // the winner is remembered
+    auto rng = tuner.range(k, global);
+    EXPECT_EQ(tuner.size(), 1);
+    EXPECT_EQ(rng.local().size(0), local.size(0));
+    EXPECT_EQ(rng.local().size(1), local.size(1));
+
+    tuner.clear();
+    EXPECT_EQ(tuner.size(), 0);
+}